@@ -20,6 +20,7 @@ details (or else see http://mozilla.org/MPL/2.0/).
 #include "Mona/Binary.h"
 #include <thread>
 #include <atomic>
+#include <vector>
 
 namespace Mona {
 
@@ -52,21 +53,68 @@ struct Buffer : Binary, virtual Object {
 
 
 	struct Allocator : virtual Object {
+		/*!
+		Statistics of one size class of a pooling allocator */
+		struct Stats {
+			Stats(UInt32 capacity) : capacity(capacity), hits(0), misses(0), frees(0), collected(0) {}
+			UInt32 capacity;
+			UInt64 hits; // allocations served by the pool
+			UInt64 misses; // allocations which have required a new buffer
+			UInt64 frees; // buffers released to the pool
+			UInt64 collected; // buffers freed by the garbage collector of the pool
+			UInt64 cached() const { return frees > (hits + collected) ? (frees - hits - collected) * capacity : 0; } // bytes
+			UInt64 inUse() const { return (hits + misses) > frees ? (hits + misses - frees) * capacity : 0; } // bytes
+		};
+		/*!
+		Allocation tag to know which call site allocates buffers, declare it static and scope allocations with a Tag::Scope,
+		counts are cumulative (allocations and bytes allocated) */
+		struct Tag : virtual Object {
+			Tag(const char* name);
+			const char* const	name;
+			UInt64				count() const { return _count; }
+			UInt64				bytes() const { return _bytes; }
+			/*!
+			Tags iteration => for (const Tag* pTag = Tag::First(); pTag; pTag = pTag->next()) */
+			const Tag*			next() const { return _pNext; }
+			static const Tag*	First() { return _PFirst; }
+
+			struct Scope : virtual Object {
+				Scope(Tag& tag) : _pPrevious(Current()) { Current() = &tag; }
+				~Scope() { Current() = _pPrevious; }
+			private:
+				Tag* _pPrevious;
+			};
+		private:
+			static Tag*& Current();
+
+			std::atomic<UInt64>	_count;
+			std::atomic<UInt64>	_bytes;
+			Tag*				_pNext;
+			static Tag*			_PFirst;
+			friend struct Allocator;
+		};
+
 		template<typename AllocatorType=Allocator, typename ...Args>
 		static void   Set(Args&&... args) { Lock(); _PAllocator.set<AllocatorType>(std::forward<Args>(args)...); Unlock(); }
 		static UInt8* Alloc(UInt32& size);
 		static void	  Free(UInt8* buffer, UInt32 size);
 		static UInt32 ComputeCapacity(UInt32 size);
+		/*!
+		Statistics by size class of the current allocator, nothing if it doesn't pool buffers */
+		static void	  Statistics(std::vector<Stats>& stats);
 	protected:
 		virtual UInt8* alloc(UInt32& capacity) { return new UInt8[capacity]; }
 		virtual void   free(UInt8* buffer, UInt32 capacity) { delete[] buffer; }
+		virtual void   statistics(std::vector<Stats>& stats) {}
 
-		static void Lock() { while (!TryLock()) std::this_thread::yield(); }
-		static void Unlock() { _Mutex.clear(std::memory_order_release); }
+		/*!
+		Exclusive access to the allocator, waits the end of Alloc/Free calls in progress
+		(Alloc/Free don't lock, meanwhile they use new/delete directly) */
+		static void Lock();
+		static void Unlock() { _Locked = false; _Mutex.clear(std::memory_order_release); }
 	private:
-		static bool TryLock() { return !_Mutex.test_and_set(std::memory_order_acquire); }
-
 		static std::atomic_flag  _Mutex;
+		static std::atomic<bool> _Locked;
 		static unique<Allocator> _PAllocator;
 	};
 private:
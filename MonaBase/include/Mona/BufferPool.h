@@ -22,32 +22,72 @@ details (or else see http://mozilla.org/MPL/2.0/).
 
 namespace Mona {
 
+/*!
+Buffer allocator which recycles buffers by size class (power of two capacities),
+every thread caches for each size class a magazine of buffers to alloc/free without lock,
+magazines are refilled from and spilled to the global depots by batch.
+A garbage collector frees every 10 seconds buffers unused of depots and recovers magazines of ended threads.
+Statistics by size class are available with Buffer::Allocator::Statistics */
 struct BufferPool : Buffer::Allocator, private Thread, virtual Object {
 
-	BufferPool() : Thread("BufferPool") { start(Thread::PRIORITY_LOWEST); }
-	~BufferPool() { stop(); }
+	BufferPool();
+	~BufferPool();
 
 private:
-	UInt8* alloc(UInt32& capacity) {
-		UInt8* buffer = _buffers[computeIndex(capacity)].pop();
-		return buffer ? buffer : new UInt8[capacity];
-	}
-	void   free(UInt8* buffer, UInt32 capacity) { _buffers[computeIndex(capacity)].push(buffer); }
+	enum {
+		CLASSES = 28,
+		MAGAZINE = 64, // buffers max by magazine
+		MAGAZINE_BYTES = 0x20000 // bytes max by magazine (128KB), bigger buffers go directly in depots
+	};
+
+	UInt8* alloc(UInt32& capacity);
+	void   free(UInt8* buffer, UInt32 capacity);
+	void   statistics(std::vector<Stats>& stats);
 
 	bool run(Exception& ex, const volatile bool& requestStop);
 	UInt8 computeIndex(UInt32 capacity);
+	static UInt8 MagazineSize(UInt32 capacity) { return UInt8(std::min<UInt32>(MAGAZINE, MAGAZINE_BYTES / capacity)); }
 
 	struct Buffers : private std::vector<UInt8*>, virtual Object {
 		Buffers() : _minSize(0), _maxSize(0) {}
 		~Buffers() { for (UInt8* buffer : self) delete[] buffer; }
 		UInt8* pop();
 		void   push(UInt8* buffer);
+		UInt8  pop(UInt8** buffers, UInt8 count);
+		void   push(UInt8** buffers, UInt8 count);
 		void manage(std::vector<UInt8*>& gc);
+
+		std::mutex	mutex;
 	private:
 		UInt32 _minSize;
 		UInt32 _maxSize;
 	};
-	Buffers			 _buffers[28];
+	struct Counters : virtual Object {
+		Counters() : hits(0), misses(0), frees(0), collected(0) {}
+		std::atomic<UInt64>	hits;
+		std::atomic<UInt64>	misses;
+		std::atomic<UInt64>	frees;
+		std::atomic<UInt64>	collected;
+		/*!
+		Counters have one unique writer, no need of an atomic increment */
+		static void Increment(std::atomic<UInt64>& counter, UInt64 count = 1) { counter.store(counter.load(std::memory_order_relaxed) + count, std::memory_order_relaxed); }
+	};
+	struct Magazines : virtual Object {
+		Magazines() : trim(false), orphan(false) { memset(sizes, 0, sizeof(sizes)); }
+		std::atomic<bool>	trim; // requested by the garbage collector, the thread has to spill its buffers
+		std::atomic<bool>	orphan; // thread ended
+		UInt8				sizes[CLASSES];
+		UInt8*				buffers[CLASSES][MAGAZINE];
+		Counters			counters[CLASSES];
+	};
+	Magazines&	magazines();
+	void		spill(Magazines& magazines);
+
+	Buffers							_buffers[CLASSES];
+	const UInt32					_id;
+	std::mutex						_mutex;
+	std::vector<shared<Magazines>>	_magazines;
+	Counters						_counters[CLASSES]; // counters of ended threads + collected buffers
 };
 
 
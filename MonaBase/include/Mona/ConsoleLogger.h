@@ -28,8 +28,12 @@ struct ConsoleLogger : Logger, virtual Object {
 
 	bool log(LOG_LEVEL level, const Path& file, long line, const std::string& message);
 	bool dump(const std::string& header, const UInt8* data, UInt32 size);
+	bool flush();
 private:
 	bool _isInteractive;
+#if !defined(_WIN32)
+	std::string _buffer; // logs of the batch, written on flush
+#endif
 };
 
 } // namespace Mona
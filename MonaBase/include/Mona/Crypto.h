@@ -57,6 +57,11 @@ struct Crypto : virtual Static {
 
 	static UInt32 ComputeCRC32(const UInt8* data, UInt32 size, ROTATE_OPTIONS options =0);
 
+	/*!
+	XOR data with a 4 bytes key repeated (WebSocket masking), output can be data itself */
+	static UInt8* Mask(const UInt8* key, const UInt8* data, UInt32 size, UInt8* output);
+	static UInt8* Mask(const UInt8* key, UInt8* data, UInt32 size) { return Mask(key, data, size, data); }
+
 
 	struct Hash : virtual Static {
 		static UInt8* MD5(UInt8* value, size_t size) { return Compute(EVP_md5(), value, size, value); }
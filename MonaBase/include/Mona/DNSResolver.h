@@ -0,0 +1,90 @@
+/*
+This file is a part of MonaSolutions Copyright 2017
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or
+modify it under the terms of the the Mozilla Public License v2.0.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+Mozilla Public License v. 2.0 received along this program for more
+details (or else see http://mozilla.org/MPL/2.0/).
+
+*/
+
+#pragma once
+
+#include "Mona/Mona.h"
+#include "Mona/UDPSocket.h"
+#include "Mona/HostEntry.h"
+#include "Mona/Timer.h"
+#include <map>
+
+namespace Mona {
+
+/*!
+Asynchronous DNS resolver, sends A and AAAA queries over UDP and keeps answers in a cache according to their TTL,
+failures "host not found" are cached too (negative cache, RFC 2308).
+resolve has to be called on the thread which flushes the handler of io and raises timer (main server thread),
+and result is given on this same thread */
+struct DNSResolver : virtual Object {
+	typedef std::function<void(const Exception& ex, const HostEntry& host)> OnResolved;
+
+	DNSResolver(IOSocket& io, const Timer& timer);
+	~DNSResolver();
+
+	IOSocket&		io;
+	const Timer&	timer;
+
+	/*!
+	Name servers queried, loaded from system configuration (/etc/resolv.conf) */
+	std::vector<SocketAddress>	servers;
+	/*!
+	Timeout in ms of one attempt, each new attempt goes to the next server */
+	UInt32						timeout;
+	UInt8						attempts;
+	/*!
+	Maximum TTL in seconds of a cache entry, and TTL of a negative entry when answer has no SOA record */
+	UInt32						maxTTL;
+	UInt32						negativeTTL;
+
+	/*!
+	Resolve hostname, onResolved is called immediatly if hostname is an IP or is in cache,
+	otherwise queries are sent and onResolved is called on answer (the concurrent resolutions of a same name share the same queries) */
+	void	resolve(const std::string& hostname, const OnResolved& onResolved);
+
+	UInt32	cached() const { return _cache.size(); }
+	UInt32	resolving() const { return _queries.size(); }
+	/*!
+	Empty cache and cancel resolutions in progress (their onResolved are not called), can't be called from a onResolved callback */
+	void	clear();
+
+	/*!
+	Load name servers of system configuration, returns false if no one is found */
+	static bool LoadServers(std::vector<SocketAddress>& servers);
+
+private:
+	struct Entry : virtual Object {
+		Entry() : expiration(0) {}
+		Int64					expiration;
+		shared<const HostEntry>	pHost;
+		Exception				ex;
+	};
+	struct Query;
+
+	void	send(Query& query);
+	void	receive(const UInt8* data, UInt32 size, const SocketAddress& address);
+	void	finish(Query& query);
+
+	UDPSocket								_socket;
+	Timer::OnTimer							_onTimeout;
+	std::map<std::string, Entry>			_cache;
+	UInt32									_sweeping; // cache size which triggers the next expired entries removing
+	std::map<std::string, unique<Query>>	_queries;
+	std::map<UInt16, Query*>				_ids;
+};
+
+
+} // namespace Mona
@@ -207,7 +207,21 @@ struct Date : Time, virtual Object {
 		return out;
 	}
 
+	/*!
+	Format time like format method but with a per-thread cache by format and offset,
+	calendar and timezone are computed one time by second then just milliseconds are patched (logs, HTTP Date header) */
+	template<typename OutType>
+	static OutType& Format(const char* format, Int64 time, OutType& out, Int32 offset = Timezone::LOCAL) {
+		UInt32 size;
+		const char* value(Cached(format, time, offset, size));
+		if (!value) // not cacheable (too long or with elapsed time)
+			return Date(time, offset).format(format, out);
+		return (OutType&)out.append(value, size);
+	}
+
 private:
+	static const char* Cached(const char* format, Int64 time, Int32 offset, UInt32& size);
+
 	void  init() const { _day = 1; ((Date*)this)->update(Time::time(), _offset); }
 	void  computeWeekDay(Int64 days);
 	bool  parseAuto(Exception& ex, const char* data, std::size_t count);
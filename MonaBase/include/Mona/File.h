@@ -19,6 +19,7 @@ details (or else see http://mozilla.org/MPL/2.0/).
 #include "Mona/Mona.h"
 #include "Mona/Path.h"
 #include "Mona/Handler.h"
+#include "Mona/ThreadPool.h"
 #if !defined(_WIN32)
 #include <fcntl.h>
 #endif
@@ -90,6 +91,9 @@ struct File : virtual Object {
 	If writing error => Ex::System::File || Ex::Permission */
 	bool				write(Exception& ex, const void* data, UInt32 size);
 	/*!
+	Commit written data to disk (fsync), if error => Ex::System::File */
+	bool				sync(Exception& ex);
+	/*!
 	If deletion error => Ex::System::File || Ex::Permission
 	/!\ One time deleted no more write operation is possible */
 	bool				erase(Exception& ex);
@@ -100,6 +104,10 @@ struct File : virtual Object {
 	void				reset(UInt64 position = 0);
 
 private:
+	// read/write checks (folder, loading, mode), then IOFile can submit the operation to io_uring
+	bool				readable(Exception& ex);
+	bool				writable(Exception& ex);
+
 	Path				_path;
 	volatile bool		_loaded;
 	std::atomic<UInt64>	_readen;
@@ -120,10 +128,12 @@ private:
 
 	std::atomic<UInt64>			_queueing;
 	std::atomic<UInt32>			_flushing;
-	UInt16						_ioTrack;
-	UInt16						_decodingTrack;
+	ThreadPool::Track			_ioTrack;
+	ThreadPool::Track			_decodingTrack;
 	const Handler*				_pHandler; // to diminue size of Action+Handle
 	friend struct IOFile;
+	friend struct Socket; // for Socket::writeFile
+
 };
 
 
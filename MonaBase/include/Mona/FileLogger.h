@@ -33,10 +33,12 @@ struct FileLogger : Logger, virtual Object {
 
 	bool log(LOG_LEVEL level, const Path& file, long line, const std::string& message);
 	bool dump(const std::string& header, const UInt8* data, UInt32 size);
+	bool flush();
 private:
 	void manage(UInt32 written);
 
 	unique<File>	_pFile;
+	std::string		_buffer; // logs of the batch, written on flush
 	UInt32			_written;
 	UInt16			_rotation;
 	UInt32			_sizeByFile;
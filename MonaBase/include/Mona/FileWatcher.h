@@ -20,6 +20,7 @@ details (or else see http://mozilla.org/MPL/2.0/).
 #include "Mona/Path.h"
 #include "Mona/Event.h"
 #include "Mona/FileSystem.h"
+#include <set>
 
 
 namespace Mona {
@@ -48,6 +49,7 @@ struct FileWatcher : virtual Object {
 
 private:
 	void	watchFile(std::map<Path, std::pair<Time, bool>, String::IComparator>& lastChanges, const Path& file, const OnUpdate& onUpdate);
+	bool	match(const Path& file) const;
 
 	std::map<Path, std::pair<Time, bool>, String::IComparator> _lastChanges;
 	bool													   _firstWatch;
@@ -55,9 +57,16 @@ private:
 	const char* _ext;
 	const char* _baseName;
 	bool		_justFolder;
+	bool		_listing; // files are listed from parent folder
 
 	//// Used by IOFile /////////////////////
-	OnUpdate    onUpdate;
+	/*!
+	Change notification of file (or of its folder), returns true if a new watch is required.
+	Invalidates the last change known because Path::lastChange precision is the second */
+	bool					touch(const Path& file);
+	OnUpdate				onUpdate;
+	UInt32					pending; // changes waiting stability after the last watch
+	std::set<std::string>	folders; // folders to observe to be notified of changes, updated on watch
 	friend struct IOFile;
 };
 
@@ -20,19 +20,19 @@ details (or else see http://mozilla.org/MPL/2.0/).
 #include "Mona/Runner.h"
 #include "Mona/Event.h"
 #include "Mona/Signal.h"
-#include <deque>
+#include "Mona/MPSCQueue.h"
 
 namespace Mona {
 
 struct Handler : virtual Object {
-	Handler(Signal& signal) : _signal(signal) {}
+	Handler(Signal& signal) : _signal(signal), _signaled(false) {}
 
 	template<typename RunnerType, typename = typename std::enable_if<std::is_constructible<shared<Runner>, RunnerType>::value>::type>
 	void queue(RunnerType&& pRunner) const {
 		FATAL_CHECK(pRunner); // more easy to debug that if it fails in the thread!
-		std::lock_guard<std::mutex> lock(_mutex);
-		_runners.emplace_back(std::forward<RunnerType>(pRunner));
-		_signal.set();
+		_runners.push(std::forward<RunnerType>(pRunner));
+		if (!_signaled.exchange(true)) // signal just once by flush (Signal::set is locking)
+			_signal.set();
 	}
 	template <typename RunnerType, typename ...Args>
 	void queue(Args&&... args) const { queue(std::make_shared<RunnerType>(std::forward<Args>(args)...)); }
@@ -51,12 +51,14 @@ struct Handler : virtual Object {
 	void queue(const Event<void()>& onResult) const;
 
 
+	/*!
+	Run runners queued, to call always by the same thread */
 	UInt32 flush();
 
 private:
 
-	mutable std::mutex					_mutex;
-	mutable std::deque<shared<Runner>>	_runners;
+	mutable MPSCQueue<shared<Runner>>	_runners;
+	mutable std::atomic<bool>			_signaled;
 	Signal&								_signal;
 };
 
@@ -0,0 +1,152 @@
+/*
+This file is a part of MonaSolutions Copyright 2017
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or
+modify it under the terms of the the Mozilla Public License v2.0.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+Mozilla Public License v. 2.0 received along this program for more
+details (or else see http://mozilla.org/MPL/2.0/).
+
+*/
+
+#pragma once
+
+#include "Mona/Mona.h"
+#include <vector>
+
+namespace Mona {
+
+/*!
+Hash map with open addressing (linear probing and backward shift deletion), entries are stored in one array
+(power of 2 size, at least half empty) so find, emplace and erase are O(1) without allocation (once array is grown).
+KeyType has to be default constructible, copyable and has to implement a "UInt32 hash() const" method */
+template<typename KeyType, typename Type>
+struct HashMap : virtual Object {
+	HashMap() : _size(0) {}
+
+	UInt32	size() const { return _size; }
+	bool	empty() const { return !_size; }
+
+	Type* find(const KeyType& key) {
+		UInt32 i = position(key);
+		return i == END ? NULL : &_slots[i].value;
+	}
+	const Type* find(const KeyType& key) const { return ((HashMap&)self).find(key); }
+
+	/*!
+	Insert value if key doesn't exist, returns the value of key and true if inserted */
+	template<typename ...Args>
+	std::pair<Type*, bool> emplace(const KeyType& key, Args&&... args) {
+		UInt32 i = position(key);
+		if (i != END)
+			return std::pair<Type*, bool>(&_slots[i].value, false);
+		if (++_size * 2 > _slots.size())
+			grow();
+		UInt32 hash(Hash(key));
+		Slot& slot(_slots[index(hash)]);
+		slot.hash = hash;
+		slot.key = key;
+		slot.value = Type(std::forward<Args>(args)...);
+		return std::pair<Type*, bool>(&slot.value, true);
+	}
+
+	bool erase(const KeyType& key) {
+		UInt32 i = position(key);
+		if (i == END)
+			return false;
+		erase(i);
+		return true;
+	}
+	/*!
+	Erase entries for which function(key, value) returns true, returns count of entries erased */
+	template<typename Function>
+	UInt32 eraseIf(const Function& function) {
+		UInt32 count(0);
+		for (UInt32 i = 0; i < _slots.size();) {
+			// after erase a following entry can take its place
+			if (_slots[i].hash && function(_slots[i].key, _slots[i].value)) {
+				erase(i);
+				++count;
+			} else
+				++i;
+		}
+		return count;
+	}
+
+	void clear() {
+		_slots.clear();
+		_size = 0;
+	}
+
+private:
+	enum : UInt32 {
+		END = 0xFFFFFFFF
+	};
+	struct Slot {
+		Slot() : hash(0), value() {}
+		UInt32	hash; // 0 => empty
+		KeyType	key;
+		Type	value;
+	};
+
+	static UInt32 Hash(const KeyType& key) {
+		UInt32 hash(key.hash());
+		return hash ? hash : 1;
+	}
+
+	UInt32 position(const KeyType& key) const {
+		if (!_size)
+			return END;
+		UInt32 hash(Hash(key));
+		UInt32 mask(_slots.size() - 1);
+		for (UInt32 i = hash & mask; _slots[i].hash; i = (i + 1) & mask) {
+			if (_slots[i].hash == hash && _slots[i].key == key)
+				return i;
+		}
+		return END;
+	}
+
+	UInt32 index(UInt32 hash) const {
+		UInt32 mask(_slots.size() - 1);
+		UInt32 i(hash & mask);
+		while (_slots[i].hash)
+			i = (i + 1) & mask;
+		return i;
+	}
+
+	void grow() {
+		std::vector<Slot> slots(_slots.empty() ? 16 : (_slots.size() * 2));
+		_slots.swap(slots);
+		for (Slot& slot : slots) {
+			if (slot.hash)
+				_slots[index(slot.hash)] = std::move(slot);
+		}
+	}
+
+	void erase(UInt32 i) {
+		// backward shift of the following entries which are not at their ideal position (no tombstone)
+		UInt32 mask(_slots.size() - 1);
+		for (UInt32 j = (i + 1) & mask; _slots[j].hash; j = (j + 1) & mask) {
+			UInt32 ideal(_slots[j].hash & mask);
+			if (i <= j ? (ideal <= i || ideal > j) : (ideal <= i && ideal > j)) {
+				_slots[i] = std::move(_slots[j]);
+				i = j;
+			}
+		}
+		_slots[i].hash = 0;
+		_slots[i].key = KeyType();
+		_slots[i].value = Type();
+		--_size;
+	}
+
+	std::vector<Slot>	_slots;
+	UInt32				_size;
+};
+
+
+} // namespace Mona
@@ -53,6 +53,8 @@ public:
 	const std::set<IPAddress>&	addresses() const { return _addresses;}
 
 private:
+	friend struct DNSResolver;
+
 	std::string					_name;
 	std::vector<std::string>	_aliases;
 	std::set<IPAddress>			_addresses;
@@ -21,6 +21,7 @@ details (or else see http://mozilla.org/MPL/2.0/).
 #include "Mona/ThreadPool.h"
 #include "Mona/Packet.h"
 #include "Mona/FileWatcher.h"
+#include "Mona/IOUring.h"
 
 
 namespace Mona {
@@ -29,7 +30,8 @@ namespace Mona {
 IOFile performs asynchrone writing and reading operation,
 It uses a Thread::ProcessorCount() threads with low priority to load/read/write files
 Indeed even if SSD drive allows parallel reading and writing operation every operation sollicate too the CPU,
-so it's useless to try to exceeds number of CPU core (Thread::ProcessorCount() has been tested and approved with file load) */
+so it's useless to try to exceeds number of CPU core (Thread::ProcessorCount() has been tested and approved with file load).
+With io_uring (see Net::SetIOUring) readings and writings are submitted to the kernel and completed by one ring thread */
 struct IOFile : virtual Object, Thread { // Thread is for file watching!
 
 	IOFile(const Handler& handler, const ThreadPool& threadPool, UInt16 cores=0);
@@ -82,7 +84,9 @@ struct IOFile : virtual Object, Thread { // Thread is for file watching!
 	Async file/folder creation */
 	void create(const shared<File>& pFile) { write(pFile, Packet::Null()); }
 	/*!
-	Async file watcher, watch until pFileWatcher becomes unique */
+	Async file watcher, watch until pFileWatcher becomes unique.
+	On Linux changes are notified by inotify (update signaled after 200ms of stability),
+	otherwise or if folders can't be observed files are polled every second */
 	void watch(const shared<const FileWatcher>& pFileWatcher, const FileWatcher::OnUpdate& onUpdate);
 
 	void join();
@@ -92,11 +96,21 @@ private:
 	struct Action;
 	struct WAction;
 	struct SAction;
+	struct Watching;
+	struct Notifier;
+	struct Operation;
+	struct Ring;
 
 
 	ThreadPool								_threadPool; // Pool of threads for writing/reading disk operation
 	std::vector<shared<const FileWatcher>>	_watchers;
 	std::mutex								_mutexWatchers;
+#if defined(MONA_IO_URING)
+	unique<Ring>							_pRing; // io_uring readings and writings, if Net::GetIOUring() on construction
+#endif
+#if defined(__linux__)
+	int										_eventFd; // to wake up file watching thread waiting notifications
+#endif
 };
 
 
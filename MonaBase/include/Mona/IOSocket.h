@@ -21,18 +21,26 @@ details (or else see http://mozilla.org/MPL/2.0/).
 #include "Mona/Thread.h"
 #include "Mona/ThreadPool.h"
 #include "Mona/Socket.h"
+#include "Mona/IOUring.h"
+#include "Mona/Timer.h"
+#include <vector>
 
 namespace Mona {
 
 struct IOSRTSocket;
 struct IOSocket : protected Thread, virtual Object {
-	IOSocket(const Handler& handler, const ThreadPool& threadPool, const char* name = "IOSocket");
+	IOSocket(const Handler& handler, const ThreadPool& threadPool, const char* name = "IOSocket") : IOSocket(handler, threadPool, 1, name) {}
+	/*!
+	Build an IOSocket with multiple reactor threads, each one with its own system event queue,
+	sockets are shared between them on subscription (less loaded reactor) */
+	IOSocket(const Handler& handler, const ThreadPool& threadPool, UInt16 reactors, const char* name = "IOSocket");
 	~IOSocket();
 
 	const Handler&			handler;
 	const ThreadPool&		threadPool;
 
-	UInt32					subscribers() const { return _subscribers; }
+	UInt16					reactors() const { return UInt16(_reactors.size() + 1); }
+	UInt32					subscribers() const;
 
 	bool					subscribe(Exception& ex, const shared<Socket>& pSocket,
 								const Socket::OnReceived& onReceived,
@@ -55,6 +63,10 @@ struct IOSocket : protected Thread, virtual Object {
 	Unsubscribe pSocket and reset shared<Socket> to avoid to resubscribe the same socket which could crash decoder assignation */
 	void					unsubscribe(shared<Socket>& pSocket);
 
+	/*!
+	Flush the socket in delay ms as on a writable event (onFlush once queue empty), used by Socket pacing to release its sendings */
+	void					pace(const weak<Socket>& weakSocket, UInt32 delay);
+
 	virtual void			stop();
 
 protected:
@@ -96,6 +108,28 @@ private:
 			const Socket::OnError& onError);
 	
 	virtual bool run(Exception& ex, const volatile bool& requestStop);
+#if !defined(_WIN32) && !defined(_BSD)
+	void		 dispatch(const shared<Socket>& pSocket, UInt32 events);
+#endif
+#if defined(MONA_IO_URING)
+	struct Ring;
+	bool		 run(Exception& ex, int readFD);
+	void		 complete(Ring& ring, UInt8 operation, const IOUring::Completion& completion);
+	/*!
+	io_uring completion-based receptions and sendings of sockets not secure and not listening (others use poll as readiness) */
+	bool		 completes(const Socket& socket) const { return _ring && !socket.isSecure() && !socket.listening(); }
+	bool		 receive(Ring& ring, Socket& socket); // _mutex locked
+	void		 received(Ring& ring, const shared<Socket>& pSocket, const UInt8* data, UInt32 size, const sockaddr* pAddress = NULL);
+	/*!
+	Called by the Receive action once data delivered: rearm reception stopped by the reception budget, or signal end of stream */
+	void		 resume(const shared<Socket>& pSocket);
+	/*!
+	Send the queue with io_uring, returns false if there is nothing to send or if the socket doesn't complete with io_uring */
+	bool		 send(const shared<Socket>& pSocket);
+	void		 sent(Ring& ring, const shared<Socket>& pSocket, Int32 result);
+	void		 cancel(Ring& ring); // _mutex locked
+	void		 release(Ring& ring); // _mutex locked
+#endif
 
 #if defined(_WIN32)
 	std::map<NET_SOCKET, weak<Socket>>	_sockets;
@@ -103,9 +137,28 @@ private:
 #else
 	int											_eventFD;
 #endif
+#if defined(MONA_IO_URING)
+	IOUring										_ring; // initialized on start if Net::GetIOUring()
+	UInt32										_operations; // io_uring operations not completed, protected by _mutex
+	bool										_ringed; // Socket::_pWeakThis are Ring (io_uring subscriptions), protected by _mutex
+#endif
 
 	NET_SYSTEM									_system;
 	shared<IOSRTSocket>							_pIOSRTSocket;
+	std::vector<unique<IOSocket>>				_reactors; // additional reactor threads
+
+	/*!
+	Thread started on first pace request, flushes are scheduled on a timing wheel */
+	struct Pacer : Thread, virtual Object {
+		Pacer() : Thread("Pacer") {}
+		~Pacer() { stop(); }
+		void pace(const weak<Socket>& weakSocket, UInt32 delay);
+	private:
+		bool run(Exception& ex, const volatile bool& requestStop);
+
+		std::mutex									_mutex;
+		std::vector<std::pair<weak<Socket>, Int64>>	_requests; // socket and time to flush
+	}											_pacer;
 
 	struct Action;
 };
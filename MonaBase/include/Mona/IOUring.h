@@ -0,0 +1,192 @@
+/*
+This file is a part of MonaSolutions Copyright 2017
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or
+modify it under the terms of the the Mozilla Public License v2.0.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+Mozilla Public License v. 2.0 received along this program for more
+details (or else see http://mozilla.org/MPL/2.0/).
+
+*/
+
+#pragma once
+
+#include "Mona/Mona.h"
+#include "Mona/Exceptions.h"
+
+// io_uring is built on linux excepting if DISABLE_IO_URING is defined (no liburing dependency, just kernel headers)
+#if defined(__linux__) && !defined(__ANDROID__) && !defined(DISABLE_IO_URING) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#if defined(IORING_RECV_MULTISHOT) // provided buffers and multishot receptions (kernel headers >= 6.0)
+#define MONA_IO_URING
+#include <sys/socket.h>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
+#endif
+#endif
+#endif
+
+namespace Mona {
+
+/*!
+Minimal io_uring wrapper (kernel interface directly) to submit asynchronous operations and get their completions,
+submissions are thread-safe, completions have to be read by one unique thread (the one which waits them).
+Submissions of the waiting thread are batched and entered on its next wait, other threads enter immediatly.
+Receptions are multishot with buffers provided to the kernel (one completion by data received, without readiness step) */
+struct IOUring : virtual Object {
+	NULLABLE
+
+	IOUring();
+	~IOUring();
+
+	/*!
+	Returns true if io_uring is built and usable on this system with multishot reception in provided buffers (kernel >= 6.0, probed once) */
+	static bool Supported();
+
+	bool init(Exception& ex, UInt32 entries = 1024);
+	void close();
+	explicit operator bool() const { return _fd >= 0; }
+	int		 fd() const { return _fd; }
+
+#if defined(MONA_IO_URING)
+	struct Completion {
+		UInt64	userData;
+		Int32	result;
+		UInt32	flags;
+		/*!
+		false when it's the last completion of a multishot operation */
+		bool	more() const { return (flags & IORING_CQE_F_MORE) ? true : false; }
+		/*!
+		true if a provided buffer has been consumed, id gets its id (see buffer and recycle) */
+		bool	buffer(UInt16& id) const { id = UInt16(flags >> IORING_CQE_BUFFER_SHIFT); return (flags & IORING_CQE_F_BUFFER) ? true : false; }
+	};
+
+	/*!
+	Provide count buffers of size bytes to the kernel for receptions of group (IORING_OP_PROVIDE_BUFFERS),
+	memory is reserved but just committed when the kernel fills it */
+	bool	provide(Exception& ex, UInt16 group, UInt16 count, UInt32 size);
+	UInt8*	buffer(UInt16 group, UInt16 id) { return _groups[group].data + UInt32(id) * _groups[group].size; }
+	/*!
+	Give back to the kernel a buffer consumed, call it from the waiting thread: buffers consumed in order are given back together on its next wait */
+	bool	recycle(Exception& ex, UInt16 group, UInt16 id);
+
+	/*!
+	Submit a multishot poll on fd (edge triggered), every events change gives a completion with result = poll events */
+	bool poll(Exception& ex, int fd, UInt32 events, UInt64 userData, bool multishot = true);
+	/*!
+	Cancel a poll submitted with userData, poll gets then a last completion with result = -ECANCELED */
+	bool cancelPoll(Exception& ex, UInt64 userData) { return cancel(ex, userData); }
+	/*!
+	Submit a multishot reception on fd, every data received fills a buffer of group and gives a completion with result = size,
+	with pMsg (datagram) the buffer starts with io_uring_recvmsg_out, then name (pMsg->msg_namelen reserved) and payload, see Message */
+	bool receive(Exception& ex, int fd, UInt16 group, UInt64 userData, msghdr* pMsg = NULL);
+	/*!
+	Submit count sendings linked: executed in order, completed in order (result = size sent),
+	and the ones after a failure are canceled (result = -ECANCELED). msgs have to stay valid until their completion */
+	bool send(Exception& ex, int fd, const msghdr* msgs, UInt32 count, int flags, UInt64 userData);
+	/*!
+	Submit a file reading or writing at offset (-1 for current position), data has to stay valid until the completion (result = size) */
+	bool read(Exception& ex, int fd, void* data, UInt32 size, UInt64 offset, UInt64 userData);
+	bool write(Exception& ex, int fd, const void* data, UInt32 size, UInt64 offset, UInt64 userData);
+	/*!
+	Submit a no operation, just to get a completion */
+	bool nop(Exception& ex, UInt64 userData);
+	/*!
+	Cancel every operation submitted with userData, they get then a last completion with result = -ECANCELED */
+	bool cancel(Exception& ex, UInt64 userData);
+
+	/*!
+	Datagram layout in a buffer of a multishot reception with msghdr */
+	struct Message {
+		Message(const msghdr& msg, UInt8* buffer, UInt32 size);
+		const sockaddr*	name() const { return _pOut->namelen ? (const sockaddr*)(_pOut + 1) : NULL; }
+		const UInt8*	data() const { return _data; }
+		UInt32			size() const { return _size; }
+		bool			truncated() const { return (_pOut->flags & MSG_TRUNC) ? true : false; }
+	private:
+		const io_uring_recvmsg_out*	_pOut;
+		const UInt8*				_data;
+		UInt32						_size;
+	};
+
+	/*!
+	Wait at least one completion (or returns immediatly if some are already available), and read all completions available,
+	returns number of completions or -1 on error */
+	template<typename OnCompletion>
+	int wait(Exception& ex, const OnCompletion& onCompletion) {
+		_waiter = std::this_thread::get_id(); // its submissions are entered here
+		if (!recycle(ex))
+			return -1;
+		UInt32 head = _cqHead ? *_cqHead : 0;
+		UInt32 toSubmit = __atomic_load_n(_sqTail, __ATOMIC_ACQUIRE) == __atomic_load_n(_sqHead, __ATOMIC_ACQUIRE) ? 0 : (_sqMask + 1);
+		if (head == __atomic_load_n(_cqTail, __ATOMIC_ACQUIRE)) {
+			if (!enter(ex, toSubmit, 1))
+				return -1;
+		} else if (toSubmit && !enter(ex, toSubmit, 0))
+			return -1;
+		int count(0);
+		for (;;) {
+			UInt32 tail = __atomic_load_n(_cqTail, __ATOMIC_ACQUIRE);
+			if (head == tail)
+				break;
+			do {
+				const io_uring_cqe& cqe(_cqes[head++ & _cqMask]);
+				Completion completion({ cqe.user_data, cqe.res, cqe.flags });
+				__atomic_store_n(_cqHead, head, __ATOMIC_RELEASE); // free cqe before the callback which can submit
+				onCompletion(completion);
+				++count;
+			} while (head != tail);
+		}
+		return count;
+	}
+#endif
+
+private:
+#if defined(MONA_IO_URING)
+	bool	 submit(Exception& ex, UInt8 opcode, int fd, const void* address, UInt32 size, UInt64 offset, UInt64 userData, UInt32 flags = 0, UInt8 sqeFlags = 0, UInt16 group = 0, UInt16 priority = 0);
+	bool	 enter(Exception& ex, UInt32 toSubmit, UInt32 minComplete);
+	// submission steps, _mutex locked
+	bool	 reserve(Exception& ex, UInt32 count);
+	void	 prepare(UInt32 tail, UInt8 opcode, int fd, const void* address, UInt32 size, UInt64 offset, UInt64 userData, UInt32 flags, UInt8 sqeFlags, UInt16 group = 0, UInt16 priority = 0);
+	bool	 commit(Exception& ex, UInt32 tail);
+	bool	 recycle(Exception& ex); // buffers waiting to be given back to the kernel
+
+	struct Group {
+		UInt8*	data;
+		UInt32	size;
+		UInt16	count;
+		UInt16	recycling; // first id of buffers to give back
+		UInt16	recycled; // number of buffers to give back
+	};
+
+	std::mutex						_mutex; // submission protection
+	std::atomic<std::thread::id>	_waiter; // thread reading completions
+	std::vector<Group>				_groups; // provided buffers, indexed by group id
+	io_uring_sqe*	_sqes;
+	UInt32*			_sqHead;
+	UInt32*			_sqTail;
+	UInt32			_sqMask;
+	UInt32*			_sqArray;
+	io_uring_cqe*	_cqes;
+	UInt32*			_cqHead;
+	UInt32*			_cqTail;
+	UInt32			_cqMask;
+	void*			_sqRing;
+	UInt32			_sqRingSize;
+	void*			_cqRing;
+	UInt32			_cqRingSize;
+	UInt32			_sqesSize;
+#endif
+	int				_fd;
+};
+
+
+} // namespace Mona
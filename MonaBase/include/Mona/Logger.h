@@ -51,6 +51,9 @@ struct Logger : virtual Object {
 
 	virtual bool log(LOG_LEVEL level, const Path& file, long line, const std::string& message) = 0;
 	virtual bool dump(const std::string& header, const UInt8* data, UInt32 size) = 0;
+	/*!
+	Called after a batch of logs (after every log when logs are synchronous), to write logs buffered by log */
+	virtual bool flush() { return true; }
 };
 
 } // namespace Mona
@@ -38,6 +38,7 @@ struct Logs : virtual Static {
 		if (fatalPos != std::string::npos)
 			name[fatalPos] = 0;
 		std::lock_guard<std::mutex> lock(_Mutex);
+		WritePending(); // pending logs are for previous loggers
 		const auto& it = _Loggers.emplace(std::move(name), nullptr).first;
 		if (it->second)
 			return false;
@@ -48,7 +49,7 @@ struct Logs : virtual Static {
 	}
 	/*!
 	Remove a logger */
-	static void			RemoveLogger(const char* name) { std::lock_guard<std::mutex> lock(_Mutex); _Loggers.erase(name); }
+	static void			RemoveLogger(const char* name) { std::lock_guard<std::mutex> lock(_Mutex); WritePending(); _Loggers.erase(name); }
 	/*!
 	Set LOG level */
 	static void			SetLevel(LOG_LEVEL level) { _Level = level; }
@@ -65,6 +66,24 @@ struct Logs : virtual Static {
 	static bool			IsDumping() { return _IsDumping; }
 
 	static bool			Logging() { return _Logging; }
+	/*!
+	Thread id and time of the log dispatched, to use in Logger::log implementation (values of the caller even if logs are asynchronous) */
+	static UInt32		LoggingThreadId() { return _LoggingThreadId; }
+	static Int64		LoggingTime() { return _LoggingTime; }
+
+	/*!
+	Asynchronous logs: LOG formats message in a lock-free ring of the calling thread, and a logger thread dispatches them by batch to loggers.
+	FATAL and CRITIC logs and dumps stay synchronous (pending logs are written before them).
+	capacity is the count of logs by thread ring (rounded up to a power of 2), on overflow log is dropped (see Dropped) or caller waits if block=true.
+	capacity=0 comes back to synchronous logs, call it preferably on start or stop (logs being written by other threads during the call can be lost) */
+	static void			SetAsynchronous(UInt32 capacity, bool block = false);
+	static bool			IsAsynchronous() { return _Async.capacity ? true : false; }
+	/*!
+	Count of asynchronous logs dropped on ring overflow */
+	static UInt64		Dropped() { return _Async.dropped; }
+	/*!
+	Write pending asynchronous logs, can't be called from a Logger */
+	static void			Flush();
 	
 	static bool			LastCritic(std::string& critic);
 
@@ -73,17 +92,18 @@ struct Logs : virtual Static {
 		if (_Logging || _Level < level)
 			return;
 		_Logging = true;
+		if (level > LOG_CRITIC && _Async.capacity && _Async.push(level, file, line, std::forward<Args>(args)...)) {
+			_Logging = false;
+			return;
+		}
 		std::lock_guard<std::mutex> lock(_Mutex);
-		static Path File;
+		if (_Async.capacity)
+			_Async.flush();
 		static String Message;
-		File.set(file);
 		String::Assign(Message, std::forward<Args>(args)...);
 		if (level <= LOG_CRITIC)
 			_Critic.assign(Message.empty() ? "unknown" : Message.c_str());
-		for (auto& it : _Loggers) {
-			if (*it.second && !it.second->log(level, File, line, Message))
-				_Loggers.fail(*it.second);
-		}
+		_Loggers.log(level, file, line, Message, Thread::CurrentId(), Time::Now());
 		if(Message.size()>0xFF) {
 			Message.resize(0xFF);
 			Message.shrink_to_fit();
@@ -140,20 +160,115 @@ struct Logs : virtual Static {
 
 private:
 	static void		Dump(const std::string& header, const UInt8* data, UInt32 size);
+	/*!
+	Write pending asynchronous logs, _Mutex has to be locked */
+	static void		WritePending() {
+		if (!_Async.capacity)
+			return;
+		_Async.flush();
+		_Loggers.flush();
+	}
 
 	static std::mutex				_Mutex;
 	static thread_local bool		_Logging;
 	static std::string				_Critic;
+	static UInt32					_LoggingThreadId;
+	static Int64					_LoggingTime;
 
 	static std::atomic<LOG_LEVEL>	_Level;
 	static struct Loggers : std::map<std::string, unique<Logger>, String::IComparator>, virtual Object {
 		Loggers() { self["console"].set<ConsoleLogger>(); }
+		void log(LOG_LEVEL level, const char* file, long line, const std::string& message, UInt32 threadId, Int64 time);
 		void fail(Logger& logger) { _failed.emplace_back(&logger); }
+		/*!
+		Flush loggers and remove failed loggers */
 		void flush();
 	private:
+		Path				 _file;
 		std::vector<Logger*> _failed;
 	}								_Loggers;
 
+	/*!
+	Single-producer single-consumer ring of one thread, entries are reused to keep their string capacities */
+	struct Ring : virtual Object {
+		struct Entry {
+			LOG_LEVEL	level;
+			std::string	file; // copy because file can be a temporary string (script logs)
+			long		line;
+			Int64		time;
+			String		message;
+		};
+		Ring(UInt32 capacity) : entries(capacity), mask(capacity - 1), threadId(Thread::CurrentId()), closed(false), writing(false), head(0), tail(0) {}
+		std::vector<Entry>		entries;
+		const UInt32			mask;
+		const UInt32			threadId;
+		std::atomic<bool>		closed; // abandoned by SetAsynchronous
+		std::atomic<bool>		writing; // producer in push, closing waits its end
+		std::atomic<UInt32>		head; // next entry to write (producer)
+		std::atomic<UInt32>		tail; // next entry to read (consumer)
+	};
+	static struct Async : Thread, virtual Object {
+		Async() : Thread("Logs"), capacity(0), block(false), dropped(0), pending(false) {}
+		~Async();
+
+		std::atomic<UInt32>	capacity;
+		volatile bool		block;
+		std::atomic<UInt64>	dropped;
+		std::atomic<bool>	pending;
+
+		template <typename ...Args>
+		bool push(LOG_LEVEL level, const char* file, long line, Args&&... args) {
+			Ring* pRing = ring();
+			if (!pRing)
+				return false;
+			pRing->writing = true;
+			if (pRing->closed) { // closed meanwhile => synchronous log
+				pRing->writing = false;
+				return false;
+			}
+			UInt32 head = pRing->head.load(std::memory_order_relaxed);
+			while ((head - pRing->tail.load(std::memory_order_acquire)) > pRing->mask) {
+				if (pRing->closed) { // nobody will drain it anymore => synchronous log
+					pRing->writing = false;
+					return false;
+				}
+				if (!block) {
+					++dropped;
+					pRing->writing = false;
+					return true;
+				}
+				if (!pending.exchange(true))
+					wakeUp.set();
+				std::this_thread::yield();
+			}
+			Ring::Entry& entry = pRing->entries[head & pRing->mask];
+			entry.level = level;
+			entry.file.assign(file);
+			entry.line = line;
+			entry.time = Time::Now();
+			String::Assign(entry.message, std::forward<Args>(args)...);
+			pRing->head.store(head + 1, std::memory_order_release);
+			pRing->writing = false;
+			if (!pending.exchange(true))
+				wakeUp.set();
+			return true;
+		}
+		/*!
+		Consumer, dispatches logs of rings to loggers, _Mutex has to be locked */
+		void flush();
+		/*!
+		Abandon rings (logs pushed while closing are written) and apply new configuration, _Mutex has to be locked and thread stopped */
+		void reset(UInt32 capacity, bool block);
+	private:
+		Ring* ring();
+		void  drain(Ring& ring);
+		bool run(Exception& ex, const volatile bool& requestStop);
+
+		static thread_local shared<Ring>	_Ring;
+		std::mutex							_mutex; // protect _rings
+		std::vector<shared<Ring>>			_rings;
+	}								_Async;
+
 	static volatile bool	_IsDumping;
 	static std::string		_Dump; // empty() means all dump, otherwise is a dump filter
 
@@ -0,0 +1,147 @@
+/*
+This file is a part of MonaSolutions Copyright 2017
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or
+modify it under the terms of the the Mozilla Public License v2.0.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+Mozilla Public License v. 2.0 received along this program for more
+details (or else see http://mozilla.org/MPL/2.0/).
+
+*/
+
+#pragma once
+
+#include "Mona/Mona.h"
+#include <atomic>
+
+namespace Mona {
+
+/*!
+Unbounded lock-free Multi-Producer Single-Consumer queue (Dmitry Vyukov's algorithm),
+push is thread-safe and lock-free (one atomic exchange), pop/flush/empty have to be called by one unique consumer thread.
+Nodes are recycled: the consumer gives back the nodes consumed, producers take them back all at once in a thread cache,
+so in steady state a push doesn't allocate */
+template<typename Type>
+struct MPSCQueue : virtual Object {
+	MPSCQueue() : _pHead(&_stub), _pTail(&_stub), _pRecycling(NULL), _pRecyclingLast(NULL), _recycling(0) {}
+	~MPSCQueue() {
+		Type value;
+		while (pop(value));
+		if (_pTail != &_stub)
+			recycle(_pTail);
+		recycle();
+	}
+
+	template<typename ...Args>
+	void push(Args&&... args) {
+		Node* pNode = NewNode();
+		pNode->value = Type(std::forward<Args>(args)...);
+		pNode->pNext.store(NULL, std::memory_order_relaxed);
+		// after exchange the node is visible to the consumer just when previous node is linked to it
+		_pHead.exchange(pNode)->pNext.store(pNode, std::memory_order_release);
+	}
+
+	/*!
+	Consumer only, can return false while a push is in progress */
+	bool empty() const { return !_pTail->pNext.load(std::memory_order_acquire); }
+	/*!
+	Consumer only, returns false if queue is empty */
+	bool pop(Type& value) {
+		Node* pNext = _pTail->pNext.load(std::memory_order_acquire);
+		if (!pNext)
+			return false;
+		value = std::move(pNext->value); // pNext becomes the new stub node
+		if (_pTail != &_stub)
+			recycle(_pTail);
+		_pTail = pNext;
+		return true;
+	}
+	/*!
+	Consumer only, pops and gives to function values pushed before this call (batch drain, values pushed meanwhile wait the next flush),
+	stops on a push in progress (its producer has to signal after push to get a new flush), returns count of values flushed */
+	template<typename Function>
+	UInt32 flush(const Function& function) {
+		Node* pLast = _pHead.load();
+		UInt32 count(0);
+		Type value;
+		// don't wait a producer which has exchanged head but not yet linked its node, it can be preempted (mainly with more producers than cores)
+		while (_pTail != pLast && pop(value)) {
+			function(value);
+			++count;
+		}
+		recycle();
+		return count;
+	}
+
+private:
+	struct Node {
+		Node() : pNext(NULL) {}
+		Type				value; // moved on pop, so a recycled node holds no more resource
+		std::atomic<Node*>	pNext; // next in queue, or next recycled node
+	};
+	/*!
+	Nodes recycled, shared by all the queues of this type, never deleted to stay valid
+	for queues and threads destroyed during the static deinitialization */
+	static std::atomic<Node*>& Recycled() { static std::atomic<Node*>* PRecycled(new std::atomic<Node*>(NULL)); return *PRecycled; }
+	static void Recycle(Node* pFirst, Node* pLast) {
+		// one consumer by queue, but several queues can recycle at the same time
+		std::atomic<Node*>& recycled(Recycled());
+		Node* pNext = recycled.load(std::memory_order_relaxed);
+		do {
+			pLast->pNext.store(pNext, std::memory_order_relaxed);
+		} while (!recycled.compare_exchange_weak(pNext, pFirst, std::memory_order_release, std::memory_order_relaxed));
+	}
+	/*!
+	Consumer keeps nodes consumed to recycle them by batch (one atomic operation) */
+	void recycle(Node* pNode) {
+		pNode->pNext.store(_pRecycling, std::memory_order_relaxed);
+		if (!_pRecycling)
+			_pRecyclingLast = pNode;
+		_pRecycling = pNode;
+		if (++_recycling >= 64)
+			recycle();
+	}
+	void recycle() {
+		if (!_pRecycling)
+			return;
+		Recycle(_pRecycling, _pRecyclingLast);
+		_pRecycling = NULL;
+		_recycling = 0;
+	}
+	static Node* NewNode() {
+		struct Cache : virtual Object {
+			Cache() : pFirst(NULL) {}
+			~Cache() { // thread ends, give back its nodes
+				if (!pFirst)
+					return;
+				Node* pLast(pFirst);
+				while (Node* pNext = pLast->pNext.load(std::memory_order_relaxed))
+					pLast = pNext;
+				Recycle(pFirst, pLast);
+			}
+			Node* pFirst;
+		};
+		static thread_local Cache Nodes;
+		// take all the recycled nodes at once (an exchange has not the ABA problem of a pop)
+		if (!Nodes.pFirst && !(Nodes.pFirst = Recycled().exchange(NULL, std::memory_order_acquire)))
+			return new Node();
+		Node* pNode = Nodes.pFirst;
+		Nodes.pFirst = pNode->pNext.load(std::memory_order_relaxed);
+		return pNode;
+	}
+
+	Node				_stub;
+	std::atomic<Node*>	_pHead; // last node pushed (producers)
+	Node*				_pTail; // node already consumed (consumer)
+	Node*				_pRecycling; // nodes consumed to recycle (consumer)
+	Node*				_pRecyclingLast;
+	UInt8				_recycling;
+};
+
+
+} // namespace Mona
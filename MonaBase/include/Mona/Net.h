@@ -203,6 +203,10 @@ struct Net : virtual Object {
 	static UInt32 GetSendBufferSize() { return _Net._sendBufferSize; }
 	static void	  SetSendBufferSize(UInt32 size) { _Net._sendBufferSize = size; }
 	static void	  ResetSendBufferSize() { _Net._sendBufferSize = _Net._sendBufferDefaultSize; }
+	/*!
+	IOSocket engine, io_uring (linux only) rather epoll, applied on next IOSocket start */
+	static bool	  GetIOUring() { return _Net._ioUring; }
+	static void	  SetIOUring(bool value) { _Net._ioUring = value; }
 
 	static UInt32 GetInterfaceIndex(const SocketAddress& address);
 
@@ -225,6 +229,9 @@ struct Net : virtual Object {
 		virtual double	sendLostRate() const { return 0; }
 
 		virtual UInt64	queueing() const = 0;
+		/*!
+		System calls avoided on sending by batching (sendmmsg/UDP GSO) */
+		virtual UInt64	sendSyscallsSaved() const { return 0; }
 
 		static Stats& Null();
 	};
@@ -238,6 +245,7 @@ private:
 	std::atomic<UInt32> _sendBufferSize;
 	int					_recvBufferDefaultSize;
 	int					_sendBufferDefaultSize;
+	std::atomic<bool>	_ioUring;
 
 	static Net _Net;
 };
@@ -18,6 +18,7 @@ details (or else see http://mozilla.org/MPL/2.0/).
 
 #include "Mona/Mona.h"
 #include "Mona/Event.h"
+#include <vector>
 
 namespace Mona {
 
@@ -105,7 +106,7 @@ struct Parameters : String::Object<Parameters> {
 	std::pair<const_iterator, bool> emplace(const std::string& key, ValueType&& value) {
 		if (!_pMap)
 			_pMap.set();
-		const auto& it = _pMap->emplace(key, std::string());
+		const auto& it = _pMap->emplace(key);
 		if (it.second || it.first->second.compare(value) != 0) {
 			it.first->second = std::forward<ValueType>(value);
 			onParamChange(it.first->first, &it.first->second);
@@ -127,7 +128,45 @@ private:
 	virtual const std::string* onParamUnfound(const std::string& key) const { return onUnfound(key); }
 	virtual void onParamInit() {}
 
-	const std::map<std::string, std::string, String::IComparator>& params() const { if (!_pMap) ((Parameters&)self).onParamInit(); return _pMap ? *_pMap : *Null()._pMap; }
+	/*!
+	Ordered map for iteration and prefix queries (begin, lower_bound, range, from),
+	indexed beyond INDEX_MIN keys by an open addressing table on case-folded key hashes for direct accesses (find, emplace, erase).
+	Copy rebuilds the index on the new nodes, assignment is forbidden (Object) */
+	struct Map : virtual Object {
+		typedef std::map<std::string, std::string, String::IComparator> Container;
+		enum { INDEX_MIN = 64 }; // below, a binary search on few keys is faster than hashing the key
+
+		Map() : _count(0) {}
+		Map(const Map& other);
+
+		const_iterator	begin() const { return _map.begin(); }
+		const_iterator	end() const { return _map.end(); }
+		const_iterator	lower_bound(const std::string& key) const { return _map.lower_bound(key); }
+		UInt32			size() const { return _map.size(); }
+		bool			empty() const { return _map.empty(); }
+
+		const_iterator							find(const std::string& key) const { return _slots.empty() ? _map.find(key) : find(key, Hash(key)); }
+		std::pair<Container::iterator, bool>	emplace(const std::string& key) { return (_slots.empty() && _map.size() < INDEX_MIN) ? _map.emplace(key, std::string()) : index(key); }
+		const_iterator							erase(const_iterator it);
+
+	private:
+		struct Slot {
+			Slot() : hash(0) {}
+			UInt32				hash; // 0 => empty
+			Container::iterator	it;
+		};
+		static UInt32 Hash(const std::string& key);
+		const_iterator	find(const std::string& key, UInt32 hash) const;
+		std::pair<Container::iterator, bool> index(const std::string& key); // emplace on an indexed map, or the one which exceeds INDEX_MIN (builds index)
+		void			index(UInt32 hash, const Container::iterator& it);
+		void			index();
+
+		Container			_map;
+		std::vector<Slot>	_slots; // power of 2, half empty at least, empty while not indexed
+		UInt32				_count;
+	};
+
+	const Map& params() const { if (!_pMap) ((Parameters&)self).onParamInit(); return _pMap ? *_pMap : *Null()._pMap; }
 
 
 	Parameters(std::nullptr_t) : _pMap(SET) {} // Null()
@@ -136,7 +175,7 @@ private:
 
 	// shared because a lot more faster than using st::map move constructor!
 	// Also build _pMap just if required, and then not erase it but clear it (more faster that reset the shared)
-	shared<std::map<std::string, std::string, String::IComparator>>	_pMap;
+	shared<Map>	_pMap;
 };
 
 
@@ -20,17 +20,27 @@ details (or else see http://mozilla.org/MPL/2.0/).
 #include "Mona/Thread.h"
 #include "Mona/Exceptions.h"
 #include "Mona/Packet.h"
+#include "Mona/File.h"
 #include <functional>
 #include <deque>
+#include <unordered_map>
 
 namespace Mona {
 
 
 struct PersistentData : private Thread, virtual Object {
-	PersistentData(const char* name = "PersistentData") : _disableTransaction(false), Thread(name) {}
+	enum Format {
+		FORMAT_FOLDERS = 0, // a folder by entry path, value in a file named with its MD5
+		FORMAT_LOG // append-only log file "rootDir.log", compacted when it has more obsolete than alive data
+	};
+	PersistentData(const char* name = "PersistentData", Format format = FORMAT_FOLDERS) : format(format), _disableTransaction(false), _logSize(0), _aliveSize(0), Thread(name) {}
+
+	const Format format;
 
 	typedef std::function<void(const std::string& path, const Packet& packet)> ForEach;
 
+	/*!
+	Load entries, in FORMAT_LOG the log is read in one time and entries of a FORMAT_FOLDERS rootDir are migrated into (then folders are deleted) */
 	void load(Exception& ex, const std::string& rootDir, const ForEach& forEach, bool disableTransaction=false);
 
 /*!
@@ -49,7 +59,7 @@ struct PersistentData : private Thread, virtual Object {
 private:
 	struct Entry : Packet, virtual public Object {
 		Entry(const char* path, const Packet& packet) : path(path), Packet(std::move(packet)), clearing(false) {} // add
-		Entry(const char* path) : clearing(path ? true : false) { if (!clearing) this->path.assign(path); } // remove or clear
+		Entry(const char* path) : clearing(path ? false : true) { if (!clearing) this->path.assign(path); } // remove or clear
 	
 		std::string	path;
 		const bool	clearing;
@@ -70,10 +80,31 @@ private:
 	void processEntry(Exception& ex, Entry& entry);
 	bool loadDirectory(Exception& ex, const std::string& directory, const std::string& path, const ForEach& forEach);
 
+	struct Record {
+		Record() : size(0) {}
+		UInt32	size; // size in log
+		Packet	value; // just during loading or compaction
+	};
+	typedef std::unordered_map<std::string, Record> Records;
+
+	void loadLog(Exception& ex, const ForEach& forEach);
+	/*!
+	Returns false on reading error, a corrupted tail is ignored with a Ex::Format exception and corrupted set to true */
+	bool readLog(Exception& ex, Records& records, bool& corrupted);
+	bool writeLog(Exception& ex, Records& records);
+	bool flushLog(Exception& ex);
+
 	std::string							_rootPath;
 	std::mutex							_mutex;
 	std::deque<shared<Entry>>	_entries;
 	bool								_disableTransaction;
+
+	// FORMAT_LOG
+	unique<File>						_pLog;
+	Buffer								_logBuffer; // entries to append in one write and one fsync
+	Records								_records; // alive entries
+	UInt64								_logSize;
+	UInt64								_aliveSize;
 };
 
 } // namespace Mona
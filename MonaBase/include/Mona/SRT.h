@@ -130,6 +130,9 @@ struct SRT : virtual Object {
 		bool getOverheadBW(Exception& ex, UInt32& value) const { return getOption(ex, ::SRTO_OHEADBW, value); } // Not supported for now in SRT
 		bool setMaxBW(Exception& ex, Int64 value) { return setOption(ex, ::SRTO_MAXBW, value); }
 		bool getMaxBW(Exception& ex, Int64& value) const { return getOption(ex, ::SRTO_MAXBW, value); }	
+		/*!
+		SRT paces itself, rate is its maximum bandwidth (burst is ignored) */
+		virtual bool setPacing(Exception& ex, UInt64 rate, UInt32 burst = 0) { return setMaxBW(ex, rate ? Int64(rate) : -1); }
 
 		bool setPktDrop(Exception& ex, bool value) { return setOption(ex, ::SRTO_TLPKTDROP, value); }
 		bool getPktDrop(Exception& ex, bool& value) const { int val; bool res = getOption(ex, ::SRTO_TLPKTDROP, val); value = val > 0; return res; }
@@ -0,0 +1,125 @@
+/*
+This file is a part of MonaSolutions Copyright 2017
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or
+modify it under the terms of the the Mozilla Public License v2.0.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+Mozilla Public License v. 2.0 received along this program for more
+details (or else see http://mozilla.org/MPL/2.0/).
+
+*/
+
+#pragma once
+
+#include "Mona/Mona.h"
+#include <vector>
+
+namespace Mona {
+
+/*!
+Container which gives an id to every value inserted, find and erase by id are O(1) without allocation (once arrays are grown).
+An id is made of slot index + 1 on the 24 lower bits and of a slot generation on the 8 upper bits, incremented on erase,
+so an id erased doesn't find the value which reuses its slot, and freed slots are reused in their release order to delay id reuse.
+Values are packed in a dense array of (id, value) for iteration, erase moves the last value to the erased place */
+template<typename Type>
+struct SlotMap : virtual Object {
+	typedef typename std::vector<std::pair<UInt32, Type>>::iterator			iterator;
+	typedef typename std::vector<std::pair<UInt32, Type>>::const_iterator	const_iterator;
+	enum : UInt32 {
+		MAX_SIZE = 0xFFFFFF
+	};
+
+	SlotMap() : _freeHead(END), _freeTail(END) {}
+
+	UInt32			size() const { return _values.size(); }
+	bool			empty() const { return _values.empty(); }
+	iterator		begin() { return _values.begin(); }
+	iterator		end() { return _values.end(); }
+	const_iterator	begin() const { return _values.begin(); }
+	const_iterator	end() const { return _values.end(); }
+
+	Type* find(UInt32 id) {
+		UInt32 position = this->position(id);
+		return position == END ? NULL : &_values[position].second;
+	}
+	const Type* find(UInt32 id) const { return ((SlotMap&)self).find(id); }
+
+	/*!
+	Insert a value and returns its id, returns 0 if MAX_SIZE is reached */
+	template<typename ...Args>
+	UInt32 emplace(Args&&... args) {
+		UInt32 index(_freeHead);
+		if (index != END) {
+			if ((_freeHead = _slots[index].position) == END)
+				_freeTail = END;
+		} else {
+			if (_slots.size() >= MAX_SIZE)
+				return 0;
+			index = _slots.size();
+			_slots.emplace_back(index + 1);
+		}
+		Slot& slot(_slots[index]);
+		slot.position = _values.size();
+		_values.emplace_back(std::piecewise_construct, std::forward_as_tuple(slot.id), std::forward_as_tuple(std::forward<Args>(args)...));
+		return slot.id;
+	}
+
+	bool erase(UInt32 id) {
+		UInt32 position = this->position(id);
+		if (position == END)
+			return false;
+		if (position != (_values.size() - 1)) {
+			_values[position] = std::move(_values.back());
+			_slots[(_values[position].first & MAX_SIZE) - 1].position = position;
+		}
+		_values.pop_back();
+		// next generation, and push slot at the end of free list
+		UInt32 index((id & MAX_SIZE) - 1);
+		_slots[index].id += MAX_SIZE + 1;
+		_slots[index].position = END;
+		if (_freeTail == END)
+			_freeHead = index;
+		else
+			_slots[_freeTail].position = index;
+		_freeTail = index;
+		return true;
+	}
+
+	void clear() {
+		_values.clear();
+		_slots.clear();
+		_freeHead = _freeTail = END;
+	}
+
+private:
+	enum : UInt32 {
+		END = 0xFFFFFFFF
+	};
+	struct Slot {
+		Slot(UInt32 id) : id(id), position(END) {}
+		UInt32 id; // current id, or next id if free
+		UInt32 position; // position in values, or next free slot if free
+	};
+
+	UInt32 position(UInt32 id) const {
+		UInt32 index((id & MAX_SIZE) - 1);
+		if (index >= _slots.size())
+			return END;
+		// if slot is free, position is an other slot index or END, and value at this position has an other id
+		UInt32 position(_slots[index].position);
+		return position < _values.size() && _values[position].first == id ? position : END;
+	}
+
+	std::vector<std::pair<UInt32, Type>>	_values;
+	std::vector<Slot>						_slots;
+	UInt32									_freeHead;
+	UInt32									_freeTail;
+};
+
+
+} // namespace Mona
@@ -21,11 +21,14 @@ details (or else see http://mozilla.org/MPL/2.0/).
 #include "Mona/ByteRate.h"
 #include "Mona/Packet.h"
 #include "Mona/Handler.h"
+#include "Mona/ThreadPool.h"
 #include "Mona/Parameters.h"
 #include <deque>
 
 namespace Mona {
 
+struct IOSocket;
+struct File;
 struct Socket : virtual Object, Net::Stats {
 	typedef Event<void(shared<Buffer>& pBuffer, const SocketAddress& address)>	  OnReceived;
 	typedef Event<void(const shared<Socket>& pSocket)>							  OnAccept;
@@ -55,7 +58,9 @@ struct Socket : virtual Object, Net::Stats {
 	};
 
 	enum {
-		BACKLOG_MAX = 200 // blacklog maximum, see http://tangentsoft.net/wskfaq/advanced.html#backlog
+		BACKLOG_MAX = 200, // blacklog maximum, see http://tangentsoft.net/wskfaq/advanced.html#backlog
+		RECV_BATCH_MAX = 32, // datagrams maximum received by system call, see receive(ex, pBuffers, addresses, count)
+		SEND_BATCH_MAX = 64 // packets maximum sent by system call on flush (sendmmsg/sendmsg), and segments maximum by UDP GSO message
 	};
 
 	/*!
@@ -80,6 +85,7 @@ struct Socket : virtual Object, Net::Stats {
 
 	virtual UInt32		available() const;
 	UInt64				queueing() const { return _queueing; }
+	UInt64				sendSyscallsSaved() const { return _sendSyscallsSaved; }
 	
 	const SocketAddress& address() const;
 	const SocketAddress& peerAddress() const { return _peerAddress; }
@@ -136,6 +142,12 @@ struct Socket : virtual Object, Net::Stats {
 	
 	int			 receive(Exception& ex, void* buffer, UInt32 size, int flags = 0) { return receive(ex, buffer, size, flags, NULL); }
 	int			 receiveFrom(Exception& ex, void* buffer, UInt32 size, SocketAddress& address, int flags = 0)  { return receive(ex, buffer, size, flags, &address); }
+	/*!
+	Receive up to count datagrams (RECV_BATCH_MAX maximum) in one system call when possible (recvmmsg),
+	null buffers are allocated (and reused otherwise), and resized to the received size.
+	Returns the number of datagrams received, or -1 on error.
+	A truncated datagram is lost and set a NET_EMSGSIZE exception without returning -1 */
+	virtual int	 receive(Exception& ex, shared<Buffer>* pBuffers, SocketAddress* addresses, UInt32 count);
 
 	int			 send(Exception& ex, const void* data, UInt32 size, int flags = 0) { return sendTo(ex, data, size, SocketAddress::Wildcard(), flags); }
 	virtual int	 sendTo(Exception& ex, const void* data, UInt32 size, const SocketAddress& address, int flags=0);
@@ -145,9 +157,22 @@ struct Socket : virtual Object, Net::Stats {
 	Returns size of data sent immediatly (or -1 if error, for TCP socket a SHUTDOWN_SEND is done, so socket will be disconnected) */
 	int			 write(Exception& ex, const Packet& packet, int flags = 0) { return write(ex, packet, SocketAddress::Wildcard(), flags); }
 	int			 write(Exception& ex, const Packet& packet, const SocketAddress& address, int flags = 0);
+	/*!
+	Zero-copy writing of size bytes from the file reading position (sendfile), only for stream socket not secure or with kTLS (else Ex::Unsupported),
+	returns size of data sent, 0 if socket is congested or if data are queueing (keep data order, wait onFlush), or -1 if error */
+	int			 writeFile(Exception& ex, File& file, UInt32 size);
 
 	bool		 flush(Exception& ex) { return flush(ex, false); }
 
+	/*!
+	Pace sendings with a token bucket: rate in bytes/s, and bursts up to burst bytes (0 = 10ms of rate, 3000 minimum),
+	data written beyond are queued and released on schedule (requires IOSocket subscription), onFlush is raised once sent.
+	SO_MAX_PACING_RATE is set too to let the kernel pace below (TCP, or fq qdisc), its failure is just a warning.
+	rate=0 disables pacing */
+	virtual bool setPacing(Exception& ex, UInt64 rate, UInt32 burst = 0);
+	UInt64		 pacingRate() const { return _pacing.rate; }
+	UInt32		 pacingBurst() const { return _pacing.burst; }
+
 	template <typename ...Args>
 	static Exception& SetException(int error, Exception& ex, Args&&... args) {
 		if (!error)
@@ -171,6 +196,11 @@ protected:
 	void			receive(UInt32 count) { _recvTime = Time::Now(); _recvByteRate += count; }
 	virtual bool	flush(Exception& ex, bool deleting);
 	virtual bool	close(ShutdownType type = SHUTDOWN_BOTH);
+#if defined(__linux__)
+	/*!
+	Zero-copy sending of size bytes of the file handle from offset, returns size sent, 0 if congested, or -1 on error (Ex::Unsupported if impossible) */
+	virtual int		sendFile(Exception& ex, int handle, UInt64 offset, UInt32 size);
+#endif
 
 	template<typename Type, typename = typename std::enable_if<std::is_arithmetic<Type>::value && !std::is_same<Type, bool>::value>::type>
 	bool processParam(const Parameters& parameters, const char* name, Type& value, const char* prefix = NULL) {
@@ -232,10 +262,36 @@ private:
 		const int			flags;
 	};
 
+	/*!
+	Send the front of the queue in one system call when possible (sendmmsg+UDP GSO for datagrams, sendmsg scatter-gather
+	for streams, one record for secure streams), returns -1 on error, 0 if socket can't send more now, 1 otherwise.
+	budget limits bytes sent (pacing), excepting for the first datagram which is always sent whole */
+	int		flushSendings(Exception& ex, UInt32& written, UInt32 budget = 0xFFFFFFFF);
+	/*!
+	Remove size bytes sent from the queue, last packet can be partially sent */
+	UInt32	popSendings(UInt32 size, UInt32& written);
+	/*!
+	Refill the pacing bucket and assign budget, returns false if sending has to wait (a flush is scheduled), _mutexSending has to be locked */
+	bool	pace(UInt32& budget);
+	void	paced(UInt32 size) { if (_pacing.rate && _pReactor) _pacing.tokens -= Int64(size) * 1000; }
+
+	struct Pacing : virtual Object {
+		Pacing() : rate(0), burst(0), tokens(0), time(0), scheduled(false) {}
+		std::atomic<UInt64>	rate; // bytes/s, 0 = no pacing
+		std::atomic<UInt32>	burst;
+		Int64				tokens; // in thousandths of byte to keep the precision of a 1ms refill, can be negative (packet greater than budget)
+		Int64				time; // last refill
+		bool				scheduled;
+		weak<Socket>		weakSocket; // assigned on IOSocket subscription to schedule flush
+	};
+
 	Exception					_ex;
 	mutable std::mutex			_mutexSending;
 	std::deque<Sending>			_sendings;
 	std::atomic<UInt64>			_queueing;
+	std::atomic<UInt64>			_sendSyscallsSaved;
+	bool						_gso; // UDP GSO, disabled on first refusal
+	Pacing						_pacing; // protected by _mutexSending
 
 	std::atomic<Int64>			_recvTime;
 	ByteRate					_recvByteRate;
@@ -251,10 +307,15 @@ private:
 	OnFlush						onFlush;
 	OnDisconnection				onDisconnection;
 
-	UInt16						_threadReceive;
+	ThreadPool::Track			_threadReceive;
 	std::atomic<UInt32>			_receiving;
 	std::atomic<UInt8>			_reading;
+	std::mutex					_mutexUndelivered;
+	std::deque<std::pair<shared<Buffer>, SocketAddress>> _undelivered; // receptions waiting delivery: rest of a batch received over the budget, or io_uring receptions
+	UInt32						_undeliveredSize; // bytes of _undelivered, protected by _mutexUndelivered
+	UInt8						_flushing; // io_uring sendings in progress (IOSocket completes the flush), protected by _mutexSending
 	const Handler*				_pHandler; // to diminue size of Action+Handle
+	IOSocket*					_pReactor; // IOSocket reactor thread which manages this socket
 
 	bool						_opened;
 
@@ -263,6 +324,7 @@ private:
 #endif
 
 	friend struct IOSocket;
+	friend struct IOSRTSocket;
 };
 
 
@@ -110,6 +110,10 @@ struct SocketAddress : private IPAddress, virtual Object {
 	
 	explicit operator bool() const { return port() || !isWildcard(); }
 
+	/*!
+	Hash of host and port (FNV-1a), for hash tables */
+	UInt32 hash() const;
+
 	// Returns a wildcard IPv4 or IPv6 address (0.0.0.0)
 	static const SocketAddress& Wildcard(IPAddress::Family family = IPAddress::IPv4);
 
@@ -188,6 +188,12 @@ struct String : std::string {
 	static Type ToNumber(Exception& ex, const char* value, Math base = BASE_10) { Type result; return ToNumber(ex, value, std::string::npos, result, base) ? result : defaultValue; }
 	template<typename Type, long long defaultValue>
 	static Type ToNumber(Exception& ex, const char* value, std::size_t size, Math base = BASE_10) { Type result; return ToNumber(ex, value, size, result, base) ? result : defaultValue; }
+	/*!
+	Write number in buffer without locale neither allocation, returns size written (buffer of 24 bytes for integer and 32 bytes for floating point),
+	floating point is written with the shortest digits which give the same value when parsed, in a %g style (%.16g for double, %.8g for float) */
+	static UInt8 FromNumber(UInt64 value, bool negative, char* buffer);
+	static UInt8 FromNumber(double value, char* buffer);
+	static UInt8 FromNumber(float value, char* buffer);
 	
 
 	static bool IsTrue(const std::string& value) { return IsTrue(value.data(),value.size()); }
@@ -322,97 +328,85 @@ struct String : std::string {
 	// match le "signed char" cas
 	template <typename OutType, typename ...Args>
 	static OutType& Append(OutType& out, signed char value, Args&&... args) {
-		char buffer[8];
-		sprintf(buffer, "%hhd", value);
-		return Append<OutType>((OutType&)out.append(buffer,strlen(buffer)), std::forward<Args>(args)...);
+		char buffer[24];
+		return Append<OutType>((OutType&)out.append(buffer, FromNumber(value < 0 ? (0 - UInt64(value)) : UInt64(value), value < 0, buffer)), std::forward<Args>(args)...);
 	}
 
 	/// \brief match "short" case
 	template <typename OutType, typename ...Args>
 	static OutType& Append(OutType& out, short value, Args&&... args) {
-		char buffer[8];
-		sprintf(buffer, "%hd", value);
-		return Append<OutType>((OutType&)out.append(buffer,strlen(buffer)), std::forward<Args>(args)...);
+		char buffer[24];
+		return Append<OutType>((OutType&)out.append(buffer, FromNumber(value < 0 ? (0 - UInt64(value)) : UInt64(value), value < 0, buffer)), std::forward<Args>(args)...);
 	}
 
 	/// \brief match "int" case
 	template <typename OutType, typename ...Args>
 	static OutType& Append(OutType& out, int value, Args&&... args) {
-		char buffer[16];
-		sprintf(buffer, "%d", value);
-		return Append<OutType>((OutType&)out.append(buffer,strlen(buffer)), std::forward<Args>(args)...);
+		char buffer[24];
+		return Append<OutType>((OutType&)out.append(buffer, FromNumber(value < 0 ? (0 - UInt64(value)) : UInt64(value), value < 0, buffer)), std::forward<Args>(args)...);
 	}
 
 	/// \brief match "long" case
 	template <typename OutType, typename ...Args>
 	static OutType& Append(OutType& out, long value, Args&&... args) {
-		char buffer[32];
-		sprintf(buffer, "%ld", value);
-		return Append<OutType>((OutType&)out.append(buffer,strlen(buffer)), std::forward<Args>(args)...);
+		char buffer[24];
+		return Append<OutType>((OutType&)out.append(buffer, FromNumber(value < 0 ? (0 - UInt64(value)) : UInt64(value), value < 0, buffer)), std::forward<Args>(args)...);
 	}
 
 	/// \brief match "unsigned char" case
 	template <typename OutType, typename ...Args>
 	static OutType& Append(OutType& out, unsigned char value, Args&&... args) {
-		char buffer[8];
-		sprintf(buffer, "%hhu", value);
-		return Append<OutType>((OutType&)out.append(buffer,strlen(buffer)), std::forward<Args>(args)...);
+		char buffer[24];
+		return Append<OutType>((OutType&)out.append(buffer, FromNumber(UInt64(value), false, buffer)), std::forward<Args>(args)...);
 	}
 
 	/// \brief match "unsigned short" case
 	template <typename OutType, typename ...Args>
 	static OutType& Append(OutType& out, unsigned short value, Args&&... args) {
-		char buffer[8];
-		sprintf(buffer, "%hu", value);
-		return Append<OutType>((OutType&)out.append(buffer,strlen(buffer)), std::forward<Args>(args)...);
+		char buffer[24];
+		return Append<OutType>((OutType&)out.append(buffer, FromNumber(UInt64(value), false, buffer)), std::forward<Args>(args)...);
 	}
 
 	/// \brief match "unsigned int" case
 	template <typename OutType, typename ...Args>
 	static OutType& Append(OutType& out, unsigned int value, Args&&... args) {
-		char buffer[16];
-		sprintf(buffer, "%u", value);
-		return Append<OutType>((OutType&)out.append(buffer,strlen(buffer)), std::forward<Args>(args)...);
+		char buffer[24];
+		return Append<OutType>((OutType&)out.append(buffer, FromNumber(UInt64(value), false, buffer)), std::forward<Args>(args)...);
 	}
 
 	/// \brief match "unsigned long" case
 	template <typename OutType, typename ...Args>
 	static OutType& Append(OutType& out, unsigned long value, Args&&... args) {
-		char buffer[32];
-		sprintf(buffer, "%lu", value);
-		return Append<OutType>((OutType&)out.append(buffer,strlen(buffer)), std::forward<Args>(args)...);
+		char buffer[24];
+		return Append<OutType>((OutType&)out.append(buffer, FromNumber(UInt64(value), false, buffer)), std::forward<Args>(args)...);
 	}
 
 	/// \brief match "Int64" case
 	template <typename OutType, typename ...Args>
 	static OutType& Append(OutType& out, long long value, Args&&... args) {
-		char buffer[32];
-		sprintf(buffer, "%lld", value);
-		return Append<OutType>((OutType&)out.append(buffer,strlen(buffer)), std::forward<Args>(args)...);
+		char buffer[24];
+		return Append<OutType>((OutType&)out.append(buffer, FromNumber(value < 0 ? (0 - UInt64(value)) : UInt64(value), value < 0, buffer)), std::forward<Args>(args)...);
 	}
 
 	/// \brief match "UInt64" case
 	template <typename OutType, typename ...Args>
 	static OutType& Append(OutType& out, unsigned long long value, Args&&... args) {
-		char buffer[32];
-		sprintf(buffer, "%llu", value);
-		return Append<OutType>((OutType&)out.append(buffer,strlen(buffer)), std::forward<Args>(args)...);
+		char buffer[24];
+		return Append<OutType>((OutType&)out.append(buffer, FromNumber(UInt64(value), false, buffer)), std::forward<Args>(args)...);
 	}
 
 	/// \brief match "float" case
 	template <typename OutType, typename ...Args>
 	static OutType& Append(OutType& out, float value, Args&&... args) {
 		char buffer[32];
-		sprintf(buffer, "%.8g", value);
-		return Append<OutType>((OutType&)out.append(buffer,strlen(buffer)), std::forward<Args>(args)...);
+		return Append<OutType>((OutType&)out.append(buffer, FromNumber(value, buffer)), std::forward<Args>(args)...);
 	}
 
 	/// \brief match "double" case
 	template <typename OutType, typename ...Args>
 	static OutType& Append(OutType& out, double value, Args&&... args) {
 		char buffer[32];
-		sprintf(buffer, "%.16g", value);
-		return Append<OutType>((OutType&)out.append(buffer,strlen(buffer)), std::forward<Args>(args)...);
+		return Append<OutType>((OutType&)out.append(buffer, FromNumber(value, buffer)), std::forward<Args>(args)...);
 	}
 
 	/// \brief match "bool" case
@@ -498,7 +492,7 @@ struct String : std::string {
 		const Mona::Date* pDate = date.operator->();
 		if(pDate)
 			return Append<OutType>((OutType&)pDate->format(date.format, out), std::forward<Args>(args)...);
-		return Append<OutType>((OutType&)Mona::Date().format(date.format, out), std::forward<Args>(args)...);
+		return Append<OutType>((OutType&)Mona::Date::Format(date.format, Mona::Time::Now(), out), std::forward<Args>(args)...);
 	}
 
 	struct URI : virtual Mona::Object {
@@ -576,16 +570,17 @@ struct String : std::string {
 		return Append<OutType>(out, std::forward<Args>(args)...);
 	}
 	struct Log : virtual Mona::Object {
-		Log(const char* level, const std::string& file, long line, const std::string& message, UInt32 threadId = 0) : threadId(threadId), level(level), file(file), line(line), message(message) {}
+		Log(const char* level, const std::string& file, long line, const std::string& message, UInt32 threadId = 0, Int64 time = 0) : threadId(threadId), time(time), level(level), file(file), line(line), message(message) {}
 		const char*			level;
 		const std::string&	file;
 		const long			line;
 		const std::string&	message;
 		const UInt32		threadId;
+		const Int64			time; // 0 means now
 	};
 	template <typename OutType, typename ...Args>
 	static OutType& Append(OutType& out, const Log& log, Args&&... args) {
-		UInt32 size = Mona::Date().format("%d/%m %H:%M:%S.%c  ", out).size();
+		UInt32 size = Mona::Date::Format("%d/%m %H:%M:%S.%c  ", log.time ? log.time : Mona::Time::Now(), out).size();
 		out.append(7 - (Append<OutType>(out,log.level).size() - size), ' ');
 		if (log.threadId) {
 			Append<OutType>(out, log.threadId);
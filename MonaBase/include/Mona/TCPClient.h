@@ -81,7 +81,7 @@ private:
 	bool				_connected;
 	shared<TLS>			_pTLS;
 	bool				_subscribed;
-	UInt16				_sendingTrack;
+	ThreadPool::Track	_sendingTrack;
 };
 
 
@@ -21,7 +21,12 @@ details (or else see http://mozilla.org/MPL/2.0/).
 #include "Mona/Crypto.h"
 #include "Mona/Socket.h"
 #include <openssl/ssl.h>
+#include <map>
 
+// kTLS requires OpenSSL >= 3.0 built with kernel TLS support
+#if defined(__linux__) && defined(SSL_OP_ENABLE_KTLS) && !defined(OPENSSL_NO_KTLS)
+#define MONA_KTLS
+#endif
 
 namespace Mona {
 
@@ -30,6 +35,27 @@ struct TLS : virtual Object {
 	static bool Create(Exception& ex, const std::string& cert, const std::string& key, shared<TLS>& pTLS, const SSL_METHOD* method = SSLv23_method()) { return Create(ex, cert.c_str(), key.c_str(), pTLS, method); }
 	static bool Create(Exception& ex, const char* cert, const char* key, shared<TLS>& pTLS, const SSL_METHOD* method = SSLv23_method());
 
+	/*!
+	Enable kernel TLS offload: after handshake record encryption moves in kernel if it accepts it (tls module loaded, cipher supported),
+	otherwise socket stays silently on user space encryption, see TLS::Socket::isKTLS. To set before socket creation */
+	bool setKTLS(Exception& ex, bool enable);
+	bool kTLS() const;
+
+	/*!
+	Session resumption, keeps at the most size sessions (0 disables it) during timeout seconds.
+	On server it's the OpenSSL session cache, on client sessions are kept by peer address and server name (SNI) to be resumed on the next connection to them */
+	bool setSessionCache(Exception& ex, UInt32 size, UInt32 timeout = 300);
+	/*!
+	Server session tickets (RFC 5077) encrypted with keys rotated every rotation seconds, a ticket stays valid during two rotations.
+	0 disables tickets, resumption uses then the session cache (TLS 1.3 stateful tickets) */
+	bool setTicketKeysRotation(Exception& ex, UInt32 rotation);
+	/*!
+	Count of resumed handshakes */
+	UInt64 hits() const { return _hits; }
+	/*!
+	Count of full handshakes */
+	UInt64 misses() const { return _misses; }
+
 
 	struct Socket : virtual Object, Mona::Socket {
 		// http://fm4dd.com/openssl/sslconnect.htm
@@ -42,6 +68,13 @@ struct TLS : virtual Object {
 		const shared<TLS>	pTLS;
 
 		bool  isSecure() const { return pTLS ? true : false; }
+		/*!
+		True when kernel encrypts sendings (handshake done with TLS::setKTLS enabled), allows zero-copy Socket::writeFile */
+		bool  isKTLS() const;
+		/*!
+		Host name sent by connect in the client hello (SNI), part of the client session key too, to set before connect */
+		void				setServerName(const std::string& name) { _serverName = name; }
+		const std::string&	serverName() const { return _serverName; }
 
 		UInt32  available() const;
 	
@@ -54,8 +87,16 @@ struct TLS : virtual Object {
 		int	 receive(Exception& ex, void* buffer, UInt32 size, int flags, SocketAddress* pAddress);
 		bool flush(Exception& ex, bool deleting);
 		bool close(Socket::ShutdownType type = SHUTDOWN_BOTH);
+#if defined(__linux__)
+		int	 sendFile(Exception& ex, int handle, UInt64 offset, UInt32 size);
+#endif
 
 		Mona::Socket* newSocket(Exception& ex, NET_SOCKET sockfd, const sockaddr& addr);
+		bool		  newSSL(Exception& ex);
+
+		static void	InfoCallback(const SSL* ssl, int where, int ret);
+		static int	NewSessionCallback(SSL* ssl, SSL_SESSION* pSession);
+		friend struct TLS;
 
 		// Create a socket from Socket::accept
 		Socket(NET_SOCKET sockfd, const sockaddr& addr, const shared<TLS>& pTLS);
@@ -96,14 +137,41 @@ struct TLS : virtual Object {
 
 		ssl_st*				_ssl;
 		mutable std::mutex	_mutex;
+		bool				_handshaked;
+		std::string			_serverName;
 	};
 
 
-	~TLS() { SSL_CTX_free(_pCTX); }
+	~TLS();
 private:
-	TLS(SSL_CTX* pCTX) : _pCTX(pCTX) {}
-	
-	SSL_CTX*  _pCTX;
+	TLS(SSL_CTX* pCTX);
+
+	struct TicketKey {
+		UInt8 name[16];
+		UInt8 aes[32];
+		UInt8 hmac[32];
+	};
+	/*!
+	Returns 0 if key is unfound, 1 if found, 2 if found but ticket has to be renewed (previous key) */
+	int ticketKey(UInt8* name, bool encrypting, TicketKey& key);
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+	static int TicketKeyCallback(SSL* ssl, unsigned char* name, unsigned char* iv, EVP_CIPHER_CTX* pCipher, EVP_MAC_CTX* pMAC, int enc);
+#else
+	static int TicketKeyCallback(SSL* ssl, unsigned char* name, unsigned char* iv, EVP_CIPHER_CTX* pCipher, HMAC_CTX* pMAC, int enc);
+#endif
+
+	SSL_CTX*							_pCTX;
+	std::atomic<UInt64>					_hits;
+	std::atomic<UInt64>					_misses;
+
+	std::mutex							_mutex;
+	// client sessions
+	std::map<std::pair<SocketAddress, std::string>, SSL_SESSION*>	_sessions; // by peer address and server name
+	UInt32								_sessionsSize;
+	// server ticket keys
+	TicketKey							_ticketKeys[2]; // current and previous
+	Int64								_ticketKeysTime;
+	UInt32								_ticketKeysRotation;
 };
 
 
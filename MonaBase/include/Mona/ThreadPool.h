@@ -22,7 +22,30 @@ details (or else see http://mozilla.org/MPL/2.0/).
 
 namespace Mona {
 
+/*!
+Pool of ThreadQueue, runners queued with the same Track run sequentially in queue order,
+runners queued without track (nullptr) can be stolen by idle threads */
 struct ThreadPool : virtual Object {
+	/*!
+	Affinity of runners which have to keep their order (socket reception, file I/O, sender, etc.),
+	a track without pending runner can move to a less loaded thread */
+	struct Track : virtual Object {
+		Track() : _pState(SET, 0) {} // state created here and not on first queue, to allow concurrent producers
+		/*!
+		Index+1 of thread used, 0 if none */
+		UInt16	thread() const { return UInt16(*_pState >> 32); }
+		/*!
+		Count of runners queued and not yet finished */
+		UInt32	pending() const { return UInt32(*_pState); }
+		/*!
+		New track (for a new sequence, like a new socket), no more ordered with runners queued before,
+		can't be called during a queue call with this track */
+		void	reset() { _pState.set(0); }
+	private:
+		friend struct ThreadPool;
+		shared<std::atomic<UInt64>>		_pState; // thread << 32 | pending, shared with runners queued
+	};
+
 	ThreadPool(UInt16 threads = 0) : _current(0) { init(threads); }
 	ThreadPool(Thread::Priority priority, UInt16 threads = 0) : _current(0) { init(threads, priority); }
 
@@ -31,24 +54,33 @@ struct ThreadPool : virtual Object {
 	UInt16	join();
 
 	template<typename RunnerType>
-	void queue(UInt16& thread, RunnerType&& pRunner) const {
-		if (thread)
-			return _threads[thread - 1]->queue(std::forward<RunnerType>(pRunner));
-		_threads[thread = (_current++%_size)]->queue(std::forward<RunnerType>(pRunner));
-		++thread;
+	void queue(Track& track, RunnerType&& pRunner) const {
+		UInt64 state(*track._pState);
+		UInt16 thread;
+		do {
+			thread = UInt16(state >> 32);
+			// nothing pending => track can move on the less loaded thread (current thread kept on equality)
+			if (!thread || !UInt32(state))
+				thread = lessLoaded(thread);
+		} while (!track._pState->compare_exchange_weak(state, (UInt64(thread) << 32) | (UInt32(state) + 1)));
+		_threads[thread - 1]->push(ThreadQueue::Job(std::forward<RunnerType>(pRunner), track._pState));
 	}
 	template<typename RunnerType>
-	void queue(std::nullptr_t, RunnerType&& pRunner) const { UInt16 thread(0); queue<RunnerType>(thread, std::forward<RunnerType>(pRunner)); }
+	void queue(std::nullptr_t, RunnerType&& pRunner) const { _threads[lessLoaded() - 1]->queueStealable(shared<Runner>(std::forward<RunnerType>(pRunner))); }
 	template <typename RunnerType, typename ...Args>
-	void queue(UInt16& thread, Args&&... args) const { queue(thread, std::make_shared<RunnerType>(std::forward<Args>(args)...)); }
+	void queue(Track& track, Args&&... args) const { queue(track, std::make_shared<RunnerType>(std::forward<Args>(args)...)); }
 	template <typename RunnerType, typename ...Args>
-	void queue(std::nullptr_t, Args&&... args) const { UInt16 thread(0); queue<RunnerType>(thread, std::forward<Args>(args)...); }
+	void queue(std::nullptr_t, Args&&... args) const { queue(nullptr, std::make_shared<RunnerType>(std::forward<Args>(args)...)); }
 private:
-	void init(UInt16 threads, Thread::Priority priority = Thread::PRIORITY_NORMAL);
+	friend struct ThreadQueue;
+	void	init(UInt16 threads, Thread::Priority priority = Thread::PRIORITY_NORMAL);
+	/*!
+	Returns index+1 of the thread with the less pending runners, preferred is kept on equality */
+	UInt16	lessLoaded(UInt16 preferred = 0) const;
 
-	mutable std::vector<unique<ThreadQueue>>	_threads;
-	mutable std::atomic<UInt16>					_current;
-	UInt16										_size;
+	std::vector<unique<ThreadQueue>>	_threads;
+	mutable std::atomic<UInt16>			_current;
+	UInt16								_size;
 };
 
 
@@ -19,32 +19,61 @@ details (or else see http://mozilla.org/MPL/2.0/).
 #include "Mona/Mona.h"
 #include "Mona/Thread.h"
 #include "Mona/Runner.h"
+#include "Mona/MPSCQueue.h"
 #include <deque>
 
 namespace Mona {
 
+struct ThreadPool;
+
 struct ThreadQueue : Thread, virtual Object {
-	ThreadQueue(Priority priority = PRIORITY_NORMAL) : Thread("ThreadQueue"), _priority(priority) {}
+	ThreadQueue(Priority priority = PRIORITY_NORMAL) : ThreadQueue(NULL, priority) {}
 	virtual ~ThreadQueue() { stop(); }
 
 	static ThreadQueue*	Current() { return _PCurrent; }
 
+	/*!
+	Count of runners queued and not yet finished (load indicator) */
+	UInt32 pending() const { return _pending; }
+
 	template<typename RunnerType>
-	void queue(RunnerType&& pRunner) {
-		FATAL_CHECK(pRunner); // more easy to debug that if it fails in the thread!
-		std::lock_guard<std::mutex> lock(_mutex);
-		start(_priority);
-		_runners.emplace_back(std::forward<RunnerType>(pRunner));
-		wakeUp.set();
-	}
+	void queue(RunnerType&& pRunner) { push(Job(std::forward<RunnerType>(pRunner))); }
 	template <typename RunnerType, typename ...Args>
 	void queue(Args&&... args) { queue(std::make_shared<RunnerType>(std::forward<Args>(args)...)); }
 
 private:
-	bool run(Exception& ex, const volatile bool& requestStop);
+	friend struct ThreadPool;
+	ThreadQueue(const ThreadPool* pPool, Priority priority) : Thread("ThreadQueue"), _pPool(pPool), _priority(priority), _pending(0), _stealablesCount(0), _awake(false) {}
+
+	struct Job {
+		Job() {}
+		template<typename RunnerType>
+		Job(RunnerType&& pRunner, const shared<std::atomic<UInt64>>& pTrack = nullptr) : pRunner(std::forward<RunnerType>(pRunner)), pTrack(pTrack) {}
+		shared<Runner>				pRunner;
+		shared<std::atomic<UInt64>>	pTrack; // state of its ThreadPool::Track (pending runners count in low part)
+	};
+
+	void	push(Job&& job);
+	/*!
+	Queue a runner without order requirement, other threads of the pool can steal it */
+	void	queueStealable(shared<Runner>&& pRunner);
+
+	bool	run(Exception& ex, const volatile bool& requestStop);
+	void	run(Job& job);
+	UInt32	flush();
+	/*!
+	Run a stealable runner of an other thread of the pool, returns false if nothing to steal */
+	bool	steal();
+	void	wake();
 
-	std::deque<shared<Runner>>			_runners;
+	MPSCQueue<Job>						_runners;
+	std::deque<shared<Runner>>			_stealables;
+	std::atomic<UInt32>					_stealablesCount; // to check stealables without lock
+	std::mutex							_mutexStealables;
+	std::atomic<UInt32>					_pending;
+	std::atomic<bool>					_awake; // thread started and not sleeping, the producer which changes it starts the thread
 	std::mutex							_mutex;
+	const ThreadPool*					_pPool;
 	static thread_local ThreadQueue*	_PCurrent;
 	Priority							_priority;
 };
@@ -19,14 +19,14 @@ details (or else see http://mozilla.org/MPL/2.0/).
 #include "Mona/Mona.h"
 #include "Mona/Time.h"
 #include "Mona/Exceptions.h"
-#include <set>
-#include <map>
 
 namespace Mona {
 
-
+/*!
+Hierarchical timing wheel (4 wheels of 256 slots with a 1ms resolution, the last one covers 49 days),
+set/remove/reschedule are O(1) and don't allocate: timers are linked directly in their slot */
 struct Timer : virtual Object {
-	Timer() : _count(0) {}
+	Timer();
 	~Timer();
 
 /*!
@@ -35,10 +35,10 @@ struct Timer : virtual Object {
 	struct OnTimer : std::function<UInt32(UInt32 delay)>, virtual Object {
 		NULLABLE
 
-		OnTimer() : _nextRaising(0), count(0) {}
+		OnTimer() : _nextRaising(0), count(0), _pTimer(NULL), _pPrev(NULL), _pNext(NULL), _slot(0) {}
 		// explicit to forbid to pass in "const OnTimer" parameter directly a lambda function
 		template<typename FunctionType>
-		explicit OnTimer(FunctionType&& function) : _nextRaising(0), count(0), std::function<UInt32(UInt32)>(std::move(function)) {}
+		explicit OnTimer(FunctionType&& function) : _nextRaising(0), count(0), _pTimer(NULL), _pPrev(NULL), _pNext(NULL), _slot(0), std::function<UInt32(UInt32)>(std::move(function)) {}
 
 		~OnTimer() { if (_nextRaising) FATAL_ERROR("OnTimer function deleting while running"); }
 
@@ -57,7 +57,11 @@ struct Timer : virtual Object {
 
 		const UInt32 count;
 	private:
-		mutable Time	_nextRaising;
+		mutable Time			_nextRaising;
+		mutable const Timer*	_pTimer;
+		mutable const OnTimer*	_pPrev;
+		mutable const OnTimer*	_pNext;
+		mutable UInt16			_slot;
 
 		friend struct Timer;
 	};
@@ -74,11 +78,24 @@ struct Timer : virtual Object {
 	UInt32 raise();
 
 private:
-	void add(const OnTimer& onTimer,  UInt32 timeout) const;
-	bool remove(const OnTimer& onTimer, shared<std::set<const OnTimer*>>& pMove) const;
+	enum {
+		WHEELS = 4,
+		BITS = 8, // 256 slots by wheel
+		SLOTS = 1 << BITS,
+		RAISING = WHEELS * SLOTS // slot of timers in raising
+	};
 
-	mutable	UInt32												_count;
-	mutable std::map<Int64, shared<std::set<const OnTimer*>>>	_timers;
+	void add(const OnTimer& onTimer, UInt32 timeout) const;
+	void link(const OnTimer& onTimer) const;
+	void link(const OnTimer& onTimer, UInt16 slot) const;
+	void unlink(const OnTimer& onTimer) const;
+	void cascade(UInt8 wheel) const;
+	Int64 next() const;
+
+	mutable	UInt32			_count;
+	mutable Int64			_time; // next time to raise, every previous slot are already raised
+	mutable const OnTimer*	_slots[RAISING + 1];
+	mutable UInt64			_used[WHEELS][SLOTS / 64]; // bitmap of not empty slots
 };
 
 
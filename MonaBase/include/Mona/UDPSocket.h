@@ -72,7 +72,7 @@ private:
 
 	shared<Socket>		_pSocket;
 	bool				_subscribed;
-	UInt16				_sendingTrack;
+	ThreadPool::Track	_sendingTrack;
 };
 
 
@@ -125,6 +125,8 @@ bool Application::init(int argc, const char* argv[]) {
 		if (!Logs::AddLogger<FileLogger>(String("file!", name(), " already running?"), logDir, sizeByFile, rotation))
 			FATAL_ERROR(name(), " initLogs can't override file logger");
 	}
+	// asynchronous logs: logs.async is the count of logs by thread ring (0 for synchronous logs), logs.asyncBlock=false drops logs on overflow rather than waiting
+	Logs::SetAsynchronous(getNumber<UInt32, 1024>("logs.async"), getBoolean<true>("logs.asyncBlock"));
 
 	// 4 - first logs
 	if (_version)
@@ -219,6 +221,8 @@ void Application::onParamChange(const string& key, const string* pValue) {
 			Net::ResetSendBufferSize();
 
 		DEBUG("Defaut socket buffers set to ", Net::GetRecvBufferSize(), "B in reception and ", Net::GetSendBufferSize(), "B in sends");
+	} else if (String::ICompare(key, "net.ioUring") == 0) {
+		Net::SetIOUring(getBoolean<false>("net.ioUring"));
 	} else if (String::ICompare(key, "logs.level") == 0) {
 		UInt8 level = getNumber<UInt8, LOG_DEFAULT>("arguments.log");
 		if (pValue)
@@ -232,6 +236,7 @@ void Application::onParamClear() {
 	Logs::SetLevel(getNumber<UInt8, LOG_DEFAULT>("arguments.log"));
 	Net::ResetRecvBufferSize();
 	Net::ResetSendBufferSize();
+	Net::SetIOUring(false);
 	Parameters::onParamClear();
 }
 
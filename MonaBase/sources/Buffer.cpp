@@ -22,8 +22,47 @@ using namespace std;
 namespace Mona {
 
 atomic_flag Buffer::Allocator::_Mutex = ATOMIC_FLAG_INIT;
+atomic<bool> Buffer::Allocator::_Locked(false);
 unique<Buffer::Allocator>	Buffer::Allocator::_PAllocator(SET);
 
+// Alloc/Free calls in progress, counted by stripe (one cache line by stripe) to not share a write between threads
+static struct alignas(64) { atomic<UInt32> count; } _Users[16];
+
+static atomic<UInt32>& Users() {
+	static atomic<UInt8> Stripe(0);
+	static thread_local atomic<UInt32>& Users(_Users[Stripe++ & 15].count);
+	return Users;
+}
+
+Buffer::Allocator::Tag* Buffer::Allocator::Tag::_PFirst(NULL);
+
+Buffer::Allocator::Tag::Tag(const char* name) : name(name), _count(0), _bytes(0), _pNext(_PFirst) {
+	_PFirst = this; // static declaration => registered on library loading
+}
+
+Buffer::Allocator::Tag*& Buffer::Allocator::Tag::Current() {
+	static thread_local Tag* PCurrent(NULL);
+	return PCurrent;
+}
+
+void Buffer::Allocator::Lock() {
+	while (_Mutex.test_and_set(std::memory_order_acquire))
+		this_thread::yield();
+	_Locked = true;
+	for (auto& users : _Users) {
+		while (users.count)
+			this_thread::yield();
+	}
+}
+
+void Buffer::Allocator::Statistics(vector<Stats>& stats) {
+	atomic<UInt32>& users(Users());
+	++users;
+	if (!_Locked)
+		_PAllocator->statistics(stats);
+	--users;
+}
+
 UInt32 Buffer::Allocator::ComputeCapacity(UInt32 size) {
 	if (size <= 16) // at minimum allocate 16 bytes!
 		return 16;
@@ -38,17 +77,29 @@ UInt32 Buffer::Allocator::ComputeCapacity(UInt32 size) {
 }
 UInt8* Buffer::Allocator::Alloc(UInt32& size) {
 	size = ComputeCapacity(size);
-	if (size>0x80000000 || !TryLock())
+	Tag* pTag = Tag::Current();
+	if (pTag) {
+		pTag->_count.fetch_add(1, memory_order_relaxed);
+		pTag->_bytes.fetch_add(size, memory_order_relaxed);
+	}
+	if (size>0x80000000)
 		return new UInt8[size];
-	UInt8* buffer = _PAllocator->alloc(size);
-	Unlock();
+	atomic<UInt32>& users(Users());
+	++users; // before to check _Locked, Lock() sets _Locked before to check users (seq_cst)
+	UInt8* buffer = _Locked ? new UInt8[size] : _PAllocator->alloc(size);
+	--users;
 	return buffer;
 }
 void Buffer::Allocator::Free(UInt8* buffer, UInt32 size) {
-	if ((!size || (size & (size - 1))) || !TryLock())  // check than we have a size create with Alloc (capacity log2) + TryLock working!
+	if (!size || (size & (size - 1)))  // check than we have a size create with Alloc (capacity log2)
 		return delete[] buffer;
-	_PAllocator->free(buffer, size);
-	Unlock();
+	atomic<UInt32>& users(Users());
+	++users;
+	if (_Locked)
+		delete[] buffer;
+	else
+		_PAllocator->free(buffer, size);
+	--users;
 }
 
 static UInt8 _Empty;
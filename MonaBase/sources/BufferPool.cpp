@@ -22,6 +22,139 @@ using namespace std;
 
 namespace Mona {
 
+static atomic<UInt32> _Ids(0);
+
+BufferPool::BufferPool() : Thread("BufferPool"), _id(++_Ids) {
+	start(Thread::PRIORITY_LOWEST);
+}
+
+BufferPool::~BufferPool() {
+	stop();
+	// allocator is locked here, no more alloc/free in progress
+	for (const shared<Magazines>& pMagazines : _magazines) {
+		for (UInt8 index = 0; index < CLASSES; ++index) {
+			for (UInt8 i = 0; i < pMagazines->sizes[index]; ++i)
+				delete[] pMagazines->buffers[index][i];
+			pMagazines->sizes[index] = 0;
+		}
+	}
+}
+
+BufferPool::Magazines& BufferPool::magazines() {
+	static thread_local struct Cache : virtual Object {
+		Cache() : id(0) {}
+		~Cache() { if (pMagazines) pMagazines->orphan = true; }
+		UInt32				id;
+		shared<Magazines>	pMagazines;
+	} Cache;
+	if (Cache.id != _id) {
+		// first call of this thread on this pool
+		if (Cache.pMagazines)
+			Cache.pMagazines->orphan = true; // magazines of a previous pool
+		Cache.pMagazines.set();
+		Cache.id = _id;
+		lock_guard<mutex> lock(_mutex);
+		_magazines.emplace_back(Cache.pMagazines);
+	}
+	return *Cache.pMagazines;
+}
+
+void BufferPool::spill(Magazines& magazines) {
+	magazines.trim = false;
+	for (UInt8 index = 0; index < CLASSES; ++index) {
+		UInt8& size = magazines.sizes[index];
+		if (!size)
+			continue;
+		lock_guard<mutex> lock(_buffers[index].mutex);
+		_buffers[index].push(magazines.buffers[index], size);
+		size = 0;
+	}
+}
+
+void BufferPool::statistics(vector<Stats>& stats) {
+	lock_guard<mutex> lock(_mutex);
+	for (UInt32 capacity = 16; capacity && capacity <= 0x80000000; capacity <<= 1) {
+		UInt8 index = computeIndex(capacity);
+		Stats stat(capacity);
+		stat.hits = _counters[index].hits;
+		stat.misses = _counters[index].misses;
+		stat.frees = _counters[index].frees;
+		stat.collected = _counters[index].collected;
+		for (const shared<Magazines>& pMagazines : _magazines) {
+			const Counters& counters = pMagazines->counters[index];
+			stat.hits += counters.hits;
+			stat.misses += counters.misses;
+			stat.frees += counters.frees;
+		}
+		if (stat.hits || stat.misses || stat.frees)
+			stats.emplace_back(stat);
+	}
+}
+
+UInt8* BufferPool::alloc(UInt32& capacity) {
+	UInt8 index = computeIndex(capacity);
+	Buffers& buffers = _buffers[index];
+	UInt8 limit = MagazineSize(capacity);
+	Magazines& magazines = this->magazines();
+	Counters& counters = magazines.counters[index];
+	if (!limit) {
+		// big buffer, directly in depot
+		UInt8* buffer;
+		{
+			lock_guard<mutex> lock(buffers.mutex);
+			buffer = buffers.pop();
+		}
+		if (buffer) {
+			Counters::Increment(counters.hits);
+			return buffer;
+		}
+		Counters::Increment(counters.misses);
+		return new UInt8[capacity];
+	}
+	if (magazines.trim)
+		spill(magazines);
+	UInt8& size = magazines.sizes[index];
+	if (!size) {
+		// refill half of magazine
+		{
+			lock_guard<mutex> lock(buffers.mutex);
+			size = buffers.pop(magazines.buffers[index], (limit + 1) / 2);
+		}
+		if (!size) {
+			Counters::Increment(counters.misses);
+			return new UInt8[capacity];
+		}
+	}
+	Counters::Increment(counters.hits);
+	return magazines.buffers[index][--size];
+}
+
+void BufferPool::free(UInt8* buffer, UInt32 capacity) {
+	UInt8 index = computeIndex(capacity);
+	Buffers& buffers = _buffers[index];
+	UInt8 limit = MagazineSize(capacity);
+	Magazines& magazines = this->magazines();
+	Counters::Increment(magazines.counters[index].frees);
+	if (!limit) {
+		lock_guard<mutex> lock(buffers.mutex);
+		return buffers.push(buffer);
+	}
+	if (magazines.trim)
+		spill(magazines);
+	UInt8& size = magazines.sizes[index];
+	UInt8** magazine = magazines.buffers[index];
+	if (size == limit) {
+		// full, spill the oldest half of magazine
+		UInt8 count = (limit + 1) / 2;
+		{
+			lock_guard<mutex> lock(buffers.mutex);
+			buffers.push(magazine, count);
+		}
+		memmove(magazine, magazine + count, (size -= count) * sizeof(UInt8*));
+	}
+	magazine[size++] = buffer;
+}
+
 UInt8* BufferPool::Buffers::pop() {
 	if (empty())
 		return NULL;
@@ -36,6 +169,20 @@ void BufferPool::Buffers::push(UInt8* buffer) {
 	if (size() > _maxSize)
 		_maxSize = size();
 }
+UInt8 BufferPool::Buffers::pop(UInt8** buffers, UInt8 count) {
+	if (count > size())
+		count = UInt8(size());
+	memcpy(buffers, data() + size() - count, count * sizeof(UInt8*));
+	resize(size() - count);
+	if (size() < _minSize)
+		_minSize = size();
+	return count;
+}
+void BufferPool::Buffers::push(UInt8** buffers, UInt8 count) {
+	insert(end(), buffers, buffers + count);
+	if (size() > _maxSize)
+		_maxSize = size();
+}
 void BufferPool::Buffers::manage(vector<UInt8*>& gc) {
 	// pickUp
 	UInt32 position = gc.size();
@@ -55,13 +202,34 @@ bool BufferPool::run(Exception& ex, const volatile bool& requestStop) {
 		if (timeout && wakeUp.wait(timeout)) // wait()==true means requestStop=true because there is no other wakeUp.set elsewhere
 			return true;
 		Time time;
-		for (Buffers& buffers : _buffers) {
+		{
+			// recover magazines of ended threads, and ask to the others to spill their buffers to be collected if unused
+			lock_guard<mutex> lock(_mutex);
+			auto it = _magazines.begin();
+			while (it != _magazines.end()) {
+				if ((*it)->orphan) {
+					spill(**it);
+					for (UInt8 index = 0; index < CLASSES; ++index) {
+						Counters& counters = (*it)->counters[index];
+						Counters::Increment(_counters[index].hits, counters.hits);
+						Counters::Increment(_counters[index].misses, counters.misses);
+						Counters::Increment(_counters[index].frees, counters.frees);
+					}
+					it = _magazines.erase(it);
+					continue;
+				}
+				(*it++)->trim = true;
+			}
+		}
+		for (UInt8 index = 0; index < CLASSES; ++index) {
 			vector<UInt8*> gc;
-			Lock();
-			buffers.manage(gc); // garbage collector!
-			Unlock();
+			{
+				lock_guard<mutex> lock(_buffers[index].mutex);
+				_buffers[index].manage(gc); // garbage collector!
+			}
 			for (UInt8* buffer : gc)
 				delete[] buffer;
+			Counters::Increment(_counters[index].collected, gc.size());
 		}
 		timeout = (UInt16)max(10000 - time.elapsed(), 0);
 	}
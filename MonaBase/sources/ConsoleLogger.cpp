@@ -65,14 +65,36 @@ ConsoleLogger::ConsoleLogger() {
 }
 
 bool ConsoleLogger::log(LOG_LEVEL level, const Path& file, long line, const string& message) {
+#if defined(_WIN32)
+	// color is a console attribute, can't be buffered
 	BEGIN_CONSOLE_TEXT_COLOR(LevelColors[level - 1]);
 	printf("%s[%ld] %s", file.name().c_str(), line, message.c_str());
 	END_CONSOLE_TEXT_COLOR;
-	printf("\n"); // flush after color change, required especially over unix/linux
+	printf("\n");
+#else
+	// end of line after color change, required especially over unix/linux
+	String::Append(_buffer, LevelColors[level - 1], file.name(), '[', line, "] ", message, LevelColors[6], '\n');
+#endif
+	return true;
+}
+
+bool ConsoleLogger::flush() {
+#if !defined(_WIN32)
+	if (_buffer.empty())
+		return true;
+	fwrite(_buffer.data(), sizeof(char), _buffer.size(), stdout);
+	if (_buffer.capacity() > 0xFFFF) {
+		_buffer.clear();
+		_buffer.shrink_to_fit();
+	} else
+		_buffer.clear();
+#endif
+	fflush(stdout);
 	return true;
 }
 
 bool ConsoleLogger::dump(const string& header, const UInt8* data, UInt32 size) {
+	flush();
 	if(!header.empty())
 		printf("%.*s\n", (int)header.size(), header.c_str());
 	fwrite(data, sizeof(char), size, stdout);
@@ -15,6 +15,25 @@ details (or else see http://mozilla.org/MPL/2.0/).
 */
 
 #include "Mona/Crypto.h"
+#if defined(_M_X64) || defined(__x86_64__) || ((defined(_M_IX86) || defined(__i386__)) && defined(__SSE2__))
+	#define CRYPTO_SSE
+	#include <emmintrin.h>
+	#include <tmmintrin.h>
+	#include <wmmintrin.h>
+	#include <immintrin.h>
+	#if defined(_MSC_VER)
+		#include <intrin.h>
+	#else
+		#include <cpuid.h>
+	#endif
+#else
+	#if defined(__ARM_FEATURE_CRC32)
+		#include <arm_acle.h>
+	#endif
+	#if defined(__ARM_NEON)
+		#include <arm_neon.h>
+	#endif
+#endif
 
 using namespace std;
 
@@ -109,62 +128,274 @@ UInt16 Crypto::ComputeChecksum(BinaryReader& reader) {
 }
 
 
+/*!
+CRC32/MPEG-2 (polynomial 0x04C11DB7, MSB first, no final xor) tables for slice-by-8: normal form,
+and reflected form (polynomial 0xEDB88320, LSB first) which gives the CRC of bit-rotated input bytes in one pass */
+static const struct CRC32Tables {
+	CRC32Tables() {
+		for (UInt32 i = 0; i < 256; ++i) {
+			UInt32 crc(i << 24), reflected(i);
+			for (UInt8 bit = 0; bit < 8; ++bit) {
+				crc = (crc & 0x80000000) ? ((crc << 1) ^ 0x04C11DB7) : (crc << 1);
+				reflected = (reflected & 1) ? ((reflected >> 1) ^ 0xEDB88320) : (reflected >> 1);
+			}
+			normal[0][i] = crc;
+			this->reflected[0][i] = reflected;
+		}
+		for (UInt8 k = 1; k < 8; ++k) {
+			for (UInt32 i = 0; i < 256; ++i) {
+				normal[k][i] = (normal[k - 1][i] << 8) ^ normal[0][normal[k - 1][i] >> 24];
+				reflected[k][i] = (reflected[k - 1][i] >> 8) ^ reflected[0][reflected[k - 1][i] & 0xFF];
+			}
+		}
+	}
+	UInt32 normal[8][256];
+	UInt32 reflected[8][256];
+} _CRC32;
+
+static UInt32 CRC32(UInt32 crc, const UInt8* data, UInt32 size) {
+	for (; size >= 8; size -= 8, data += 8) {
+		UInt32 high = crc ^ ((data[0] << 24) | (data[1] << 16) | (data[2] << 8) | data[3]);
+		UInt32 low = (data[4] << 24) | (data[5] << 16) | (data[6] << 8) | data[7];
+		crc = _CRC32.normal[7][high >> 24] ^ _CRC32.normal[6][(high >> 16) & 0xFF] ^ _CRC32.normal[5][(high >> 8) & 0xFF] ^ _CRC32.normal[4][high & 0xFF] ^
+			  _CRC32.normal[3][low >> 24] ^ _CRC32.normal[2][(low >> 16) & 0xFF] ^ _CRC32.normal[1][(low >> 8) & 0xFF] ^ _CRC32.normal[0][low & 0xFF];
+	}
+	while (size--)
+		crc = (crc << 8) ^ _CRC32.normal[0][(crc >> 24) ^ *data++];
+	return crc;
+}
+
+static UInt32 ReflectedCRC32(UInt32 crc, const UInt8* data, UInt32 size) {
+#if defined(__ARM_FEATURE_CRC32)
+	// ARMv8 CRC32 instructions compute the reflected form
+	for (; size >= 8; size -= 8, data += 8) {
+		UInt64 value;
+		memcpy(&value, data, 8);
+		crc = __crc32d(crc, Byte::From64LittleEndian(value));
+	}
+	while (size--)
+		crc = __crc32b(crc, *data++);
+	return crc;
+#else
+	for (; size >= 8; size -= 8, data += 8) {
+		UInt32 low = crc ^ (data[0] | (data[1] << 8) | (data[2] << 16) | (data[3] << 24));
+		UInt32 high = data[4] | (data[5] << 8) | (data[6] << 16) | (data[7] << 24);
+		crc = _CRC32.reflected[7][low & 0xFF] ^ _CRC32.reflected[6][(low >> 8) & 0xFF] ^ _CRC32.reflected[5][(low >> 16) & 0xFF] ^ _CRC32.reflected[4][low >> 24] ^
+			  _CRC32.reflected[3][high & 0xFF] ^ _CRC32.reflected[2][(high >> 8) & 0xFF] ^ _CRC32.reflected[1][(high >> 16) & 0xFF] ^ _CRC32.reflected[0][high >> 24];
+	}
+	while (size--)
+		crc = (crc >> 8) ^ _CRC32.reflected[0][(crc ^ *data++) & 0xFF];
+	return crc;
+#endif
+}
+
+#if defined(CRYPTO_SSE)
+/*!
+Folding with carry-less multiplication (PCLMULQDQ) of 16 bytes blocks in normal form, on 4 lanes of 64 bytes then on 1 lane,
+the last 128 bits are congruent to data modulo polynomial and are given to the table computation.
+If rotate, bits of every byte are rotated on loading (ROTATE_INPUT). Consumes a multiple of 16 bytes, size has to be >= 64 */
+static const struct CRC32Folding {
+	CRC32Folding() : supported(false) {
+		// constants x^n mod P to fold a 128 bits block of n bits further: (x^(n+64) mod P, x^n mod P)
+		for (UInt8 i = 0; i < 4; ++i)
+			keys[i] = _mm_set_epi64x(XPowMod((i + 1) * 128 + 64), XPowMod((i + 1) * 128));
+#if defined(_MSC_VER)
+		int info[4];
+		__cpuid(info, 1);
+		UInt32 ecx(info[2]);
+#else
+		UInt32 eax, ebx, ecx, edx;
+		if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx))
+			return;
+#endif
+		supported = (ecx & (1 << 1)) && (ecx & (1 << 9)); // PCLMULQDQ and SSSE3
+	}
+	bool	supported;
+	__m128i	keys[4]; // fold by 128, 256, 384 and 512 bits
+private:
+	static UInt64 XPowMod(UInt32 n) {
+		UInt32 value(1);
+		while (n--)
+			value = (value & 0x80000000) ? ((value << 1) ^ 0x04C11DB7) : (value << 1);
+		return value;
+	}
+} _CRC32Folding;
+
+#if !defined(_MSC_VER)
+__attribute__((target("pclmul,ssse3")))
+#endif
+static __m128i Fold(__m128i value, __m128i key) {
+	return _mm_xor_si128(_mm_clmulepi64_si128(value, key, 0x11), _mm_clmulepi64_si128(value, key, 0x00));
+}
+
+#if !defined(_MSC_VER)
+__attribute__((target("pclmul,ssse3")))
+#endif
+static __m128i Load(const UInt8* data, bool rotate) {
+	// 128 bits integer whose the bit 127 is the first bit of data (byte order reversed)
+	__m128i value = _mm_loadu_si128((const __m128i*)data);
+	if (rotate) { // rotated byte = rotated low nibble << 4 | rotated high nibble
+		const __m128i nibbles = _mm_set1_epi8(0x0F);
+		const __m128i rotations = _mm_set_epi8(15, 7, 11, 3, 13, 5, 9, 1, 14, 6, 10, 2, 12, 4, 8, 0);
+		value = _mm_or_si128(_mm_slli_epi16(_mm_shuffle_epi8(rotations, _mm_and_si128(value, nibbles)), 4), _mm_shuffle_epi8(rotations, _mm_and_si128(_mm_srli_epi16(value, 4), nibbles)));
+	}
+	return _mm_shuffle_epi8(value, _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15));
+}
+
+#if !defined(_MSC_VER)
+__attribute__((target("pclmul,ssse3")))
+#endif
+static UInt32 FoldCRC32(UInt32 crc, const UInt8*& data, UInt32& size, bool rotate) {
+	// initial crc is xored on the first 32 bits
+	__m128i x0 = _mm_xor_si128(Load(data, rotate), _mm_set_epi32(crc, 0, 0, 0));
+	__m128i x1 = Load(data + 16, rotate), x2 = Load(data + 32, rotate), x3 = Load(data + 48, rotate);
+	for (data += 64, size -= 64; size >= 64; data += 64, size -= 64) {
+		x0 = _mm_xor_si128(Fold(x0, _CRC32Folding.keys[3]), Load(data, rotate));
+		x1 = _mm_xor_si128(Fold(x1, _CRC32Folding.keys[3]), Load(data + 16, rotate));
+		x2 = _mm_xor_si128(Fold(x2, _CRC32Folding.keys[3]), Load(data + 32, rotate));
+		x3 = _mm_xor_si128(Fold(x3, _CRC32Folding.keys[3]), Load(data + 48, rotate));
+	}
+	x0 = _mm_xor_si128(_mm_xor_si128(Fold(x0, _CRC32Folding.keys[2]), Fold(x1, _CRC32Folding.keys[1])), _mm_xor_si128(Fold(x2, _CRC32Folding.keys[0]), x3));
+	for (; size >= 16; data += 16, size -= 16)
+		x0 = _mm_xor_si128(Fold(x0, _CRC32Folding.keys[0]), Load(data, rotate));
+	UInt8 remainder[16];
+	_mm_storeu_si128((__m128i*)remainder, _mm_shuffle_epi8(x0, _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15)));
+	return CRC32(0, remainder, sizeof(remainder));
+}
+#endif
+
 UInt32 Crypto::ComputeCRC32(const UInt8* data, UInt32 size, ROTATE_OPTIONS options) {
-	static const UInt32 CRC32[256] = {
-	   0x00000000, 0x04c11db7, 0x09823b6e, 0x0d4326d9, 0x130476dc, 0x17c56b6b,
-	   0x1a864db2, 0x1e475005, 0x2608edb8, 0x22c9f00f, 0x2f8ad6d6, 0x2b4bcb61,
-	   0x350c9b64, 0x31cd86d3, 0x3c8ea00a, 0x384fbdbd, 0x4c11db70, 0x48d0c6c7,
-	   0x4593e01e, 0x4152fda9, 0x5f15adac, 0x5bd4b01b, 0x569796c2, 0x52568b75,
-	   0x6a1936c8, 0x6ed82b7f, 0x639b0da6, 0x675a1011, 0x791d4014, 0x7ddc5da3,
-	   0x709f7b7a, 0x745e66cd, 0x9823b6e0, 0x9ce2ab57, 0x91a18d8e, 0x95609039,
-	   0x8b27c03c, 0x8fe6dd8b, 0x82a5fb52, 0x8664e6e5, 0xbe2b5b58, 0xbaea46ef,
-	   0xb7a96036, 0xb3687d81, 0xad2f2d84, 0xa9ee3033, 0xa4ad16ea, 0xa06c0b5d,
-	   0xd4326d90, 0xd0f37027, 0xddb056fe, 0xd9714b49, 0xc7361b4c, 0xc3f706fb,
-	   0xceb42022, 0xca753d95, 0xf23a8028, 0xf6fb9d9f, 0xfbb8bb46, 0xff79a6f1,
-	   0xe13ef6f4, 0xe5ffeb43, 0xe8bccd9a, 0xec7dd02d, 0x34867077, 0x30476dc0,
-	   0x3d044b19, 0x39c556ae, 0x278206ab, 0x23431b1c, 0x2e003dc5, 0x2ac12072,
-	   0x128e9dcf, 0x164f8078, 0x1b0ca6a1, 0x1fcdbb16, 0x018aeb13, 0x054bf6a4,
-	   0x0808d07d, 0x0cc9cdca, 0x7897ab07, 0x7c56b6b0, 0x71159069, 0x75d48dde,
-	   0x6b93dddb, 0x6f52c06c, 0x6211e6b5, 0x66d0fb02, 0x5e9f46bf, 0x5a5e5b08,
-	   0x571d7dd1, 0x53dc6066, 0x4d9b3063, 0x495a2dd4, 0x44190b0d, 0x40d816ba,
-	   0xaca5c697, 0xa864db20, 0xa527fdf9, 0xa1e6e04e, 0xbfa1b04b, 0xbb60adfc,
-	   0xb6238b25, 0xb2e29692, 0x8aad2b2f, 0x8e6c3698, 0x832f1041, 0x87ee0df6,
-	   0x99a95df3, 0x9d684044, 0x902b669d, 0x94ea7b2a, 0xe0b41de7, 0xe4750050,
-	   0xe9362689, 0xedf73b3e, 0xf3b06b3b, 0xf771768c, 0xfa325055, 0xfef34de2,
-	   0xc6bcf05f, 0xc27dede8, 0xcf3ecb31, 0xcbffd686, 0xd5b88683, 0xd1799b34,
-	   0xdc3abded, 0xd8fba05a, 0x690ce0ee, 0x6dcdfd59, 0x608edb80, 0x644fc637,
-	   0x7a089632, 0x7ec98b85, 0x738aad5c, 0x774bb0eb, 0x4f040d56, 0x4bc510e1,
-	   0x46863638, 0x42472b8f, 0x5c007b8a, 0x58c1663d, 0x558240e4, 0x51435d53,
-	   0x251d3b9e, 0x21dc2629, 0x2c9f00f0, 0x285e1d47, 0x36194d42, 0x32d850f5,
-	   0x3f9b762c, 0x3b5a6b9b, 0x0315d626, 0x07d4cb91, 0x0a97ed48, 0x0e56f0ff,
-	   0x1011a0fa, 0x14d0bd4d, 0x19939b94, 0x1d528623, 0xf12f560e, 0xf5ee4bb9,
-	   0xf8ad6d60, 0xfc6c70d7, 0xe22b20d2, 0xe6ea3d65, 0xeba91bbc, 0xef68060b,
-	   0xd727bbb6, 0xd3e6a601, 0xdea580d8, 0xda649d6f, 0xc423cd6a, 0xc0e2d0dd,
-	   0xcda1f604, 0xc960ebb3, 0xbd3e8d7e, 0xb9ff90c9, 0xb4bcb610, 0xb07daba7,
-	   0xae3afba2, 0xaafbe615, 0xa7b8c0cc, 0xa379dd7b, 0x9b3660c6, 0x9ff77d71,
-	   0x92b45ba8, 0x9675461f, 0x8832161a, 0x8cf30bad, 0x81b02d74, 0x857130c3,
-	   0x5d8a9099, 0x594b8d2e, 0x5408abf7, 0x50c9b640, 0x4e8ee645, 0x4a4ffbf2,
-	   0x470cdd2b, 0x43cdc09c, 0x7b827d21, 0x7f436096, 0x7200464f, 0x76c15bf8,
-	   0x68860bfd, 0x6c47164a, 0x61043093, 0x65c52d24, 0x119b4be9, 0x155a565e,
-	   0x18197087, 0x1cd86d30, 0x029f3d35, 0x065e2082, 0x0b1d065b, 0x0fdc1bec,
-	   0x3793a651, 0x3352bbe6, 0x3e119d3f, 0x3ad08088, 0x2497d08d, 0x2056cd3a,
-	   0x2d15ebe3, 0x29d4f654, 0xc5a92679, 0xc1683bce, 0xcc2b1d17, 0xc8ea00a0,
-	   0xd6ad50a5, 0xd26c4d12, 0xdf2f6bcb, 0xdbee767c, 0xe3a1cbc1, 0xe760d676,
-	   0xea23f0af, 0xeee2ed18, 0xf0a5bd1d, 0xf464a0aa, 0xf9278673, 0xfde69bc4,
-	   0x89b8fd09, 0x8d79e0be, 0x803ac667, 0x84fbdbd0, 0x9abc8bd5, 0x9e7d9662,
-	   0x933eb0bb, 0x97ffad0c, 0xafb010b1, 0xab710d06, 0xa6322bdf, 0xa2f33668,
-	   0xbcb4666d, 0xb8757bda, 0xb5365d03, 0xb1f740b4
-	};
-
-    UInt32 crc(0xffffffff);
-	for (UInt32 i = 0; i < size; ++i) {
-		if (options&ROTATE_INPUT)
-			crc = (crc << 8) ^ CRC32[(crc >> 24) ^ Rotate8(*data++)];
-		else
-			crc = (crc << 8) ^ CRC32[(crc >> 24) ^ *data++];
+	UInt32 crc(0xFFFFFFFF);
+	if (options&ROTATE_INPUT) {
+		// CRC of rotated bytes = rotated CRC in reflected form (LSB first) of bytes
+#if defined(CRYPTO_SSE)
+		if (size >= 64 && _CRC32Folding.supported)
+			crc = Rotate32(FoldCRC32(crc, data, size, true));
+#endif
+		crc = ReflectedCRC32(crc, data, size);
+		return options&ROTATE_OUTPUT ? crc : Rotate32(crc);
+	}
+#if defined(CRYPTO_SSE)
+	if (size >= 64 && _CRC32Folding.supported)
+		crc = FoldCRC32(crc, data, size, false);
+#endif
+	crc = CRC32(crc, data, size);
+	return options&ROTATE_OUTPUT ? Rotate32(crc) : crc;
+}
+
+/*!
+Masking kernels XOR 4 bytes key repeated by vectors whose size is a multiple of 4 (key keeps the same place in every vector),
+loads and stores are unaligned to accept any alignment of data and output. Return the count of bytes masked (a multiple of the vector size) */
+#if defined(CRYPTO_SSE)
+static const struct AVX2 {
+	AVX2() : supported(false) {
+#if defined(_MSC_VER)
+		int info[4];
+		__cpuid(info, 0);
+		if (info[0] < 7)
+			return;
+		__cpuid(info, 1);
+		UInt32 ecx(info[2]);
+		__cpuidex(info, 7, 0);
+		UInt32 ebx(info[1]);
+		// OSXSAVE and AVX, and OS saves YMM registers
+		supported = (ecx & (1 << 27)) && (ecx & (1 << 28)) && (_xgetbv(0) & 6) == 6 && (ebx & (1 << 5));
+#else
+		UInt32 eax, ebx, ecx, edx;
+		if (__get_cpuid_max(0, NULL) < 7 || !__get_cpuid(1, &eax, &ebx, &ecx, &edx))
+			return;
+		if (!(ecx & (1 << 27)) || !(ecx & (1 << 28)))
+			return; // no OSXSAVE or AVX
+		UInt32 xcr0, xcr0High;
+		__asm__("xgetbv" : "=a"(xcr0), "=d"(xcr0High) : "c"(0));
+		if ((xcr0 & 6) != 6)
+			return; // OS doesn't save YMM registers
+		__cpuid_count(7, 0, eax, ebx, ecx, edx);
+		supported = (ebx & (1 << 5)) ? true : false;
+#endif
+	}
+	bool supported;
+} _AVX2;
+
+#if !defined(_MSC_VER)
+__attribute__((target("avx2")))
+#endif
+static UInt32 MaskAVX2(UInt32 key, const UInt8* data, UInt32 size, UInt8* output) {
+	const __m256i mask = _mm256_set1_epi32(key);
+	UInt32 done(0);
+	for (; (size - done) >= 128; done += 128) {
+		__m256i x0 = _mm256_loadu_si256((const __m256i*)(data + done));
+		__m256i x1 = _mm256_loadu_si256((const __m256i*)(data + done + 32));
+		__m256i x2 = _mm256_loadu_si256((const __m256i*)(data + done + 64));
+		__m256i x3 = _mm256_loadu_si256((const __m256i*)(data + done + 96));
+		_mm256_storeu_si256((__m256i*)(output + done), _mm256_xor_si256(x0, mask));
+		_mm256_storeu_si256((__m256i*)(output + done + 32), _mm256_xor_si256(x1, mask));
+		_mm256_storeu_si256((__m256i*)(output + done + 64), _mm256_xor_si256(x2, mask));
+		_mm256_storeu_si256((__m256i*)(output + done + 96), _mm256_xor_si256(x3, mask));
 	}
-    return options&ROTATE_OUTPUT ? Rotate32(crc) : crc;
+	for (; (size - done) >= 32; done += 32)
+		_mm256_storeu_si256((__m256i*)(output + done), _mm256_xor_si256(_mm256_loadu_si256((const __m256i*)(data + done)), mask));
+	return done;
 }
 
+static UInt32 MaskSSE2(UInt32 key, const UInt8* data, UInt32 size, UInt8* output) {
+	const __m128i mask = _mm_set1_epi32(key);
+	UInt32 done(0);
+	for (; (size - done) >= 64; done += 64) {
+		__m128i x0 = _mm_loadu_si128((const __m128i*)(data + done));
+		__m128i x1 = _mm_loadu_si128((const __m128i*)(data + done + 16));
+		__m128i x2 = _mm_loadu_si128((const __m128i*)(data + done + 32));
+		__m128i x3 = _mm_loadu_si128((const __m128i*)(data + done + 48));
+		_mm_storeu_si128((__m128i*)(output + done), _mm_xor_si128(x0, mask));
+		_mm_storeu_si128((__m128i*)(output + done + 16), _mm_xor_si128(x1, mask));
+		_mm_storeu_si128((__m128i*)(output + done + 32), _mm_xor_si128(x2, mask));
+		_mm_storeu_si128((__m128i*)(output + done + 48), _mm_xor_si128(x3, mask));
+	}
+	for (; (size - done) >= 16; done += 16)
+		_mm_storeu_si128((__m128i*)(output + done), _mm_xor_si128(_mm_loadu_si128((const __m128i*)(data + done)), mask));
+	return done;
+}
+#elif defined(__ARM_NEON)
+static UInt32 MaskNEON(UInt32 key, const UInt8* data, UInt32 size, UInt8* output) {
+	const uint8x16_t mask = vreinterpretq_u8_u32(vdupq_n_u32(key));
+	UInt32 done(0);
+	for (; (size - done) >= 64; done += 64) {
+		uint8x16_t x0 = vld1q_u8(data + done);
+		uint8x16_t x1 = vld1q_u8(data + done + 16);
+		uint8x16_t x2 = vld1q_u8(data + done + 32);
+		uint8x16_t x3 = vld1q_u8(data + done + 48);
+		vst1q_u8(output + done, veorq_u8(x0, mask));
+		vst1q_u8(output + done + 16, veorq_u8(x1, mask));
+		vst1q_u8(output + done + 32, veorq_u8(x2, mask));
+		vst1q_u8(output + done + 48, veorq_u8(x3, mask));
+	}
+	for (; (size - done) >= 16; done += 16)
+		vst1q_u8(output + done, veorq_u8(vld1q_u8(data + done), mask));
+	return done;
+}
+#endif
+
+UInt8* Crypto::Mask(const UInt8* key, const UInt8* data, UInt32 size, UInt8* output) {
+	UInt32 value;
+	memcpy(&value, key, 4); // memory order, as data
+#if defined(CRYPTO_SSE)
+	UInt32 done(_AVX2.supported ? MaskAVX2(value, data, size, output) : MaskSSE2(value, data, size, output));
+#elif defined(__ARM_NEON)
+	UInt32 done(MaskNEON(value, data, size, output));
+#else
+	UInt32 done(0);
+#endif
+	// rest (or everything without SIMD) by 8 bytes words, then byte by byte
+	UInt64 mask(value | (UInt64(value) << 32));
+	for (; (size - done) >= 8; done += 8) {
+		UInt64 word;
+		memcpy(&word, data + done, 8);
+		word ^= mask;
+		memcpy(output + done, &word, 8);
+	}
+	for (; done < size; ++done)
+		output[done] = data[done] ^ key[done & 3];
+	return output;
+}
 
 } // namespace Mona
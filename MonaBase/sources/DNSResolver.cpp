@@ -0,0 +1,369 @@
+/*
+This file is a part of MonaSolutions Copyright 2017
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or
+modify it under the terms of the the Mozilla Public License v2.0.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+Mozilla Public License v. 2.0 received along this program for more
+details (or else see http://mozilla.org/MPL/2.0/).
+
+*/
+
+#include "Mona/DNSResolver.h"
+#include "Mona/BinaryReader.h"
+#include "Mona/BinaryWriter.h"
+#include "Mona/Util.h"
+#include "Mona/Logs.h"
+#include <fstream>
+#include <algorithm>
+
+using namespace std;
+
+namespace Mona {
+
+enum {
+	TYPE_A = 1,
+	TYPE_CNAME = 5,
+	TYPE_SOA = 6,
+	TYPE_AAAA = 28,
+	CLASS_IN = 1,
+	FLAG_RESPONSE = 0x8000,
+	FLAG_RECURSION = 0x0100,
+	RCODE_OK = 0,
+	RCODE_NXDOMAIN = 3
+};
+
+struct DNSResolver::Query : virtual Object {
+	Query(const string& name) : name(name), pending(3), attempt(0), deadline(0), ttl(0xFFFFFFFF), negativeTTL(0), pHost(SET) {
+		ids[0] = ids[1] = 0;
+		pHost->_name = name;
+	}
+	const string		name;
+	SocketAddress		server; // server queried by the current attempt
+	UInt16				ids[2]; // id of A and AAAA queries
+	UInt8				pending; // bit 1 = A query, bit 2 = AAAA query
+	UInt8				attempt;
+	Int64				deadline;
+	UInt32				ttl; // minimum TTL of records received
+	UInt32				negativeTTL; // from SOA record of a negative answer
+	shared<HostEntry>	pHost;
+	Exception			ex; // server failure
+	vector<OnResolved>	onResolveds;
+};
+
+static bool ReadName(BinaryReader& reader, string& name) {
+	// RFC 1035 4.1.4, labels can end with a pointer on a previous name of the packet (compression)
+	name.clear();
+	BinaryReader labels(reader.data(), reader.size());
+	labels.next(reader.position());
+	bool jumped(false);
+	UInt8 jumps(0);
+	while (labels.available()) {
+		UInt8 size = labels.read8();
+		if (!size) {
+			if (!jumped)
+				reader.reset(labels.position());
+			return true;
+		}
+		if ((size & 0xC0) == 0xC0) {
+			UInt16 offset = ((size & 0x3F) << 8) | labels.read8();
+			if (!jumped) {
+				reader.reset(labels.position());
+				jumped = true;
+			}
+			if (offset >= labels.size() || ++jumps > 32)
+				return false; // loop!
+			labels.reset(offset);
+			continue;
+		}
+		if (size > 63 || size > labels.available() || (name.size() + size) > 254)
+			return false;
+		if (!name.empty())
+			name += '.';
+		name.append(STR labels.current(), size);
+		labels.next(size);
+	}
+	return false;
+}
+
+bool DNSResolver::LoadServers(vector<SocketAddress>& servers) {
+	servers.clear();
+#if !defined(_WIN32)
+	ifstream file("/etc/resolv.conf");
+	string line;
+	while (getline(file, line)) {
+		// nameserver 8.8.8.8
+		vector<string> values;
+		String::Split(line, " \t", values, SPLIT_IGNORE_EMPTY | SPLIT_TRIM);
+		if (values.size() < 2 || String::ICompare(values[0], "nameserver") != 0)
+			continue;
+		Exception ex;
+		IPAddress host;
+		if (host.set(ex, values[1]))
+			servers.emplace_back(host, 53);
+	}
+#endif
+	return !servers.empty();
+}
+
+DNSResolver::DNSResolver(IOSocket& io, const Timer& timer) : io(io), timer(timer), timeout(1000), attempts(3), maxTTL(86400), negativeTTL(60), _socket(io), _sweeping(64) {
+	LoadServers(servers);
+	_socket.onPacket = [this](shared<Buffer>& pBuffer, const SocketAddress& address) {
+		receive(pBuffer->data(), pBuffer->size(), address);
+	};
+	// a UDP error is not fatal (ICMP unreachable for example), timeout will send to the next server
+	_socket.onError = [](const Exception& ex) { WARN("DNS resolver, ", ex); };
+	_onTimeout = [this](UInt32 delay)->UInt32 {
+		Int64 now = Time::Now();
+		Int64 next = numeric_limits<Int64>::max();
+		auto it = _queries.begin();
+		while (it != _queries.end()) {
+			Query& query = *(it++)->second; // increments before finish which erases query
+			if (query.deadline > now || ++query.attempt < attempts) {
+				if (query.deadline <= now)
+					send(query);
+				next = min(next, query.deadline);
+				continue;
+			}
+			query.ex.set<Ex::Net::Address::Ip>("DNS resolution of ", query.name, " timeout");
+			finish(query);
+		}
+		// a query can have been added by a onResolved callback, its deadline is at the most in timeout
+		return _queries.empty() ? 0 : UInt32(min(max(next - now, Int64(1)), Int64(timeout)));
+	};
+}
+
+DNSResolver::~DNSResolver() {
+	clear();
+	_socket.onPacket = nullptr;
+	_socket.onError = nullptr;
+}
+
+void DNSResolver::clear() {
+	if (_onTimeout) // else timer can be already deleted
+		timer.set(_onTimeout, 0);
+	_ids.clear();
+	_queries.clear();
+	_cache.clear();
+	_socket.close();
+}
+
+void DNSResolver::resolve(const string& hostname, const OnResolved& onResolved) {
+	Exception ex;
+	IPAddress address;
+	if (address.set(ex, hostname)) {
+		HostEntry host;
+		host._name = hostname;
+		host._addresses.emplace(address);
+		return onResolved(ex, host);
+	}
+	ex = nullptr;
+
+	string name(hostname);
+	String::ToLower(name);
+	if (!name.empty() && name.back() == '.')
+		name.pop_back();
+
+	auto itCache = _cache.find(name);
+	if (itCache != _cache.end()) {
+		if (itCache->second.expiration > Time::Now())
+			return onResolved(itCache->second.ex, *itCache->second.pHost);
+		_cache.erase(itCache);
+	}
+
+	auto itQuery = _queries.lower_bound(name);
+	if (itQuery != _queries.end() && itQuery->first == name) {
+		itQuery->second->onResolveds.emplace_back(onResolved);
+		return;
+	}
+
+	// check name is encodable (RFC 1035 2.3.4)
+	bool valid(!name.empty() && name.size() <= 253);
+	size_t label(0);
+	for (char c : name) {
+		if (c != '.')
+			++label;
+		else if (!label)
+			break;
+		else
+			label = 0;
+		if (label > 63)
+			break;
+	}
+	if (!valid || !label || label > 63)
+		ex.set<Ex::Net::Address::Ip>("Invalid hostname ", hostname);
+	else if (servers.empty())
+		ex.set<Ex::Net::Address::Ip>("No DNS server to resolve ", hostname);
+	if (ex)
+		return onResolved(ex, HostEntry());
+
+	Query& query = *_queries.emplace_hint(itQuery, name, unique<Query>(SET, name))->second;
+	query.onResolveds.emplace_back(onResolved);
+	send(query);
+}
+
+void DNSResolver::send(Query& query) {
+	const SocketAddress& server(query.server = servers[query.attempt % servers.size()]);
+	query.ex = nullptr;
+	for (UInt8 i = 0; i < 2; ++i) {
+		if (!(query.pending & (1 << i)))
+			continue;
+		if (query.ids[i])
+			_ids.erase(query.ids[i]); // late answer of the previous attempt will be ignored
+		UInt16 id;
+		do {
+			id = Util::Random<UInt16>();
+		} while (!id || _ids.count(id));
+		_ids.emplace(id, &query);
+		query.ids[i] = id;
+
+		shared<Buffer> pBuffer(SET);
+		BinaryWriter writer(*pBuffer);
+		// header: id, flags, 1 question, 0 answer, 0 authority, 0 additional
+		writer.write16(id).write16(FLAG_RECURSION).write16(1).write16(0).write16(0).write16(0);
+		size_t position(0);
+		while (position < query.name.size()) {
+			size_t end = query.name.find('.', position);
+			if (end == string::npos)
+				end = query.name.size();
+			writer.write8(UInt8(end - position)).write(query.name.data() + position, end - position);
+			position = end + 1;
+		}
+		writer.write8(0).write16(i ? TYPE_AAAA : TYPE_A).write16(CLASS_IN);
+
+		Exception ex;
+		if (!_socket.send(ex, Packet(pBuffer), server) || ex)
+			WARN("DNS query to ", server, ", ", ex);
+	}
+	query.deadline = Time::Now() + timeout;
+	if (!_onTimeout)
+		timer.set(_onTimeout, timeout);
+}
+
+void DNSResolver::receive(const UInt8* data, UInt32 size, const SocketAddress& address) {
+	BinaryReader reader(data, size);
+	if (reader.available() < 12)
+		return;
+	UInt16 id = reader.read16();
+	auto itId = _ids.find(id);
+	if (itId == _ids.end())
+		return; // unknown or late answer
+	Query& query = *itId->second;
+	if (address != query.server)
+		return; // not from the server queried (off-path spoofing)
+	UInt16 flags = reader.read16();
+	UInt16 questions = reader.read16();
+	UInt16 answers = reader.read16();
+	UInt16 records = answers + reader.read16(); // authorities
+	reader.next(2); // additionals are ignored
+	string name;
+	if (!(flags & FLAG_RESPONSE) || questions != 1 || !ReadName(reader, name) || String::ICompare(name, query.name) != 0 || reader.available() < 4)
+		return; // not an answer to our question
+	UInt16 question = reader.read16();
+	if ((question != TYPE_A && question != TYPE_AAAA) || reader.read16() != CLASS_IN)
+		return;
+	UInt8 index = question == TYPE_AAAA ? 1 : 0;
+	if (query.ids[index] != id)
+		return;
+	_ids.erase(itId);
+	query.ids[index] = 0;
+
+	UInt8 rcode = flags & 0x0F;
+	if (rcode != RCODE_OK && rcode != RCODE_NXDOMAIN) {
+		// server failure or refused, try the next server
+		query.ex.set<Ex::Net::Address::Ip>("DNS server ", address, " fails to resolve ", query.name, " (rcode=", rcode, ")");
+		if (++query.attempt < attempts)
+			return send(query);
+		return finish(query);
+	}
+	query.pending &= ~(1 << index);
+
+	for (UInt16 i = 0; i < records; ++i) {
+		if (!ReadName(reader, name) || reader.available() < 10)
+			break;
+		UInt16 type = reader.read16();
+		reader.next(2); // class
+		UInt32 ttl = reader.read32();
+		UInt16 length = reader.read16();
+		if (length > reader.available())
+			break;
+		UInt32 end = reader.position() + length;
+		if (i < answers) {
+			switch (type) {
+				case TYPE_A:
+				case TYPE_AAAA:
+					if (length != (type == TYPE_A ? 4 : 16))
+						break;
+					query.pHost->_addresses.emplace(reader, type == TYPE_A ? IPAddress::IPv4 : IPAddress::IPv6);
+					query.ttl = min(query.ttl, ttl);
+					break;
+				case TYPE_CNAME: {
+					string target;
+					if (!ReadName(reader, target))
+						break;
+					if (find(query.pHost->_aliases.begin(), query.pHost->_aliases.end(), name) == query.pHost->_aliases.end())
+						query.pHost->_aliases.emplace_back(name);
+					query.pHost->_name = move(target);
+					query.ttl = min(query.ttl, ttl);
+					break;
+				}
+				default:;
+			}
+		} else if (type == TYPE_SOA) {
+			// negative TTL = min(SOA TTL, SOA minimum) (RFC 2308 5)
+			string value;
+			if (ReadName(reader, value) && ReadName(reader, value) && reader.available() >= 20) {
+				reader.next(16); // serial, refresh, retry, expire
+				query.negativeTTL = min(ttl, reader.read32());
+			}
+		}
+		reader.reset(end);
+	}
+	if (!query.pending)
+		finish(query);
+}
+
+void DNSResolver::finish(Query& query) {
+	unique<Query> pQuery(move(_queries[query.name]));
+	_queries.erase(query.name);
+	for (UInt16 id : query.ids) {
+		if (id)
+			_ids.erase(id);
+	}
+	Exception ex;
+	UInt32 ttl(0);
+	if (!query.pHost->addresses().empty())
+		ttl = query.ttl;
+	else if (!query.ex && !query.pending) {
+		// NXDOMAIN or no record (NODATA)
+		ex.set<Ex::Net::Address::Ip>("Host ", query.name, " not found");
+		ttl = query.negativeTTL ? query.negativeTTL : negativeTTL;
+	} else
+		ex = query.ex; // failure not cached
+	if (ttl) {
+		Int64 now = Time::Now();
+		if (_cache.size() >= _sweeping) {
+			for (auto it = _cache.begin(); it != _cache.end();) {
+				if (it->second.expiration <= now)
+					it = _cache.erase(it);
+				else
+					++it;
+			}
+			_sweeping = max(UInt32(64), UInt32(_cache.size() * 2));
+		}
+		Entry& entry = _cache[query.name];
+		entry.expiration = now + min(ttl, maxTTL) * 1000ll;
+		entry.pHost = query.pHost;
+		entry.ex = ex;
+	}
+	for (const OnResolved& onResolved : query.onResolveds)
+		onResolved(ex, *query.pHost);
+}
+
+
+} // namespace Mona
@@ -212,6 +212,102 @@ Int32 Date::offset() const {
 	return _offset;
 }
 
+const char* Date::Cached(const char* format, Int64 time, Int32 offset, UInt32& size) {
+	// trivially destructible to stay usable by logs of static destructions
+	static thread_local struct Cache {
+		struct Entry {
+			char	format[64];
+			Int32	offset;
+			Int64	second;
+			char	value[64];
+			UInt8	size;
+			UInt8	patches[4][2]; // position and size of millisecond fields
+			UInt8	patchCount;
+		};
+		Entry	entries[8];
+		UInt8	count;
+		UInt8	next;
+	} _Cache;
+
+	UInt32 formatSize(strlen(format));
+	if (formatSize >= sizeof(Cache::Entry::format))
+		return NULL;
+
+	Int64 second(time / 1000);
+	if (time < 0 && (time % 1000))
+		--second;
+	UInt16 millisecond(UInt16(time - second * 1000));
+
+	Cache::Entry* pEntry(NULL);
+	for (UInt8 i = 0; i < _Cache.count; ++i) {
+		Cache::Entry& entry(_Cache.entries[i]);
+		if (entry.offset == offset && strcmp(entry.format, format) == 0) {
+			pEntry = &entry;
+			break;
+		}
+	}
+	if (!pEntry || pEntry->second != second) {
+		// compute the whole second, fields of milliseconds are formatted apart to be patched
+		Date date(second * 1000, offset);
+		string value, sub;
+		UInt8 patches[4][2];
+		UInt8 patchCount(0);
+		for (const char* cur = format; *cur; ++cur) {
+			if (*cur != '%' || !cur[1]) {
+				sub += *cur;
+				continue;
+			}
+			switch (char c = *++cur) {
+				case 's':
+					sub.append(EXPAND("%S."));
+				case 'F':
+				case 'i':
+				case 'c':
+					if (patchCount == 4)
+						return NULL;
+					date.format(sub.c_str(), value);
+					sub.clear();
+					patches[patchCount][0] = UInt8(value.size());
+					value.append(patches[patchCount++][1] = (c == 'c' ? 1 : 3), '0');
+					break;
+				case 't':
+				case 'T':
+					return NULL; // elapsed time is not fixed during the second
+				default:
+					sub += '%';
+					sub += c;
+			}
+		}
+		date.format(sub.c_str(), value);
+		if (value.size() >= sizeof(Cache::Entry::value))
+			return NULL;
+		if (!pEntry) {
+			pEntry = &_Cache.entries[_Cache.next++ % 8];
+			if (_Cache.count < 8)
+				++_Cache.count;
+			memcpy(pEntry->format, format, formatSize + 1);
+			pEntry->offset = offset;
+		}
+		pEntry->second = second;
+		memcpy(pEntry->value, value.data(), pEntry->size = UInt8(value.size()));
+		memcpy(pEntry->patches, patches, sizeof(patches));
+		pEntry->patchCount = patchCount;
+	}
+
+	for (UInt8 i = 0; i < pEntry->patchCount; ++i) {
+		char* field(pEntry->value + pEntry->patches[i][0]);
+		if (pEntry->patches[i][1] == 1) {
+			*field = '0' + millisecond / 100;
+			continue;
+		}
+		field[0] = '0' + millisecond / 100;
+		field[1] = '0' + (millisecond / 10) % 10;
+		field[2] = '0' + millisecond % 10;
+	}
+	size = pEntry->size;
+	return pEntry->value;
+}
+
 void Date::setOffset(Int32 offset) {
 	if (_day == 0 || _changed) {
 		_offset = offset;
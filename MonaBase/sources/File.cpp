@@ -35,8 +35,8 @@ using namespace std;
 namespace Mona {
 
 File::File(const Path& path, Mode mode) : _flushing(0), _loaded(false), pDecoder(NULL),
-	_written(0), _readen(0), _path(path), mode(mode), _decodingTrack(0),
-	_queueing(0), _ioTrack(0), _handle(INVALID_HANDLE_VALUE), externDecoder(false) {
+	_written(0), _readen(0), _path(path), mode(mode),
+	_queueing(0), _handle(INVALID_HANDLE_VALUE), externDecoder(false) {
 #if !defined(_WIN32)
 	memset(&_lock, 0, sizeof(_lock));
 #endif
@@ -208,17 +208,23 @@ void File::reset(UInt64 position) {
 #endif
 }
 
-int File::read(Exception& ex, void* data, UInt32 size) {
+bool File::readable(Exception& ex) {
 	if (_path.isFolder()) {
 		ex.set<Ex::Intern>("Cannot read data from a ", _path, " folder");
 		return false;
 	}
 	if (!load(ex))
-		return -1;
+		return false;
 	if (mode) {
 		ex.set<Ex::Permission>(_path, " read unauthorized in writing, append or deletion mode");
-		return -1;
+		return false;
 	}
+	return true;
+}
+
+int File::read(Exception& ex, void* data, UInt32 size) {
+	if (!readable(ex))
+		return -1;
 #if defined(_WIN32)
 	DWORD readen;
 	if (!ReadFile((HANDLE)_handle, data, size, &readen, NULL))
@@ -234,18 +240,24 @@ int File::read(Exception& ex, void* data, UInt32 size) {
 	return int(readen);
 }
 
+bool File::writable(Exception& ex) {
+	if (!load(ex))
+		return false;
+	if (!mode || mode > MODE_APPEND) {
+		ex.set<Ex::Permission>(_path, " write unauthorized in reading or deletion mode");
+		return false;
+	}
+	return true;
+}
+
 bool File::write(Exception& ex, const void* data, UInt32 size) {
 	if (_path.isFolder()) {
 		if (size)
 			ex.set<Ex::Intern>("Cannot write data to a ", _path, " folder");
 		return FileSystem::CreateDirectory(ex, _path);
 	}
-	if (!load(ex))
-		return false;
-	if (!mode || mode > MODE_APPEND) {
-		ex.set<Ex::Permission>(_path, " write unauthorized in reading or deletion mode");
+	if (!writable(ex))
 		return false;
-	}
 	if (!size)
 		return true; // nothing todo!
 #if defined(_WIN32)
@@ -267,6 +279,20 @@ bool File::write(Exception& ex, const void* data, UInt32 size) {
 	return true;
 }
 
+bool File::sync(Exception& ex) {
+	if (!_loaded)
+		return true; // nothing written
+#if defined(_WIN32)
+	if (FlushFileBuffers((HANDLE)_handle))
+		return true;
+#else
+	if (::fsync(_handle) == 0)
+		return true;
+#endif
+	ex.set<Ex::System::File>("Impossible to sync ", _path, " on disk");
+	return false;
+}
+
 bool File::erase(Exception& ex) {
 	if (mode != MODE_DELETE && mode != MODE_WRITE) {
 		ex.set<Ex::Permission>(_path, " deletion unauthorized in reading or append mode");
@@ -28,18 +28,30 @@ FileLogger::FileLogger(const string dir, UInt32 sizeByFile, UInt16 rotation) : _
 }
 
 bool FileLogger::log(LOG_LEVEL level, const Path& file, long line, const string& message) {
-	static string Buffer; // max size controlled by Logs system!
-	static Exception Ex;
-	String::Assign(Buffer, String::Log(Logs::LevelToString(level), file, line, message, Thread::CurrentId()));
-	if (!_pFile->write(Ex, Buffer.data(), Buffer.size())) {
+	String::Append(_buffer, String::Log(Logs::LevelToString(level), file, line, message, Logs::LoggingThreadId(), Logs::LoggingTime()));
+	return true;
+}
+
+bool FileLogger::flush() {
+	if (_buffer.empty())
+		return true;
+	Exception ex;
+	if (!_pFile->write(ex, _buffer.data(), _buffer.size())) {
 		_pFile.reset();
 		return false;
 	}
-	manage(Buffer.size());
+	manage(_buffer.size());
+	if (_buffer.capacity() > 0xFFFF) { // max size of one log is controlled by Logs system, but not the size of a batch!
+		_buffer.clear();
+		_buffer.shrink_to_fit();
+	} else
+		_buffer.clear();
 	return true;
 }
 
 bool FileLogger::dump(const string& header, const UInt8* data, UInt32 size) {
+	if (!flush())
+		return false;
 	String buffer(String::Date("%d/%m %H:%M:%S.%c  "), header, '\n');
 	Exception ex;
 	if (!_pFile->write(ex, buffer.data(), buffer.size()) || !_pFile->write(ex, data, size)) {
@@ -21,31 +21,51 @@ namespace Mona {
 
 using namespace std;
 
-FileWatcher::FileWatcher(const Path& path, FileSystem::Mode mode) : path(path), mode(mode), _firstWatch(true) {
+FileWatcher::FileWatcher(const Path& path, FileSystem::Mode mode) : path(path), mode(mode), _firstWatch(true), pending(0) {
 	_baseName = path.baseName() == "*" ? NULL : path.baseName().c_str();
 	_ext = path.extension().empty() ? NULL : path.extension().c_str();
 	_justFolder = path.isFolder();
+	_listing = mode == FileSystem::MODE_HEAVY || !_baseName || (_ext && *_ext == '*');
+}
+
+bool FileWatcher::match(const Path& file) const {
+	if (_justFolder && !file.isFolder())
+		return false; // just folders!
+	if (_ext) { // just files!
+		if (file.isFolder())
+			return false;
+		if (*_ext != '*' && String::ICompare(file.extension(), _ext) != 0)
+			return false; // don't match *.extension!
+	}
+	return !_baseName || String::ICompare(file.baseName(), _baseName) == 0;
+}
+
+bool FileWatcher::touch(const Path& file) {
+	const auto& it = _lastChanges.find(file);
+	if (it != _lastChanges.end()) {
+		it->second.first = -1; // next watch will see a change
+		return true;
+	}
+	// a new file to discover, or a new sub folder to observe
+	return _listing && ((mode == FileSystem::MODE_HEAVY && file.isFolder()) || match(file));
 }
 
 int FileWatcher::watch(Exception &ex, const OnUpdate& onUpdate) {
 	map<Path, pair<Time, bool>, String::IComparator> lastChanges = move(_lastChanges);
 
 	UInt32 count = 0;
-	if (mode == FileSystem::MODE_HEAVY || !_baseName || (_ext && *_ext == '*')) {
+	pending = 0;
+	folders.clear();
+	folders.emplace(path.parent());
+	if (_listing) {
 
 		// List files/folders from parent folder!
 		FileSystem::ForEach forEach([this, &onUpdate, &count, &lastChanges](const string& file, UInt16 level) {
 			Path path(file);
-			if (_justFolder && !path.isFolder())
-				return true; // just folders!
-			if (_ext) { // just files!
-				if (path.isFolder())
-					return true;
-				if (*_ext != '*' && String::ICompare(path.extension(), _ext) != 0)
-					return true; // don't match *.extension!
-			}
-			if (_baseName && String::ICompare(path.baseName(), _baseName) != 0)
-				return true; // don't match *.extension!
+			if (path.isFolder())
+				folders.emplace(file);
+			if (!match(path))
+				return true;
 			++count;
 			watchFile(lastChanges, path, onUpdate);
 			return !_baseName || (_ext && *_ext == '*');
@@ -62,6 +82,8 @@ int FileWatcher::watch(Exception &ex, const OnUpdate& onUpdate) {
 				onUpdate(it.first, false);
 		}
 	} else { // Watch a simple file or folder!
+		if (path.isFolder())
+			folders.emplace(path);
 		watchFile(lastChanges, path, onUpdate);
 		++count;
 	}
@@ -86,6 +108,8 @@ void FileWatcher::watchFile(map<Path, pair<Time, bool>, String::IComparator>& la
 		lastChange.second = true; // update signal done, wait stability before to update to anticipate progressive file replacement (download for example)
 		onUpdate(path, false);
 	}
+	if (!lastChange.second)
+		++pending;
 }
 
 } // namespace Mona
@@ -35,16 +35,11 @@ void Handler::queue(const Event<void()>& onResult) const {
 UInt32 Handler::flush() {
 	// Flush all what is possible now, and not dynamically in real-time (in rechecking _runners)
 	// to keep the possibility to do something else between two flushs!
-	deque<shared<Runner>> runners;
-	{
-		lock_guard<mutex> lock(_mutex);
-		runners = move(_runners);
-	}
-	for (shared<Runner>& pRunner : runners) {
+	_signaled = false; // before flush, a runner queued after has to signal again
+	return _runners.flush([](shared<Runner>& pRunner) {
 		pRunner->run('.', pRunner->name); // '.' to signal that its a sub-runner, wait the name of the thread in htop
 		pRunner.reset(); // release resources
-	}
-	return runners.size();
+	});
 }
 
 
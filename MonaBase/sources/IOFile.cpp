@@ -15,12 +15,23 @@ details (or else see http://mozilla.org/MPL/2.0/).
 */
 
 #include "Mona/IOFile.h"
+#include "Mona/Net.h"
 #include <list>
+#include <deque>
+#include <unordered_map>
+#if defined(__linux__)
+#include <sys/inotify.h>
+#include <sys/eventfd.h>
+#include <poll.h>
+#include <unistd.h>
+#endif
 
 using namespace std;
 
 namespace Mona {
 
+static Buffer::Allocator::Tag _ReadTag("file read");
+
 struct IOFile::Action : Runner, virtual Object {
 	Action(const char* name, const Handler& handler, const shared<File>& pFile) : Runner(name) {
 		pFile->_pHandler = &handler;
@@ -38,6 +49,12 @@ struct IOFile::Action : Runner, virtual Object {
 		virtual void handle(File& file) = 0;
 		weak<File>	_weakFile;
 	};
+	struct ErrorHandle : Handle, virtual Object {
+		ErrorHandle(const char* name, const shared<File>& pFile, Exception& ex) : Handle(name, pFile), _ex(move(ex)) {}
+	private:
+		void handle(File& file) { file.onError(_ex); }
+		Exception		_ex;
+	};
 
 protected:
 	template<typename HandleType, typename ...Args>
@@ -49,12 +66,6 @@ protected:
 	bool run(Exception& ex, const shared<File>& pFile) {
 		if (process(ex, pFile))
 			return true;
-		struct ErrorHandle : Handle, virtual Object {
-			ErrorHandle(const char* name, const shared<File>& pFile, Exception& ex) : Handle(name, pFile), _ex(move(ex)) {}
-		private:
-			void handle(File& file) { file.onError(_ex); }
-			Exception		_ex;
-		};
 		handle<ErrorHandle>(pFile, ex);
 		return true;
 	}
@@ -87,19 +98,145 @@ private:
 	shared<File> _pFile;
 };
 
+#if defined(MONA_IO_URING)
+/*!
+Reading or writing submitted to io_uring, operations of a same file are executed one after the other (file position) */
+struct IOFile::Operation : virtual Object {
+	Operation(const char* name, const shared<File>& pFile) : name(name), pFile(pFile) {}
+
+	const char* const	name;
+	const shared<File>	pFile; // keeps file opened and its data valid until completion
+
+	virtual bool submit(Exception& ex, IOUring& ring, UInt64 userData) = 0;
+	virtual bool complete(Exception& ex, Int32 result) = 0;
+};
+
+struct IOFile::Ring : Thread, virtual Object {
+	Ring() : Thread("FileRing"), _operations(0), _stopping(false) {}
+	~Ring() { stop(); }
+
+	bool init(Exception& ex) {
+		if (!_ring.init(ex, 256))
+			return false;
+		start(PRIORITY_LOW);
+		return true;
+	}
+
+	template<typename OperationType, typename ...Args>
+	void queue(Args&&... args) {
+		Operation* pOperation(new OperationType(forward<Args>(args)...));
+		lock_guard<mutex> lock(_mutex);
+		deque<unique<Operation>>& operations(_files[pOperation->pFile.get()]);
+		operations.emplace_back(pOperation);
+		++_operations;
+		if (operations.size() == 1)
+			submit(pOperation->pFile.get());
+	}
+	/*!
+	Wait completion of every operation, returns true if some were in progress */
+	bool join() {
+		unique_lock<mutex> lock(_mutex);
+		if (!_operations)
+			return false;
+		do {
+			_idle.wait(lock);
+		} while (_operations);
+		return true;
+	}
+	void stop() {
+		_stopping = true;
+		Exception ignore;
+		_ring.nop(ignore, 0); // wake up the ring thread
+		Thread::stop();
+	}
+
+private:
+	bool run(Exception& ex, const volatile bool& requestStop) {
+		while (!requestStop && !_stopping) {
+			if (_ring.wait(ex, [this](const IOUring::Completion& completion) {
+				if (completion.userData)
+					complete(*(Operation*)completion.userData, completion.result);
+			}) < 0)
+				return false;
+		}
+		return true;
+	}
+
+	void complete(Operation& operation, Int32 result) {
+		Exception ex;
+		if (!operation.complete(ex, result))
+			operation.pFile->_pHandler->queue<Action::ErrorHandle>(operation.name, operation.pFile, ex);
+		lock_guard<mutex> lock(_mutex);
+		const File* pFile(operation.pFile.get());
+		_files[pFile].pop_front(); // delete operation
+		--_operations;
+		submit(pFile);
+	}
+
+	// _mutex locked, submit the next operation of the file
+	void submit(const File* pFile) {
+		const auto& it = _files.find(pFile);
+		while (!it->second.empty()) {
+			Operation& operation(*it->second.front());
+			Exception ex;
+			if (operation.submit(ex, _ring, UInt64(&operation)))
+				return;
+			operation.pFile->_pHandler->queue<Action::ErrorHandle>(operation.name, operation.pFile, ex);
+			it->second.pop_front();
+			--_operations;
+		}
+		_files.erase(it);
+		if (!_operations)
+			_idle.notify_all();
+	}
+
+	IOUring											_ring;
+	std::mutex										_mutex;
+	unordered_map<const File*, deque<unique<Operation>>>	_files; // operations waiting, the first one is in progress
+	UInt32											_operations;
+	std::condition_variable							_idle;
+	volatile bool									_stopping;
+};
+#endif
+
 IOFile::IOFile(const Handler& handler, const ThreadPool& threadPool, UInt16 cores) :
 	handler(handler), threadPool(threadPool), _threadPool(Thread::PRIORITY_LOW, cores*2), Thread("FileWatching") { // 2*CPU => because disk speed can be at maximum 2x more than memory, and Low priority to not impact main thread pool
+#if defined(__linux__)
+	_eventFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+#endif
+#if defined(MONA_IO_URING)
+	if (Net::GetIOUring() && IOUring::Supported()) {
+		Exception ex;
+		if (!_pRing.set().init(ex)) {
+			WARN("IOFile can't use io_uring, ", ex);
+			_pRing.reset();
+		}
+	}
+#endif
 }
 
 IOFile::~IOFile() {
 	join();
-	stop(); // file watchers!
+	// file watchers!
+#if defined(__linux__)
+	if (_eventFd >= 0)
+		eventfd_write(_eventFd, 1); // wake up a thread waiting notifications
+#endif
+	Thread::stop();
+#if defined(__linux__)
+	if (_eventFd >= 0)
+		::close(_eventFd);
+#endif
 }
 
 void IOFile::join() {
 	// join devices (reading and writing operation)	
 	do {
 		((ThreadPool&)threadPool).join(); // wait possible decoding (can cast because IOFile constructor takes a non-const threadPool object)
+#if defined(MONA_IO_URING)
+		if (_pRing)
+			_pRing->join(); // wait io_uring operations (their completions can queue decoding)
+#endif
 	} while(_threadPool.join()); // while reading/writing operation
 }
 
@@ -118,7 +255,7 @@ void IOFile::load(const shared<File>& pFile) {
 
 void IOFile::read(const shared<File>& pFile, UInt32 size) {
 	struct ReadFile : WAction {
-		ReadFile(const Handler& handler, const shared<File>& pFile, const ThreadPool& threadPool, UInt32 size) : WAction("ReadFile", handler, pFile), _threadPool(threadPool), _size(size) {}
+		ReadFile(const Handler& handler, const shared<File>& pFile, const ThreadPool& threadPool, UInt32 size, Ring* pRing) : WAction("ReadFile", handler, pFile), _threadPool(threadPool), _size(size), _pRing(pRing) {}
 	private:
 		struct Handle : Action::Handle, virtual Object {
 			Handle(const char* name, const shared<File>& pFile, shared<Buffer>& pBuffer, bool end) :
@@ -128,12 +265,75 @@ void IOFile::read(const shared<File>& pFile, UInt32 size) {
 			shared<Buffer>	_pBuffer;
 			bool   _end;
 		};
+		struct Decoding : WAction, virtual Object {
+			Decoding(const shared<File>& pFile, const ThreadPool& threadPool, Ring* pRing, shared<Buffer>& pBuffer, bool end) :
+				_threadPool(threadPool), _pRing(pRing), _end(end), WAction("DecodingFile", *pFile->_pHandler, pFile), _pBuffer(move(pBuffer)) {
+			}
+		private:
+			bool process(Exception& ex, const shared<File>& pFile) {
+				UInt32 decoded = pFile->pDecoder->decode(_pBuffer, _end);
+				if (_pBuffer)
+					handle<ReadFile::Handle>(pFile, _pBuffer, _end);
+				// decoded=wantToRead!
+				if(decoded && !_end)
+					_threadPool.queue<ReadFile>(pFile->_ioTrack, *pFile->_pHandler, pFile, _threadPool, decoded, _pRing);
+				return true;
+			}
+			shared<Buffer>		_pBuffer;
+			bool				_end;
+			const ThreadPool&	_threadPool;
+			Ring*				_pRing;
+		};
+#if defined(MONA_IO_URING)
+		struct Reading : Operation, virtual Object {
+			Reading(const shared<File>& pFile, const ThreadPool& threadPool, Ring* pRing, UInt32 size) : Operation("ReadFile", pFile), _threadPool(threadPool), _pRing(pRing), _size(size), _available(0) {}
+		private:
+			bool submit(Exception& ex, IOUring& ring, UInt64 userData) {
+				// size computed here, after completion of previous operations on this file
+				_available = pFile->size() - pFile->readen();
+				Buffer::Allocator::Tag::Scope tag(_ReadTag);
+				_pBuffer.set(UInt32(min(_available, _size)));
+				return ring.read(ex, pFile->_handle, _pBuffer->data(), _pBuffer->size(), UInt64(-1), userData); // -1 => current position
+			}
+			bool complete(Exception& ex, Int32 result) {
+				if (result < 0) {
+					ex.set<Ex::System::File>("Impossible to read ", pFile->path(), " (size=", _pBuffer->size(), "), ", strerror(-result));
+					return false;
+				}
+				pFile->_readen += result;
+				if (UInt32(result) < _pBuffer->size())
+					_pBuffer->resize(result, true);
+				Readen(name, pFile, _threadPool, _pRing, _pBuffer, UInt32(result) == _available);
+				return true;
+			}
+			shared<Buffer>		_pBuffer;
+			UInt64				_available;
+			UInt64				_size;
+			const ThreadPool&	_threadPool;
+			Ring*				_pRing;
+		};
+#endif
+		static void Readen(const char* name, const shared<File>& pFile, const ThreadPool& threadPool, Ring* pRing, shared<Buffer>& pBuffer, bool end) {
+			if (pFile->pDecoder)
+				threadPool.queue<Decoding>(pFile->_decodingTrack, pFile, threadPool, pRing, pBuffer, end);
+			else if (!pFile.unique())
+				pFile->_pHandler->queue<Handle>(name, pFile, pBuffer, end);
+		}
 		bool process(Exception& ex, const shared<File>& pFile) {
 			if (pFile.unique())
 				return true; // useless to read here, nobody to receive it!
+#if defined(MONA_IO_URING)
+			if (_pRing) {
+				if (!pFile->readable(ex))
+					return false;
+				_pRing->queue<Reading>(pFile, _threadPool, _pRing, _size);
+				return true;
+			}
+#endif
 			// take the required size just if not exceeds file size to avoid to allocate a too big buffer (expensive)
 			// + use pFile->size() without refreshing to use as same size as caller has gotten it (for example to write a content-length in header)
 			UInt64 available = pFile->size() - pFile->readen();
+			Buffer::Allocator::Tag::Scope tag(_ReadTag);
 			shared<Buffer>	pBuffer(SET, UInt32(min(available, _size)));
 			pBuffer.set(UInt32(min(available, _size)));
 			int readen = pFile->read(ex, pBuffer->data(), pBuffer->size());
@@ -141,41 +341,24 @@ void IOFile::read(const shared<File>& pFile, UInt32 size) {
 				return false;
 			if ((_size=readen) < pBuffer->size())
 				pBuffer->resize(readen, true);
-			if (pFile->pDecoder) {
-				struct Decoding : WAction, virtual Object {
-					Decoding(const shared<File>& pFile, const ThreadPool& threadPool, shared<Buffer>& pBuffer, bool end) :
-						_pThread(ThreadQueue::Current()), _threadPool(threadPool), _end(end), WAction("DecodingFile", *pFile->_pHandler, pFile), _pBuffer(move(pBuffer)) {
-					}
-				private:
-					bool process(Exception& ex, const shared<File>& pFile) {
-						UInt32 decoded = pFile->pDecoder->decode(_pBuffer, _end);
-						if (_pBuffer)
-							handle<ReadFile::Handle>(pFile, _pBuffer, _end);
-						// decoded=wantToRead!
-						if(decoded && !_end)
-							_pThread->queue<ReadFile>(*pFile->_pHandler, pFile, _threadPool, decoded);
-						return true;
-					}
-					shared<Buffer>		_pBuffer;
-					bool				_end;
-					const ThreadPool&	_threadPool;
-					ThreadQueue*		_pThread;
-				};
-				_threadPool.queue<Decoding>(pFile->_decodingTrack, pFile, _threadPool, pBuffer, _size == available);
-			} else
-				handle<Handle>(pFile, pBuffer, _size == available);
+			Readen(name, pFile, _threadPool, _pRing, pBuffer, _size == available);
 			return true;
 		}
 		UInt32				_size;
 		const ThreadPool&	_threadPool;
+		Ring*				_pRing;
 	};
 	// always do the job even if size==0 to get a onReaden event!
-	_threadPool.queue<ReadFile>(pFile->_ioTrack, handler, pFile, threadPool, size);
+#if defined(MONA_IO_URING)
+	_threadPool.queue<ReadFile>(pFile->_ioTrack, handler, pFile, threadPool, size, _pRing.get());
+#else
+	_threadPool.queue<ReadFile>(pFile->_ioTrack, handler, pFile, threadPool, size, nullptr);
+#endif
 }
 
 void IOFile::write(const shared<File>& pFile, const Packet& packet) {
 	struct WriteFile : SAction { // SAction to allow file writing full asynchronous (without any other hand on the file)
-		WriteFile(const Handler& handler, const shared<File>& pFile, const Packet& packet) : _packet(move(packet)), SAction("WriteFile", handler, pFile) {
+		WriteFile(const Handler& handler, const shared<File>& pFile, const Packet& packet, Ring* pRing) : _packet(move(packet)), SAction("WriteFile", handler, pFile), _pRing(pRing) {
 			pFile->_queueing += _packet.size();
 		}
 	private:
@@ -187,24 +370,70 @@ void IOFile::write(const shared<File>& pFile, const Packet& packet) {
 					file.onFlush(!file.loaded());
 			}
 		};
+#if defined(MONA_IO_URING)
+		struct Writing : Operation, virtual Object {
+			Writing(const shared<File>& pFile, Packet& packet) : Operation("WriteFile", pFile), _packet(move(packet)) {}
+		private:
+			bool submit(Exception& ex, IOUring& ring, UInt64 userData) {
+				if (ring.write(ex, pFile->_handle, _packet.data(), _packet.size(), UInt64(-1), userData)) // -1 => current position
+					return true;
+				pFile->_queueing -= _packet.size();
+				return false;
+			}
+			bool complete(Exception& ex, Int32 result) {
+				UInt64 queueing = (pFile->_queueing -= _packet.size());
+				if (result <= 0) {
+					ex.set<Ex::System::File>("Impossible to write ", pFile->path(), " (size=", _packet.size(), ")", result ? ", " : "", result ? strerror(-result) : "");
+					return false;
+				}
+				pFile->_written += result;
+				if (UInt32(result) < _packet.size()) {
+					ex.set<Ex::System::File>("No more disk space to write ", pFile->path(), " (size=", _packet.size(), ")");
+					return false;
+				}
+				Written(name, pFile, queueing);
+				return true;
+			}
+			Packet	_packet;
+		};
+#endif
+		static void Written(const char* name, const shared<File>& pFile, UInt64 queueing) {
+			if (queueing)
+				return;
+			if (!pFile->_flushing++) { // To signal end of write!
+				if (!pFile.unique())
+					pFile->_pHandler->queue<Handle>(name, pFile);
+			} else
+				--pFile->_flushing;
+		}
 		bool process(Exception& ex, const shared<File>& pFile) {
+#if defined(MONA_IO_URING)
+			if (_pRing && _packet && !pFile->_path.isFolder()) {
+				if (!pFile->writable(ex)) {
+					pFile->_queueing -= _packet.size();
+					return false;
+				}
+				_pRing->queue<Writing>(pFile, _packet);
+				return true;
+			}
+#endif
 			UInt64 queueing = (pFile->_queueing -= _packet.size());
 			if (!pFile->write(ex, _packet.data(), _packet.size()))
 				return false;
-			if (queueing)
-				return true;
-			if(!pFile->_flushing++) // To signal end of write!
-				handle<Handle>(pFile);
-			else
-				--pFile->_flushing;
+			Written(name, pFile, queueing);
 			return true;
 		}
 		Packet		 _packet;
+		Ring*		 _pRing;
 	};
 	// do the WriteFile even if packet is empty when not loaded to allow to open the file and clear its content or create the file
 	// or to allow to create the folder => if File is a Folder opened in WRITE/APPEND mode loaded is always false and write an empty packet create the folder => allow a folder creation asynchrone!
 	if(packet || !pFile->loaded())
-		_threadPool.queue<WriteFile>(pFile->_ioTrack, handler, pFile, packet);
+#if defined(MONA_IO_URING)
+		_threadPool.queue<WriteFile>(pFile->_ioTrack, handler, pFile, packet, _pRing.get());
+#else
+		_threadPool.queue<WriteFile>(pFile->_ioTrack, handler, pFile, packet, nullptr);
+#endif
 }
 
 void IOFile::erase(const shared<File>& pFile) {
@@ -248,37 +477,213 @@ void IOFile::watch(const shared<const FileWatcher>& pFileWatcher, const FileWatc
 		handler.queue<OnUpdate>(onUpdate, file, firstWatch);
 	};
 	start(Thread::PRIORITY_LOWEST);
+#if defined(__linux__)
+	if (_eventFd >= 0)
+		eventfd_write(_eventFd, 1); // wake up a thread waiting notifications to watch immediatly the new one
+#endif
 }
 
+static const Int64	_Never(0x7FFFFFFFFFFFFFFFll);
+static const UInt32	_PollingDelay(1000);
+static const UInt32	_StabilityDelay(200); // to anticipate progressive file replacement, every change notification is an unstability
+
+struct IOFile::Watching : virtual Object {
+	Watching(const shared<const FileWatcher>& pWatcher) : pWatcher(pWatcher), time(0), polling(true) {}
+	FileWatcher& watcher() { return (FileWatcher&)*pWatcher; }
+
+	const shared<const FileWatcher>	pWatcher;
+	Int64							time; // next watch, _Never if waits a notification
+	bool							polling; // true if some folders are not observed
+	set<int>						folders; // inotify watch descriptors
+};
+
+/*!
+Notify changes of folders observed (inotify on Linux), without notification file watching is a polling */
+struct IOFile::Notifier : virtual Object {
+	Notifier(IOFile& io) : _io(io) {
+#if defined(__linux__)
+		if ((_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC)) < 0)
+			WARN("File watching by polling, inotify unavailable (", strerror(errno), ")");
+#endif
+	}
+	~Notifier() {
+#if defined(__linux__)
+		if (_fd >= 0)
+			::close(_fd);
+#endif
+	}
+
+	/*!
+	Update folders observed after a watch, returns true if new folders are observed
+	(a change before their observation could have been missed by the watch) */
+	bool subscribe(Watching& watching) {
+#if defined(__linux__)
+		if (_fd < 0)
+			return false;
+		bool added(false);
+		set<int> folders;
+		watching.polling = false;
+		for (const string& folder : watching.watcher().folders) {
+			int wd = inotify_add_watch(_fd, folder.c_str(), IN_MODIFY | IN_ATTRIB | IN_CLOSE_WRITE | IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_DELETE_SELF | IN_MOVE_SELF);
+			if (wd < 0) {
+				watching.polling = true; // folder doesn't exist (yet) or inotify limit reached
+				continue;
+			}
+			folders.emplace(wd);
+			if (!watching.folders.count(wd))
+				added = true;
+			Folder& observed = _folders[wd];
+			observed.path = folder;
+			observed.watchings.emplace(&watching);
+		}
+		for (int wd : watching.folders) {
+			if (!folders.count(wd))
+				remove(wd, watching);
+		}
+		watching.folders = move(folders);
+		return added;
+#else
+		return false;
+#endif
+	}
+	void unsubscribe(Watching& watching) {
+#if defined(__linux__)
+		for (int wd : watching.folders)
+			remove(wd, watching);
+		watching.folders.clear();
+#endif
+	}
+
+	/*!
+	Wait notifications until timeout, watchings notified are scheduled to be watched immediatly */
+	void wait(UInt32 timeout) {
+#if defined(__linux__)
+		if (_fd >= 0) {
+			pollfd fds[2] = { { _fd, POLLIN, 0 }, { _io._eventFd, POLLIN, 0 } };
+			if (::poll(fds, 2, int(timeout)) <= 0)
+				return;
+			if (fds[1].revents) {
+				eventfd_t value;
+				eventfd_read(_io._eventFd, &value);
+			}
+			if (fds[0].revents)
+				read();
+			return;
+		}
+#endif
+		_io.wakeUp.wait(timeout);
+	}
+
+private:
+#if defined(__linux__)
+	void read() {
+		Int64 now = Time::Now();
+		alignas(inotify_event) char buffer[0x4000];
+		ssize_t size;
+		while ((size = ::read(_fd, buffer, sizeof(buffer))) > 0) {
+			const inotify_event* pEvent;
+			for (const char* cur = buffer; cur < (buffer + size); cur += sizeof(inotify_event) + pEvent->len) {
+				pEvent = (const inotify_event*)cur;
+				if (pEvent->mask & IN_Q_OVERFLOW) {
+					// events lost, watch everything again
+					for (auto& it : _folders) {
+						for (Watching* pWatching : it.second.watchings)
+							notify(*pWatching, now);
+					}
+					continue;
+				}
+				const auto& it = _folders.find(pEvent->wd);
+				if (it == _folders.end())
+					continue;
+				if (pEvent->mask & IN_IGNORED) {
+					// folder deleted or moved, watch again to update folders observed
+					for (Watching* pWatching : it->second.watchings) {
+						pWatching->folders.erase(pEvent->wd);
+						notify(*pWatching, now);
+					}
+					_folders.erase(it);
+					continue;
+				}
+				Path file(it->second.path, pEvent->len ? pEvent->name : "", (pEvent->len && (pEvent->mask & IN_ISDIR)) ? "/" : "");
+				// creation/deletion changes folder too
+				Path folder;
+				if (pEvent->len && (pEvent->mask & (IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO)))
+					folder.set(it->second.path);
+				for (Watching* pWatching : it->second.watchings) {
+					FileWatcher& watcher = pWatching->watcher();
+					if (watcher.touch(file) | (folder && watcher.touch(folder)))
+						notify(*pWatching, now);
+				}
+			}
+		}
+	}
+	void notify(Watching& watching, Int64 now) {
+		if (watching.time == _Never) // else already scheduled, changes since will be seen as unstability
+			watching.time = now;
+	}
+	void remove(int wd, Watching& watching) {
+		const auto& it = _folders.find(wd);
+		if (it == _folders.end())
+			return;
+		it->second.watchings.erase(&watching);
+		if (!it->second.watchings.empty())
+			return;
+		inotify_rm_watch(_fd, wd);
+		_folders.erase(it);
+	}
+
+	struct Folder : virtual Object {
+		string				path;
+		set<Watching*>		watchings;
+	};
+	map<int, Folder>	_folders;
+	int					_fd;
+#endif
+	IOFile&				_io;
+};
+
 bool IOFile::run(Exception& ex, const volatile bool& requestStop) {
-	list<shared<const FileWatcher>> watchers;
+	Notifier notifier(self);
+	list<Watching> watchings;
 	while(!requestStop) {
-		Time time;
 		{
 			lock_guard<mutex> lock(_mutexWatchers);
-			watchers.insert(watchers.end(), _watchers.begin(), _watchers.end());
+			for (const shared<const FileWatcher>& pWatcher : _watchers)
+				watchings.emplace_back(pWatcher);
 			_watchers.clear();
-			if (watchers.empty()) {
+			if (watchings.empty()) {
 				stop(); // to set _stop immediatly!
 				break;
 			}
 		}
-		auto it = watchers.begin();
-		while (it != watchers.end()) {
-			if (it->unique()) {
-				it = watchers.erase(it);
+		Int64 now = Time::Now();
+		Int64 next = now + _PollingDelay; // at least every second to release unique watchers
+		auto it = watchings.begin();
+		while (it != watchings.end()) {
+			if (it->pWatcher.unique()) {
+				notifier.unsubscribe(*it);
+				it = watchings.erase(it);
 				continue;
 			}
-			const shared<const FileWatcher> pWatcher = *it++;
-			AUTO_ERROR(((FileWatcher&)*pWatcher).watch(ex, pWatcher->onUpdate)>=0, "File watching");
-			ex = nullptr;
+			Watching& watching = *it++;
+			if (watching.time <= now) {
+				AUTO_ERROR(watching.watcher().watch(ex, watching.pWatcher->onUpdate) >= 0, "File watching");
+				ex = nullptr;
+				if (notifier.subscribe(watching))
+					watching.time = now; // watch again
+				else if (watching.polling)
+					watching.time = now + _PollingDelay;
+				else
+					watching.time = watching.watcher().pending ? (now + _StabilityDelay) : _Never;
+			}
+			if (watching.time < next)
+				next = watching.time;
 		}
-		if (wakeUp.wait((UInt32)max(1000 - time.elapsed(), 1)))
-			break;// wait()==true means requestStop=true because there is no other wakeUp.set elsewhere
+		notifier.wait(UInt32(max<Int64>(next - Time::Now(), 1)));
 	}
 
-	for (const shared<const FileWatcher>& pWatcher : watchers) {
-		if (!pWatcher.unique()) {
+	for (Watching& watching : watchings) {
+		if (!watching.pWatcher.unique()) {
 			ex.set<Ex::Intern>("Some file watcher are still active while IOFile is deleting");
 			return false;
 		}
@@ -50,6 +50,7 @@ bool IOSRTSocket::subscribe(Exception& ex, const shared<Socket>& pSocket) {
 		return false;
 	}
 	_sockets.emplace(*pSocket, pSocket);
+	pSocket->_pReactor = this; // to rearm reception after a backpressure
 	++_subscribers;
 	return true;
 }
@@ -62,6 +63,7 @@ void IOSRTSocket::unsubscribe(Socket* pSocket) {
 		if (!_sockets.erase(*pSocket))
 			return;
 	}
+	pSocket->_pReactor = NULL;
 
 	lock_guard<mutex> lock(_mutex); // to avoid a restart during _system reading + protected _count decrement
 	--_subscribers;
@@ -34,12 +34,15 @@ details (or else see http://mozilla.org/MPL/2.0/).
 #if defined(SRT_API)
 	#include "Mona/IOSRTSocket.h"
 #endif
+#include <set>
 
 
 using namespace std;
 
 namespace Mona {
 
+static Buffer::Allocator::Tag _ReceiveTag("socket receive");
+
 struct IOSocket::Action : Runner, virtual Object {
 	Action(const char* name, int error, const shared<Socket>& pSocket) : Runner(name), _weakSocket(pSocket) {
 		if (error)
@@ -93,8 +96,79 @@ private:
 };
 
 
-IOSocket::IOSocket(const Handler& handler, const ThreadPool& threadPool, const char* name) : _initSignal(false),
+#if defined(MONA_IO_URING)
+enum {
+	RING_POLL = 1,
+	RING_RECEIVE = 2,
+	RING_SEND = 3,
+	RING_OPERATION = 3, // userData = Ring pointer | operation (cancellation completions have 0)
+	RING_GROUP_STREAM = 0,
+	RING_GROUP_DATAGRAM = 1,
+	// buffers provided to the kernel by group, shared by sockets of the reactor (memory committed on first filling),
+	// a reception without buffer stops and is rearmed, its data waiting in the socket buffer
+	RING_STREAM_BUFFERS = 256, // 16KB
+	RING_DATAGRAM_BUFFERS = 1024 // header + address + maximum UDP payload, usually just the first page committed
+};
+
+/*!
+io_uring subscription of a socket (Socket::_pWeakThis), deleted on completion of its last operation once unsubscribed or socket deleted.
+A socket which completes with io_uring (see IOSocket::completes) has a multishot reception in buffers provided to the kernel
+and sends its queue with sendmsg, then its poll just signals writable state (connection, first onFlush) and errors,
+a secure or listening socket keeps poll as readiness (dispatched as epoll events) */
+struct IOSocket::Ring : weak<Socket>, virtual Object {
+	enum Receiving : UInt8 {
+		RECEIVING_NONE = 0, // readiness
+		RECEIVING_IDLE, // reception budget exceeded, or waiting connection
+		RECEIVING_ON,
+		RECEIVING_CANCELING, // reception budget exceeded
+		RECEIVING_CLOSING, // end of stream or error, signaled once data received delivered
+		RECEIVING_END
+	};
+	Ring(const shared<Socket>& pSocket, bool completes) : weak<Socket>(pSocket), operations(0), canceled(false),
+		receiving(completes ? RECEIVING_IDLE : RECEIVING_NONE), error(0), group(pSocket->type == Socket::TYPE_STREAM ? RING_GROUP_STREAM : RING_GROUP_DATAGRAM), sending(0), completed(0), blocked(false) {
+		memset(&msg, 0, sizeof(msg));
+		msg.msg_namelen = sizeof(sockaddr_in6); // datagram sender address
+	}
+	UInt64 userData(UInt8 operation) const { return UInt64(this) | operation; }
+	UInt32 events() const { return receiving ? EPOLLOUT : (EPOLLIN | EPOLLRDHUP | EPOLLOUT); }
+
+	UInt8				operations; // poll, reception and sending in progress, protected by IOSocket::_mutex
+	std::atomic<bool>	canceled; // unsubscription or socket deletion, every operation has been canceled
+	Receiving			receiving; // protected by IOSocket::_mutex
+	int					error; // end of stream error (RECEIVING_CLOSING)
+	const UInt16		group;
+	msghdr				msg; // multishot reception layout of datagram
+
+	// sending in progress, protected by Socket::_mutexSending (or by reactor alone once socket deleted)
+	struct Sendings : virtual Object {
+		std::deque<Socket::Sending>	packets; // data in flight
+		msghdr						msgs[Socket::SEND_BATCH_MAX];
+		iovec						iovecs[Socket::SEND_BATCH_MAX];
+	};
+	unique<Sendings>	pSendings; // on first sending (congested socket)
+	UInt8				sending; // messages submitted
+	UInt8				completed; // messages completed
+	bool				blocked; // sending has to wait writable state (or stream shutdown)
+};
+#endif
+
+static const char* ReactorName(const char* name, UInt16 index) {
+	// Thread keeps just the name pointer, so the child reactor names "<name>1", "<name>2"... are interned for the process life
+	static mutex Mutex;
+	static set<string> Names;
+	lock_guard<mutex> lock(Mutex);
+	return Names.emplace(String(name, index)).first->c_str();
+}
+
+IOSocket::IOSocket(const Handler& handler, const ThreadPool& threadPool, UInt16 reactors, const char* name) : _initSignal(false),
    _system(0), Thread(name),_subscribers(0),handler(handler), threadPool(threadPool) {
+#if defined(MONA_IO_URING)
+	_operations = 0;
+	_ringed = false;
+#endif
+	// this is the first reactor, others are children IOSocket with the same handler and threadPool
+	for (UInt16 index = 1; index < reactors; ++index)
+		_reactors.emplace_back(new IOSocket(handler, threadPool, ReactorName(name, index)));
 }
 
 IOSocket::~IOSocket() {
@@ -131,6 +205,10 @@ bool IOSocket::subscribe(Exception& ex, const shared<Socket>& pSocket,
 	pSocket->onReceived = onReceived;
 	pSocket->onFlush = onFlush;
 	pSocket->_pHandler = &handler;
+	{
+		lock_guard<mutex> lock(pSocket->_mutexSending);
+		pSocket->_pacing.weakSocket = pSocket;
+	}
 
 	if (pSocket->type < Socket::TYPE_OTHER) {
 		if (subscribe(ex, pSocket))
@@ -155,7 +233,31 @@ bool IOSocket::subscribe(Exception& ex, const shared<Socket>& pSocket,
 	return false;
 }
 
+UInt32 IOSocket::subscribers() const {
+	UInt32 subscribers(_subscribers);
+	for (const unique<IOSocket>& pReactor : _reactors)
+		subscribers += pReactor->subscribers();
+	return subscribers;
+}
+
 bool IOSocket::subscribe(Exception& ex, const shared<Socket>& pSocket) {
+	if (!_reactors.empty()) {
+		// choose the less loaded reactor, beginning by the one given by socket id to share equally sockets on equal load
+		UInt16 count(reactors());
+		UInt16 index(UInt16(pSocket->id() % count)), best(index);
+		UInt32 load(index ? _reactors[index - 1]->_subscribers.load() : _subscribers.load());
+		for (UInt16 i = 1; load && i < count; ++i) {
+			UInt16 next((index + i) % count);
+			UInt32 nextLoad(next ? _reactors[next - 1]->_subscribers.load() : _subscribers.load());
+			if (nextLoad >= load)
+				continue;
+			load = nextLoad;
+			best = next;
+		}
+		if (best)
+			return _reactors[best - 1]->subscribe(ex, pSocket);
+	}
+
 	lock_guard<mutex> lock(_mutex); // must protect "start" + _system (to avoid a write operation on restarting) + _subscribers increment
 	if (!running()) {
 		_initSignal.reset();
@@ -176,6 +278,24 @@ bool IOSocket::subscribe(Exception& ex, const shared<Socket>& pSocket) {
 	}
 	_sockets.emplace(*pSocket, pSocket);
 #else
+#if defined(MONA_IO_URING)
+	if (_ring) {
+		Ring* pRing = new Ring(pSocket, completes(*pSocket));
+		// multishot poll, edge triggered as epoll
+		if (!_ring.poll(ex, *pSocket, pRing->events(), pRing->userData(RING_POLL))) {
+			delete pRing;
+			return false;
+		}
+		++pRing->operations;
+		++_operations;
+		pSocket->_pWeakThis = pRing;
+		if (pRing->receiving)
+			receive(*pRing, *pSocket);
+		pSocket->_pReactor = this;
+		++_subscribers;
+		return true;
+	}
+#endif
 	pSocket->_pWeakThis = new weak<Socket>(pSocket);
 	int res;
 #if defined(_BSD)
@@ -198,6 +318,7 @@ bool IOSocket::subscribe(Exception& ex, const shared<Socket>& pSocket) {
 		return false;
 	}
 #endif
+	pSocket->_pReactor = this;
 	++_subscribers;
 	
 	return true;
@@ -221,6 +342,13 @@ void IOSocket::unsubscribe(shared<Socket>& pSocket) {
 }
 
 void IOSocket::unsubscribe(Socket* pSocket) {
+	if (pSocket->_pReactor != this) {
+		// managed by one other reactor
+		if (pSocket->_pReactor)
+			pSocket->_pReactor->unsubscribe(pSocket);
+		return;
+	}
+	pSocket->_pReactor = NULL;
 #if defined(_WIN32)
 	{
 		// decrements _count before the PostMessage
@@ -244,6 +372,20 @@ void IOSocket::unsubscribe(Socket* pSocket) {
 			PostMessage(_system, 0, 0, 0); // to get stop if no more socket (checking count), ignore error
 	}
 #else
+#if defined(MONA_IO_URING)
+	if (_ringed) {
+		// ring deleted on completion of its last operation
+		Ring& ring(static_cast<Ring&>(*pSocket->_pWeakThis));
+		pSocket->_pWeakThis = NULL;
+		if (running() && _system)
+			cancel(ring);
+		else
+			ring.operations = 0; // io_uring closed
+		ring.canceled = true;
+		release(ring);
+		return;
+	}
+#endif
 	if (running() && _system) {
 #if defined(_BSD)
 		struct kevent events[2];
@@ -278,26 +420,26 @@ void IOSocket::read(const shared<Socket>& pSocket, int error) {
 		private:
 			struct Handle : Action::Handle {
 				Handle(const char* name, const shared<Socket>& pSocket, const Exception& ex, shared<Socket>& pConnection, bool& stop) :
-					Action::Handle(name, pSocket, ex), _pConnection(move(pConnection)), _pThread(NULL) {
+					Action::Handle(name, pSocket, ex), _pConnection(move(pConnection)), _rearm(false) {
 					if (++pSocket->_receiving < Socket::BACKLOG_MAX)
 						return;
 					stop = true;
-					_pThread = ThreadQueue::Current();
+					_rearm = true;
 					++pSocket->_reading;
 				}
 			private:
 				void handle(const shared<Socket>& pSocket) {
 					pSocket->onAccept(_pConnection);
 					UInt32 receiving = --pSocket->_receiving;
-					if (!_pThread)
+					if (!_rearm)
 						return;
-					if (receiving < Socket::BACKLOG_MAX)
-						_pThread->queue<Accept>(0, pSocket); // REARM
+					if (receiving < Socket::BACKLOG_MAX && pSocket->_pReactor)
+						pSocket->_pReactor->threadPool.queue<Accept>(pSocket->_threadReceive, 0, pSocket); // REARM (on track to keep order)
 					else
 						--pSocket->_reading;
 				}
 				shared<Socket>		_pConnection;
-				ThreadQueue*		_pThread;
+				bool				_rearm;
 			};
 			bool process(Exception& ex, const shared<Socket>& pSocket) {
 				if (!pSocket->_reading--) // me and something else! useless!
@@ -326,11 +468,11 @@ void IOSocket::read(const shared<Socket>& pSocket, int error) {
 	private:
 		struct Handle : Action::Handle {
 			Handle(const char* name, const shared<Socket>& pSocket, const Exception& ex, shared<Buffer>& pBuffer, const SocketAddress& address, bool& stop) :
-				Action::Handle(name, pSocket, ex), _address(address), _pBuffer(move(pBuffer)), _pThread(NULL) {
+				Action::Handle(name, pSocket, ex), _address(address), _pBuffer(move(pBuffer)), _rearm(false) {
 				if ((pSocket->_receiving += _pBuffer->size()) < pSocket->recvBufferSize())
 					return;
 				stop = true;
-				_pThread = ThreadQueue::Current();
+				_rearm = true;
 				++pSocket->_reading;
 			}
 		private:
@@ -338,22 +480,101 @@ void IOSocket::read(const shared<Socket>& pSocket, int error) {
 				UInt32 receiving = _pBuffer->size();
 				pSocket->onReceived(_pBuffer, _address);
 				receiving = pSocket->_receiving -= receiving;
-				if (!_pThread)
+				if (!_rearm)
 					return;
-				if(receiving < pSocket->recvBufferSize())
-					_pThread->queue<Receive>(0, pSocket); // REARM
+				if(receiving < pSocket->recvBufferSize() && pSocket->_pReactor)
+					pSocket->_pReactor->threadPool.queue<Receive>(pSocket->_threadReceive, 0, pSocket); // REARM (on track to keep order)
 				else
 					--pSocket->_reading;
 			}
 			shared<Buffer>		_pBuffer;
 			SocketAddress		_address;
-			ThreadQueue*		_pThread;
+			bool				_rearm;
 		};
 
 		bool process(Exception& ex, const shared<Socket>& pSocket) {
 			if (!pSocket->_reading--) // me and something else! useless!
 				return true;
+			Buffer::Allocator::Tag::Scope tag(_ReceiveTag);
 			bool stop(false);
+#if defined(MONA_IO_URING)
+			IOSocket* pReactor(pSocket->_pReactor);
+			if (pReactor && pReactor->completes(*pSocket)) {
+				// data already received by the reactor with io_uring, deliver them
+				shared<Buffer>	pBuffer;
+				SocketAddress	address;
+				while (!stop) {
+					{
+						lock_guard<mutex> lock(pSocket->_mutexUndelivered);
+						if (pSocket->_undelivered.empty())
+							break;
+						pBuffer = move(pSocket->_undelivered.front().first);
+						address = pSocket->_undelivered.front().second;
+						pSocket->_undeliveredSize -= pBuffer->size();
+						pSocket->_undelivered.pop_front();
+					}
+					// decode can't happen BEFORE onDisconnection because this call decode + push to _handler in this call!
+					if (pSocket->pDecoder)
+						pSocket->pDecoder->decode(pBuffer, address, pSocket);
+					if (pBuffer)
+						handle<Handle>(pSocket, pBuffer, address, stop);
+				}
+				if (!stop) // else the last handle queued rearms this delivery
+					pReactor->resume(pSocket);
+				return true;
+			}
+#endif
+			if (pSocket->type == Socket::TYPE_DATAGRAM) {
+				// drain datagrams by batch (one system call for Socket::RECV_BATCH_MAX datagrams when possible)
+				shared<Buffer>	pBuffers[Socket::RECV_BATCH_MAX];
+				SocketAddress	addresses[Socket::RECV_BATCH_MAX];
+				int received(0), delivered(0);
+				{
+					// first the datagrams of a previous batch not delivered because reception budget was exceeded
+					lock_guard<mutex> lock(pSocket->_mutexUndelivered);
+					for (auto& it : pSocket->_undelivered) {
+						pBuffers[received] = move(it.first);
+						addresses[received++] = it.second;
+					}
+					pSocket->_undelivered.clear();
+					pSocket->_undeliveredSize = 0;
+				}
+				while (!stop) {
+					if (delivered == received) {
+						Exception exBatch; // to keep a possible NET_EMSGSIZE warning of a previous batch
+						received = pSocket->receive(exBatch, pBuffers, addresses, Socket::RECV_BATCH_MAX);
+						if (received < 0) {
+							if (exBatch.cast<Ex::Net::Socket>().code == NET_EWOULDBLOCK)
+								return true;
+							ex = exBatch;
+							if (ex.cast<Ex::Net::Socket>().code != NET_ESHUTDOWN)
+								return false;
+							pSocket->_reading = 0xFF; // block reception!
+							ex = nullptr;
+							return true;
+						}
+						if (exBatch)
+							ex = exBatch; // truncated datagram lost, not a disconnection!
+						delivered = 0;
+						continue;
+					}
+					shared<Buffer>& pBuffer(pBuffers[delivered]);
+					// decode can't happen BEFORE onDisconnection because this call decode + push to _handler in this call!
+					if (pSocket->pDecoder)
+						pSocket->pDecoder->decode(pBuffer, addresses[delivered], pSocket);
+					if (pBuffer)
+						handle<Handle>(pSocket, pBuffer, addresses[delivered], stop);
+					++delivered;
+				}
+				// budget exceeded, the rest of the batch waits the rearmed reception (the last handle queued rearms it)
+				lock_guard<mutex> lock(pSocket->_mutexUndelivered);
+				while (delivered < received) {
+					pSocket->_undeliveredSize += pBuffers[delivered]->size();
+					pSocket->_undelivered.emplace_back(move(pBuffers[delivered]), addresses[delivered]);
+					++delivered;
+				}
+				return true;
+			}
 			while (!stop) {
 				UInt32 available = pSocket->available();
 				if (!available) // always get something (maybe a new reception has been gotten since the last pSocket->available() call)
@@ -399,6 +620,10 @@ void IOSocket::write(const shared<Socket>& pSocket, int error) {
 	// ::printf("WRITE(%d) socket %d\n", error, pSocket->id());
 	if (!pSocket->_opened)
 		pSocket->_opened = true;
+#if defined(MONA_IO_URING)
+	if (!error && send(pSocket))
+		return; // io_uring sending, its completion continues until onFlush
+#endif
 	struct Send : Action {
 		Send(int error, const shared<Socket>& pSocket) : Action("SocketSend", error, pSocket) {}
 	private:
@@ -450,6 +675,387 @@ void IOSocket::close(const shared<Socket>& pSocket, int error) {
 }
 
 
+#if !defined(_WIN32) && !defined(_BSD)
+void IOSocket::dispatch(const shared<Socket>& pSocket, UInt32 events) {
+	// EPOLLIN | EPOLLOUT | EPOLLERR | EPOLLHUP | EPOLLRDHUP (same values for poll with io_uring)
+	// printf("%d => %u\n", pSocket->id(), events);
+	int error = 0;
+	if(events&EPOLLERR) {
+		socklen_t len(sizeof(error));
+		if(getsockopt(pSocket->id(), SOL_SOCKET, SO_ERROR, (void *)&error, &len)==-1)
+			error = Net::LastError();
+	}
+	if (events&EPOLLRDHUP) {
+		// disconnection
+		close(pSocket, error);
+		return;
+	}
+	if (!(events&EPOLLHUP)) { // if socket unexpected close no more read or write!
+		if (events&EPOLLIN) {
+			/* even in EPOLLET we can miss the first WRITE event, for example with an UDP socket, its creation makes it writable quickly,
+			so the IOSocket subscribe happens after its WRITABLE state event and we miss its WRITE change state.
+			Then EPOLLOUT comes with EPOLLIN as soon as socket is writable, write just if data are waiting this edge (else it's lost) */
+			if (events&EPOLLOUT && !error && (!pSocket->_opened || pSocket->queueing())) // for first Flush requirement or queue flush!
+				write(pSocket, 0); // before read! Connection!
+			read(pSocket, error);
+			error = 0;
+		} else if (events&EPOLLOUT) { // else if because EPOLLET!
+			write(pSocket, error);
+			error = 0;
+		}
+	}
+	if (error) // on few unix system we can get an error without anything else
+		threadPool.queue<Action>(pSocket->_threadReceive, "SocketError", error, pSocket);
+}
+#endif
+
+#if defined(MONA_IO_URING)
+bool IOSocket::run(Exception& ex, int readFD) {
+	// io_uring engine: sockets receive and send with io_uring, or get a multishot poll dispatched as epoll events (see completes)
+	_system = _ring.fd();
+	_ringed = true;
+	_initSignal.set();
+
+	bool terminated(false);
+	for (;;) {
+		int result = _ring.wait(ex, [this, &terminated](const IOUring::Completion& completion) {
+			Ring* pRing = reinterpret_cast<Ring*>(completion.userData & ~UInt64(RING_OPERATION));
+			if (pRing)
+				return complete(*pRing, UInt8(completion.userData & RING_OPERATION), completion);
+			// termination signal on IOSocket deletion (pipe reader hung up), or cancellation completion
+			if ((completion.userData & RING_OPERATION) == RING_POLL && completion.result > 0 && (completion.result & (EPOLLHUP | EPOLLERR)))
+				terminated = true;
+		});
+		if (result < 0 || terminated)
+			break;
+		if (!_subscribers) {
+			lock_guard<mutex> lock(_mutex);
+			// no more socket to manage and every operation completed?
+			if (!_subscribers && !_operations) {
+				::close(readFD);  // close reader pipe side
+				_ring.close(); // close the system message
+				stop(); // to set running=false!
+				return true;
+			}
+		}
+	}
+	::close(readFD);  // close reader pipe side
+	lock_guard<mutex> lock(_mutex);
+	_ring.close(); // close the system message
+	_operations = 0; // remaining rings are lost as weak pointers with epoll
+	if (ex)
+		return false;
+	if (!_subscribers)
+		return true; // IOSocket deletion
+	ex.set<Ex::Net::System>("dies with remaining sockets managed");
+	return false;
+}
+
+void IOSocket::complete(Ring& ring, UInt8 operation, const IOUring::Completion& completion) {
+	shared<Socket> pSocket(ring.lock());
+	if (!pSocket && !ring.canceled) {
+		// socket deleted without unsubscription, cancel its operations to release the file
+		lock_guard<mutex> lock(_mutex);
+		cancel(ring);
+	}
+	if (ring.canceled)
+		pSocket.reset(); // unsubscribed
+
+	if (operation == RING_SEND)
+		return sent(ring, pSocket, completion.result);
+
+	if (operation == RING_RECEIVE) {
+		UInt16 id;
+		if (completion.buffer(id)) {
+			if (pSocket && completion.result > 0) {
+				const UInt8* data(_ring.buffer(ring.group, id));
+				if (ring.group == RING_GROUP_DATAGRAM) {
+					IOUring::Message message(ring.msg, (UInt8*)data, completion.result);
+					if (!message.truncated()) // impossible, buffer is greater than maximum UDP payload
+						received(ring, pSocket, message.data(), message.size(), message.name());
+				} else
+					received(ring, pSocket, data, completion.result);
+			}
+			Exception ex;
+			if (!_ring.recycle(ex, ring.group, id))
+				WARN(name(), " can't recycle a reception buffer, ", ex);
+		}
+		if (completion.more())
+			return;
+		// last completion of the reception
+		lock_guard<mutex> lock(_mutex);
+		--ring.operations;
+		--_operations;
+		int error(completion.result < 0 ? -completion.result : 0);
+		if (!pSocket)
+			ring.receiving = Ring::RECEIVING_END;
+		else if (completion.result > 0 || error == ENOBUFS || error == ECANCELED) {
+			// multishot stopped by kernel, buffers exhausted, or reception budget exceeded
+			ring.receiving = Ring::RECEIVING_IDLE;
+			receive(ring, *pSocket);
+		} else if (error == ENOTCONN) {
+			ring.receiving = Ring::RECEIVING_IDLE; // waiting connection, rearmed on poll
+		} else if (pSocket->type == Socket::TYPE_STREAM) {
+			// end of stream (error=0) or disconnection, signaled by the Receive action after data received (see resume)
+			ring.receiving = Ring::RECEIVING_CLOSING;
+			ring.error = error;
+			read(pSocket, 0);
+		} else {
+			threadPool.queue<Action>(pSocket->_threadReceive, "SocketError", error, pSocket);
+			if (error == EBADF || error == EINVAL || error == ENOTSOCK || error == EOPNOTSUPP)
+				ring.receiving = Ring::RECEIVING_END;
+			else { // datagram lost, not a disconnection!
+				ring.receiving = Ring::RECEIVING_IDLE;
+				receive(ring, *pSocket);
+			}
+		}
+		return release(ring);
+	}
+
+	if (pSocket && completion.result > 0) {
+		if (!ring.receiving)
+			dispatch(pSocket, completion.result);
+		else {
+			// end and errors are given by the reception, and poll wakes up a reception waiting connection
+			if ((completion.result & EPOLLOUT) && !(completion.result & (EPOLLHUP | EPOLLERR)))
+				write(pSocket, 0);
+			lock_guard<mutex> lock(_mutex);
+			receive(ring, *pSocket);
+		}
+	}
+	if (completion.more())
+		return;
+	// last completion of the poll: unsubscription, or poll stopped by kernel which requires a new one
+	lock_guard<mutex> lock(_mutex);
+	if (pSocket) {
+		Exception ex;
+		if (completion.result < 0) // poll refused, polling again would give the same error
+			ex.set<Ex::Net::System>(strerror(-completion.result));
+		else if (_ring.poll(ex, *pSocket, ring.events(), ring.userData(RING_POLL)))
+			return;
+		WARN(name(), " can't poll again socket ", pSocket->id(), ", ", ex);
+		threadPool.queue<Action>(pSocket->_threadReceive, "SocketError", completion.result < 0 ? -completion.result : NET_ENOBUFS, pSocket);
+	}
+	--ring.operations;
+	--_operations;
+	release(ring);
+}
+
+bool IOSocket::receive(Ring& ring, Socket& socket) {
+	if (ring.receiving != Ring::RECEIVING_IDLE || ring.canceled)
+		return false;
+	{
+		lock_guard<mutex> lock(socket._mutexUndelivered);
+		if ((socket._receiving + socket._undeliveredSize) >= socket.recvBufferSize())
+			return false; // reception budget exceeded, resumed once data delivered
+	}
+	Exception ex;
+	if (!_ring.receive(ex, socket, ring.group, ring.userData(RING_RECEIVE), ring.group == RING_GROUP_DATAGRAM ? &ring.msg : NULL)) {
+		WARN(name(), " can't receive on socket ", socket.id(), ", ", ex);
+		return false;
+	}
+	ring.receiving = Ring::RECEIVING_ON;
+	++ring.operations;
+	++_operations;
+	return true;
+}
+
+void IOSocket::received(Ring& ring, const shared<Socket>& pSocket, const UInt8* data, UInt32 size, const sockaddr* pAddress) {
+	// copy from the provided buffer, immediatly recycled (few buffers are enough whatever the number of sockets)
+	Buffer::Allocator::Tag::Scope tag(_ReceiveTag);
+	shared<Buffer> pBuffer(SET, size);
+	memcpy(pBuffer->data(), data, size);
+	SocketAddress address;
+	if (pAddress)
+		address.set(*pAddress);
+	else
+		address.set(pSocket->peerAddress());
+	if (!pSocket->_address)
+		pSocket->_address.set(IPAddress::Loopback(), 0); // to advise that address is computable
+	pSocket->receive(size);
+	bool exceeded;
+	{
+		lock_guard<mutex> lock(pSocket->_mutexUndelivered);
+		pSocket->_undelivered.emplace_back(move(pBuffer), address);
+		exceeded = (pSocket->_receiving + (pSocket->_undeliveredSize += size)) >= pSocket->recvBufferSize();
+	}
+	if (exceeded) {
+		// reception budget exceeded, stop to receive until delivery (data stay in socket buffer, flow control as with epoll)
+		lock_guard<mutex> lock(_mutex);
+		Exception ignore;
+		if (ring.receiving == Ring::RECEIVING_ON && _ring.cancel(ignore, ring.userData(RING_RECEIVE)))
+			ring.receiving = Ring::RECEIVING_CANCELING;
+	}
+	read(pSocket, 0);
+}
+
+void IOSocket::resume(const shared<Socket>& pSocket) {
+	int error;
+	{
+		lock_guard<mutex> lock(_mutex);
+		if (pSocket->_pReactor != this || !pSocket->_pWeakThis)
+			return;
+		Ring& ring(static_cast<Ring&>(*pSocket->_pWeakThis));
+		if (ring.receiving != Ring::RECEIVING_CLOSING) {
+			receive(ring, *pSocket);
+			return;
+		}
+		ring.receiving = Ring::RECEIVING_END;
+		error = ring.error;
+	}
+	close(pSocket, error);
+}
+
+bool IOSocket::send(const shared<Socket>& pSocket) {
+	if (!_ring || !completes(*pSocket))
+		return false;
+	lock_guard<mutex> lock(_mutex);
+	if (pSocket->_pReactor != this || !pSocket->_pWeakThis)
+		return false;
+	Ring& ring(static_cast<Ring&>(*pSocket->_pWeakThis));
+	lock_guard<mutex> lockSending(pSocket->_mutexSending);
+	if (ring.sending)
+		return true; // its completion continues
+	if (pSocket->_sendings.empty())
+		return false;
+	pSocket->_pacing.scheduled = false;
+	UInt32 budget;
+	if (!pSocket->pace(budget))
+		return true; // flush scheduled
+	if (!ring.pSendings)
+		ring.pSendings.set();
+	Ring::Sendings& sendings(*ring.pSendings);
+	// same messages as Socket::flushSendings (without UDP GSO): one gathered for stream, linked datagrams, budget limited
+	int flags = pSocket->_sendings.front().flags;
+	UInt32 count(0), size(0);
+	for (auto it = pSocket->_sendings.begin(); count < Socket::SEND_BATCH_MAX && it != pSocket->_sendings.end() && it->flags == flags && size < budget; ++it) {
+		if (pSocket->type == Socket::TYPE_DATAGRAM && count && (size + it->size()) > budget)
+			break;
+		sendings.packets.emplace_back(*it, it->address, flags);
+		const Socket::Sending& sending(sendings.packets.back());
+		iovec& iov(sendings.iovecs[count]);
+		iov.iov_base = (void*)sending.data();
+		size += (iov.iov_len = pSocket->type == Socket::TYPE_STREAM ? min(sending.size(), budget - size) : sending.size());
+		if (pSocket->type == Socket::TYPE_STREAM) {
+			++count;
+			continue;
+		}
+		msghdr& msg(sendings.msgs[count++]);
+		memset(&msg, 0, sizeof(msg));
+		if (sending.address) {
+			msg.msg_name = (void*)sending.address.data();
+			msg.msg_namelen = sending.address.size();
+		}
+		msg.msg_iov = &iov;
+		msg.msg_iovlen = 1;
+	}
+	if (pSocket->type == Socket::TYPE_STREAM) {
+		msghdr& msg(sendings.msgs[0]);
+		memset(&msg, 0, sizeof(msg));
+		msg.msg_iov = sendings.iovecs;
+		msg.msg_iovlen = count;
+		if (count > 1)
+			pSocket->_sendSyscallsSaved += count - 1;
+		count = 1;
+	} else if (count > 1)
+		pSocket->_sendSyscallsSaved += count - 1;
+#if defined(MSG_NOSIGNAL)
+	flags |= MSG_NOSIGNAL;
+#endif
+	Exception ex;
+	if (!_ring.send(ex, *pSocket, sendings.msgs, count, flags, ring.userData(RING_SEND))) {
+		WARN(name(), " can't send with io_uring on socket ", pSocket->id(), ", ", ex);
+		sendings.packets.clear();
+		return false; // flush by the Send action
+	}
+	pSocket->_flushing = ring.sending = UInt8(count);
+	++ring.operations;
+	++_operations;
+	return true;
+}
+
+void IOSocket::sent(Ring& ring, const shared<Socket>& pSocket, Int32 result) {
+	bool flushed(false), blocked;
+	int error(result < 0 ? -result : 0);
+	{
+		unique_lock<mutex> lock;
+		if (pSocket)
+			lock = unique_lock<mutex>(pSocket->_mutexSending);
+		if (pSocket) {
+			// messages complete in order (linked), the front of the queue is the message completed
+			UInt32 written(0);
+			if (result >= 0) {
+				if (!pSocket->_address)
+					pSocket->_address.set(IPAddress::Loopback(), 0); // to advise that address is computable
+				pSocket->send(UInt32(result));
+				if (pSocket->type == Socket::TYPE_STREAM)
+					pSocket->popSendings(result, written);
+				else {
+					written += result;
+					pSocket->_sendings.pop_front();
+				}
+			} else if (error == ECANCELED) {
+				error = 0; // previous one failed, stays in queue
+			} else if ((error == NET_ENOTCONN && pSocket->_peerAddress) || error == NET_EWOULDBLOCK) {
+				error = 0;
+				ring.blocked = true; // is connecting, can't send more now (wait writable)
+			} else if (pSocket->type == Socket::TYPE_STREAM) {
+				// fail to send few reliable data, shutdown send!
+				ring.blocked = true;
+				pSocket->close();
+				pSocket->_sendings.clear();
+			} else {
+				// datagram lost
+				written += pSocket->_sendings.front().size();
+				pSocket->_sendings.pop_front();
+			}
+			if (written) {
+				pSocket->_queueing -= written;
+				pSocket->paced(written);
+			}
+			if (error)
+				threadPool.queue<Action>(0, "SocketSend", error, pSocket);
+		}
+		if (++ring.completed < ring.sending)
+			return;
+		// every message completed
+		ring.pSendings->packets.clear();
+		ring.sending = ring.completed = 0;
+		blocked = ring.blocked;
+		ring.blocked = false;
+		if (pSocket) {
+			pSocket->_flushing = 0;
+			flushed = pSocket->_sendings.empty();
+		}
+	}
+	{
+		lock_guard<mutex> lock(_mutex);
+		--ring.operations;
+		--_operations;
+		if (!pSocket)
+			return release(ring);
+	}
+	if (blocked)
+		return; // wait writable, or shutdown on error
+	if (flushed || !send(pSocket))
+		write(pSocket, 0); // onFlush
+}
+
+void IOSocket::cancel(Ring& ring) {
+	if (ring.canceled.exchange(true))
+		return;
+	Exception ignore;
+	_ring.cancel(ignore, ring.userData(RING_POLL));
+	_ring.cancel(ignore, ring.userData(RING_RECEIVE));
+	_ring.cancel(ignore, ring.userData(RING_SEND));
+}
+
+void IOSocket::release(Ring& ring) {
+	if (!ring.operations && (ring.canceled || ring.expired()))
+		delete &ring;
+}
+#endif
+
 bool IOSocket::run(Exception& ex, const volatile bool& requestStop) {
 #if defined(_WIN32)
 	WNDCLASSEX wc;
@@ -481,6 +1087,22 @@ bool IOSocket::run(Exception& ex, const volatile bool& requestStop) {
         _system = kqueue();
 #else
 	epoll_event events[MAXEVENTS];
+#if defined(MONA_IO_URING)
+	if (readFD > 0 && _eventFD > 0 && Net::GetIOUring()) {
+		if (!IOUring::Supported()) {
+			WARN(name(), " can't use io_uring on this system, epoll used rather");
+		} else if (_ring.init(ex) && _ring.provide(ex, RING_GROUP_STREAM, RING_STREAM_BUFFERS, 0x4000) &&
+			_ring.provide(ex, RING_GROUP_DATAGRAM, RING_DATAGRAM_BUFFERS, 0x10000 + 0x40) &&
+			_ring.poll(ex, readFD, EPOLLIN, RING_POLL))
+			return run(ex, readFD);
+		else {
+			WARN(name(), " can't use io_uring, epoll used rather, ", ex);
+			_ring.close();
+			ex = nullptr;
+		}
+	}
+	_ringed = false;
+#endif
 	if(readFD>0 && _eventFD>0 && fcntl(readFD, F_SETFL, fcntl(readFD, F_GETFL, 0) | O_NONBLOCK)!=-1)
 		_system = epoll_create(MAXEVENTS); // Argument is ignored on new system, otherwise must be >= to events[] size
 #endif
@@ -644,36 +1266,9 @@ bool IOSocket::run(Exception& ex, const volatile bool& requestStop) {
 			}
 
 			shared<Socket> pSocket(reinterpret_cast<weak<Socket>*>(event.data.ptr)->lock());
-			if(!pSocket)
-				continue; // socket error
-			// EPOLLIN | EPOLLOUT | EPOLLERR | EPOLLHUP | EPOLLRDHUP
-			// printf("%d => %u\n", pSocket->id(), event.events);
-			int error = 0;
-			if(event.events&EPOLLERR) {
-				socklen_t len(sizeof(error));
-				if(getsockopt(pSocket->id(), SOL_SOCKET, SO_ERROR, (void *)&error, &len)==-1)
-					error = Net::LastError();
-			}
-			if (event.events&EPOLLRDHUP) {
-				// disconnection
-				close(pSocket, error);
-				continue;
-			}
-			if (!(event.events&EPOLLHUP)) { // if socket unexpected close no more read or write!
-				if (event.events&EPOLLIN) {
-					/* even in EPOLLET we can miss the first WRITE event, for example with an UDP socket, its creation makes it writable quickly,
-					so the IOSocket subscribe happens after its WRITABLE state event and we miss its WRITE change state */
-					if (event.events&EPOLLOUT && !error && !pSocket->_opened) // for first Flush requirement!
-						write(pSocket, 0); // before read! Connection!
-					read(pSocket, error);
-					error = 0;
-				} else if (event.events&EPOLLOUT) { // else if because EPOLLET!
-					write(pSocket, error);
-					error = 0;
-				}
-			}
-			if (error) // on few unix system we can get an error without anything else
-				threadPool.queue<Action>(pSocket->_threadReceive, "SocketError", error, pSocket);
+			if(pSocket)
+				dispatch(pSocket, event.events);
+			// else socket error
 #endif
 		}
 
@@ -718,7 +1313,60 @@ void IOSocket::stop() {
 	if (_pIOSRTSocket)
 		_pIOSRTSocket->stop();
 #endif
+	for (unique<IOSocket>& pReactor : _reactors)
+		pReactor->stop();
+	_pacer.stop();
 	Thread::stop();
 }
 
+void IOSocket::pace(const weak<Socket>& weakSocket, UInt32 delay) {
+	_pacer.pace(weakSocket, delay);
+}
+
+void IOSocket::Pacer::pace(const weak<Socket>& weakSocket, UInt32 delay) {
+	lock_guard<mutex> lock(_mutex);
+	_requests.emplace_back(weakSocket, Time::Now() + delay);
+	if (!running())
+		start(PRIORITY_HIGH);
+	wakeUp.set();
+}
+
+bool IOSocket::Pacer::run(Exception& ex, const volatile bool& requestStop) {
+	Timer timer;
+	map<weak<Socket>, unique<Timer::OnTimer>, owner_less<weak<Socket>>> flushes; // one timer by socket
+	vector<weak<Socket>> raised;
+	vector<pair<weak<Socket>, Int64>> requests;
+	while (!requestStop) {
+		{
+			lock_guard<mutex> lock(_mutex);
+			requests.swap(_requests);
+		}
+		Int64 now = Time::Now();
+		for (auto& request : requests) {
+			unique<Timer::OnTimer>& pOnTimer = flushes[request.first];
+			if (!pOnTimer) {
+				const weak<Socket>& weakSocket = request.first;
+				pOnTimer.set([weakSocket, &raised](UInt32 delay) {
+					shared<Socket> pSocket(weakSocket.lock());
+					IOSocket* pReactor(pSocket ? pSocket->_pReactor : NULL);
+					if (pReactor) // flush on the reactor which manages the socket now (the one which has requested pacing can differ)
+						pReactor->write(pSocket, 0);
+					raised.emplace_back(weakSocket); // OnTimer can't be deleted in its call
+					return 0;
+				});
+			}
+			timer.set(*pOnTimer, UInt32(max<Int64>(request.second - now, 1)));
+		}
+		requests.clear();
+		UInt32 timeout = timer.raise();
+		for (const weak<Socket>& weakSocket : raised)
+			flushes.erase(weakSocket);
+		raised.clear();
+		wakeUp.wait(timeout);
+	}
+	for (auto& it : flushes)
+		timer.set(*it.second, 0); // remove timers before their deletion
+	return true;
+}
+
 } // namespace Mona
@@ -0,0 +1,316 @@
+/*
+This file is a part of MonaSolutions Copyright 2017
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or
+modify it under the terms of the the Mozilla Public License v2.0.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+Mozilla Public License v. 2.0 received along this program for more
+details (or else see http://mozilla.org/MPL/2.0/).
+
+*/
+
+#include "Mona/IOUring.h"
+#if defined(MONA_IO_URING)
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+namespace Mona {
+
+#if defined(MONA_IO_URING)
+
+static int Setup(UInt32 entries, io_uring_params& params) {
+	return int(::syscall(__NR_io_uring_setup, entries, &params));
+}
+
+bool IOUring::Supported() {
+	static bool Supported([]() {
+		Exception ex;
+		IOUring ring;
+		if (!ring.init(ex, 4))
+			return false; // not implemented, or forbidden (seccomp, io_uring_disabled sysctl)
+		// multishot recvmsg (6.0) has no feature flag, probe it: a previous kernel rejects IORING_RECV_MULTISHOT with EINVAL
+		if (!ring.provide(ex, 0, 2, 256))
+			return false;
+		int fds[2];
+		if (::socketpair(AF_UNIX, SOCK_DGRAM, 0, fds))
+			return false;
+		msghdr msg;
+		memset(&msg, 0, sizeof(msg));
+		bool multishot(false);
+		if (ring.receive(ex, fds[0], 0, 1, &msg) && ::write(fds[1], "probe", 5) == 5) {
+			ring.wait(ex, [&](const Completion& completion) {
+				UInt16 id;
+				multishot = completion.result > 0 && completion.more() && completion.buffer(id) &&
+					Message(msg, ring.buffer(0, id), completion.result).size() == 5;
+			});
+		}
+		::close(fds[0]);
+		::close(fds[1]);
+		return multishot;
+	}());
+	return Supported;
+}
+
+IOUring::IOUring() : _fd(-1), _sqes(NULL), _sqRing(NULL), _cqRing(NULL), _cqHead(NULL), _cqTail(NULL), _waiter(thread::id()) {}
+
+bool IOUring::init(Exception& ex, UInt32 entries) {
+	close();
+	io_uring_params params;
+	memset(&params, 0, sizeof(params));
+	// completions run when the waiting thread enters the kernel rather than interrupting it (5.19), else default setup
+	params.flags = IORING_SETUP_COOP_TASKRUN | IORING_SETUP_SUBMIT_ALL;
+	if ((_fd = Setup(entries, params)) < 0 && errno == EINVAL) {
+		memset(&params, 0, sizeof(params));
+		_fd = Setup(entries, params);
+	}
+	if (_fd < 0) {
+		ex.set<Ex::System>("io_uring setup failed, ", strerror(errno));
+		return false;
+	}
+	_sqRingSize = params.sq_off.array + params.sq_entries * sizeof(UInt32);
+	_cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+	if (params.features & IORING_FEAT_SINGLE_MMAP)
+		_sqRingSize = _cqRingSize = max(_sqRingSize, _cqRingSize);
+	_sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+
+	_sqRing = mmap(NULL, _sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _fd, IORING_OFF_SQ_RING);
+	if (_sqRing == MAP_FAILED)
+		_sqRing = NULL;
+	else if (params.features & IORING_FEAT_SINGLE_MMAP)
+		_cqRing = _sqRing;
+	else if ((_cqRing = mmap(NULL, _cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _fd, IORING_OFF_CQ_RING)) == MAP_FAILED)
+		_cqRing = NULL;
+	if (_cqRing && (_sqes = (io_uring_sqe*)mmap(NULL, _sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _fd, IORING_OFF_SQES)) == MAP_FAILED)
+		_sqes = NULL;
+	if (!_sqes) {
+		ex.set<Ex::System>("io_uring mapping failed, ", strerror(errno));
+		close();
+		return false;
+	}
+
+	_sqHead = (UInt32*)((UInt8*)_sqRing + params.sq_off.head);
+	_sqTail = (UInt32*)((UInt8*)_sqRing + params.sq_off.tail);
+	_sqMask = *(UInt32*)((UInt8*)_sqRing + params.sq_off.ring_mask);
+	_sqArray = (UInt32*)((UInt8*)_sqRing + params.sq_off.array);
+	_cqHead = (UInt32*)((UInt8*)_cqRing + params.cq_off.head);
+	_cqTail = (UInt32*)((UInt8*)_cqRing + params.cq_off.tail);
+	_cqMask = *(UInt32*)((UInt8*)_cqRing + params.cq_off.ring_mask);
+	_cqes = (io_uring_cqe*)((UInt8*)_cqRing + params.cq_off.cqes);
+	return true;
+}
+
+void IOUring::close() {
+	if (_sqes)
+		munmap(_sqes, _sqesSize);
+	if (_cqRing && _cqRing != _sqRing)
+		munmap(_cqRing, _cqRingSize);
+	if (_sqRing)
+		munmap(_sqRing, _sqRingSize);
+	_sqes = NULL;
+	_sqRing = _cqRing = NULL;
+	_cqHead = _cqTail = NULL;
+	if (_fd >= 0) {
+		::close(_fd);
+		_fd = -1;
+	}
+	// buffers after the ring closing which releases them
+	for (Group& group : _groups) {
+		if (group.data)
+			munmap(group.data, group.count * group.size);
+	}
+	_groups.clear();
+	_waiter = thread::id();
+}
+
+bool IOUring::enter(Exception& ex, UInt32 toSubmit, UInt32 minComplete) {
+	int result;
+	while ((result = int(::syscall(__NR_io_uring_enter, _fd, toSubmit, minComplete, minComplete ? IORING_ENTER_GETEVENTS : 0, NULL, 0))) < 0) {
+		if (errno == EINTR)
+			continue;
+		if (errno == EAGAIN || errno == EBUSY)
+			return true; // completion queue is full (overflow), completions have to be read before
+
+		ex.set<Ex::System>("io_uring enter failed, ", strerror(errno));
+		return false;
+	}
+	return true;
+}
+
+bool IOUring::reserve(Exception& ex, UInt32 count) {
+	if (_fd < 0) {
+		ex.set<Ex::Intern>("io_uring not initialized");
+		return false;
+	}
+	if ((*_sqTail + count - __atomic_load_n(_sqHead, __ATOMIC_ACQUIRE)) <= (_sqMask + 1))
+		return true;
+	// submission queue full, enter what is pending to make place
+	if (!enter(ex, _sqMask + 1, 0))
+		return false;
+	if ((*_sqTail + count - __atomic_load_n(_sqHead, __ATOMIC_ACQUIRE)) <= (_sqMask + 1))
+		return true;
+	ex.set<Ex::System>("io_uring submission queue full");
+	return false;
+}
+
+void IOUring::prepare(UInt32 tail, UInt8 opcode, int fd, const void* address, UInt32 size, UInt64 offset, UInt64 userData, UInt32 flags, UInt8 sqeFlags, UInt16 group, UInt16 priority) {
+	UInt32 index = tail & _sqMask;
+	io_uring_sqe& sqe(_sqes[index]);
+	memset(&sqe, 0, sizeof(sqe));
+	sqe.opcode = opcode;
+	sqe.flags = sqeFlags;
+	sqe.fd = fd;
+	sqe.addr = UInt64(address);
+	sqe.len = size;
+	sqe.off = offset;
+	sqe.user_data = userData;
+	sqe.buf_group = group;
+	sqe.ioprio = priority; // flags for receptions and sendings
+	if (opcode == IORING_OP_POLL_ADD)
+		sqe.poll32_events = flags;
+	else
+		sqe.rw_flags = flags;
+	_sqArray[index] = index;
+}
+
+bool IOUring::commit(Exception& ex, UInt32 tail) {
+	__atomic_store_n(_sqTail, tail, __ATOMIC_RELEASE);
+	if (this_thread::get_id() == _waiter)
+		return true; // entered on next wait, with other submissions of this completion pass
+	return enter(ex, _sqMask + 1, 0); // all pending, maybe some of the waiting thread not yet entered
+}
+
+bool IOUring::submit(Exception& ex, UInt8 opcode, int fd, const void* address, UInt32 size, UInt64 offset, UInt64 userData, UInt32 flags, UInt8 sqeFlags, UInt16 group, UInt16 priority) {
+	lock_guard<mutex> lock(_mutex);
+	if (!reserve(ex, 1))
+		return false;
+	prepare(*_sqTail, opcode, fd, address, size, offset, userData, flags, sqeFlags, group, priority);
+	return commit(ex, *_sqTail + 1);
+}
+
+bool IOUring::provide(Exception& ex, UInt16 group, UInt16 count, UInt32 size) {
+	if (_fd < 0) {
+		ex.set<Ex::Intern>("io_uring not initialized");
+		return false;
+	}
+	if (!count || !size) {
+		ex.set<Ex::Intern>("io_uring buffer group ", group, " empty");
+		return false;
+	}
+	if (group >= _groups.size())
+		_groups.resize(group + 1, Group({ NULL, 0, 0, 0, 0 }));
+	Group& buffers(_groups[group]);
+	if (buffers.data) {
+		ex.set<Ex::Intern>("io_uring buffer group ", group, " already provided");
+		return false;
+	}
+	// MAP_NORESERVE: pages are committed on first kernel filling, few ones if data received are small
+	void* pData = mmap(NULL, count * size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+	if (pData == MAP_FAILED) {
+		ex.set<Ex::System>("io_uring buffers mapping failed, ", strerror(errno));
+		return false;
+	}
+	buffers.data = (UInt8*)pData;
+	buffers.size = size;
+	buffers.count = count;
+	// fd = number of buffers, offset = first buffer id, a failure gives a completion with userData=0
+	return submit(ex, IORING_OP_PROVIDE_BUFFERS, count, pData, size, 0, 0, 0, IOSQE_CQE_SKIP_SUCCESS, group);
+}
+
+bool IOUring::recycle(Exception& ex, UInt16 group, UInt16 id) {
+	// kernel consumes buffers in the order provided, so consecutive ids are given back in one submission
+	Group& buffers(_groups[group]);
+	if (buffers.recycled && id == (buffers.recycling + buffers.recycled)) {
+		++buffers.recycled;
+		return true;
+	}
+	bool success(!buffers.recycled || submit(ex, IORING_OP_PROVIDE_BUFFERS, buffers.recycled, buffer(group, buffers.recycling), buffers.size, buffers.recycling, 0, 0, IOSQE_CQE_SKIP_SUCCESS, group));
+	buffers.recycling = id;
+	buffers.recycled = 1;
+	return success;
+}
+
+bool IOUring::recycle(Exception& ex) {
+	for (UInt16 group = 0; group < _groups.size(); ++group) {
+		Group& buffers(_groups[group]);
+		if (!buffers.recycled)
+			continue;
+		UInt16 count(buffers.recycled);
+		buffers.recycled = 0;
+		if (!submit(ex, IORING_OP_PROVIDE_BUFFERS, count, buffer(group, buffers.recycling), buffers.size, buffers.recycling, 0, 0, IOSQE_CQE_SKIP_SUCCESS, group))
+			return false;
+	}
+	return true;
+}
+
+bool IOUring::poll(Exception& ex, int fd, UInt32 events, UInt64 userData, bool multishot) {
+	// len = flags for POLL_ADD, edge triggered by default (without IORING_POLL_ADD_LEVEL)
+	return submit(ex, IORING_OP_POLL_ADD, fd, NULL, multishot ? IORING_POLL_ADD_MULTI : 0, 0, userData, events);
+}
+bool IOUring::receive(Exception& ex, int fd, UInt16 group, UInt64 userData, msghdr* pMsg) {
+	// buffers given back before, a reception rearmed on ENOBUFS would stop immediatly
+	if (this_thread::get_id() == _waiter && !recycle(ex))
+		return false;
+	// data size is the one of the buffer selected
+	if (!pMsg)
+		return submit(ex, IORING_OP_RECV, fd, NULL, 0, 0, userData, 0, IOSQE_BUFFER_SELECT, group, IORING_RECV_MULTISHOT);
+	return submit(ex, IORING_OP_RECVMSG, fd, pMsg, 1, 0, userData, 0, IOSQE_BUFFER_SELECT, group, IORING_RECV_MULTISHOT);
+}
+bool IOUring::send(Exception& ex, int fd, const msghdr* msgs, UInt32 count, int flags, UInt64 userData) {
+	// in one submission, a chain can't be broken by a submission of another thread
+	lock_guard<mutex> lock(_mutex);
+	if (!reserve(ex, count))
+		return false;
+	UInt32 tail = *_sqTail;
+	for (UInt32 i = 0; i < count; ++i)
+		prepare(tail++, IORING_OP_SENDMSG, fd, &msgs[i], 1, 0, userData, flags, (i + 1) < count ? IOSQE_IO_LINK : 0);
+	return commit(ex, tail);
+}
+bool IOUring::read(Exception& ex, int fd, void* data, UInt32 size, UInt64 offset, UInt64 userData) {
+	return submit(ex, IORING_OP_READ, fd, data, size, offset, userData);
+}
+bool IOUring::write(Exception& ex, int fd, const void* data, UInt32 size, UInt64 offset, UInt64 userData) {
+	return submit(ex, IORING_OP_WRITE, fd, data, size, offset, userData);
+}
+bool IOUring::nop(Exception& ex, UInt64 userData) {
+	return submit(ex, IORING_OP_NOP, -1, NULL, 0, 0, userData);
+}
+bool IOUring::cancel(Exception& ex, UInt64 userData) {
+	// cancel_flags = flags for ASYNC_CANCEL
+	return submit(ex, IORING_OP_ASYNC_CANCEL, -1, (const void*)userData, 0, 0, 0, IORING_ASYNC_CANCEL_ALL);
+}
+
+IOUring::Message::Message(const msghdr& msg, UInt8* buffer, UInt32 size) : _pOut((const io_uring_recvmsg_out*)buffer) {
+	UInt32 header = sizeof(io_uring_recvmsg_out) + msg.msg_namelen + msg.msg_controllen;
+	_data = buffer + header;
+	_size = size > header ? min(_pOut->payloadlen, size - header) : 0;
+}
+
+#else
+
+bool IOUring::Supported() { return false; }
+IOUring::IOUring() : _fd(-1) {}
+bool IOUring::init(Exception& ex, UInt32 entries) {
+	ex.set<Ex::Unsupported>("io_uring not available on this platform");
+	return false;
+}
+void IOUring::close() {}
+
+#endif
+
+IOUring::~IOUring() {
+	close();
+}
+
+
+} // namespace Mona
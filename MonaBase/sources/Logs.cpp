@@ -34,6 +34,10 @@ atomic<LOG_LEVEL>		Logs::_Level(LOG_DEFAULT); // default log level
 Logs::Loggers			Logs::_Loggers;
 thread_local bool		Logs::_Logging(false);
 std::string				Logs::_Critic;
+UInt32					Logs::_LoggingThreadId(0);
+Int64					Logs::_LoggingTime(0);
+Logs::Async				Logs::_Async; // after _Loggers to write pending logs on destruction
+thread_local shared<Logs::Ring> Logs::Async::_Ring;
 
 bool Logs::LastCritic(string& critic) {
 	lock_guard<mutex> lock(_Mutex);
@@ -65,7 +69,25 @@ void Logs::SetDump(const char* name) {
 	}
 }
 
+void Logs::SetAsynchronous(UInt32 capacity, bool block) {
+	_Async.stop();
+	lock_guard<mutex> lock(_Mutex);
+	_Async.flush();
+	_Loggers.flush();
+	_Async.reset(capacity, block);
+	if (capacity)
+		_Async.start();
+}
+
+void Logs::Flush() {
+	lock_guard<mutex> lock(_Mutex);
+	_Async.flush();
+	_Loggers.flush();
+}
+
 void Logs::Dump(const string& header, const UInt8* data, UInt32 size) {
+	if (_Async.capacity)
+		_Async.flush();
 	Buffer out;
 	Util::Dump(data, (_DumpLimit<0 || size<UInt32(_DumpLimit)) ? size : _DumpLimit, out);
 	for (auto& it : _Loggers) {
@@ -75,7 +97,21 @@ void Logs::Dump(const string& header, const UInt8* data, UInt32 size) {
 	_Loggers.flush();
 }
 
+void Logs::Loggers::log(LOG_LEVEL level, const char* file, long line, const string& message, UInt32 threadId, Int64 time) {
+	_file.set(file);
+	_LoggingThreadId = threadId;
+	_LoggingTime = time;
+	for (auto& it : self) {
+		if (*it.second && !it.second->log(level, _file, line, message))
+			fail(*it.second);
+	}
+}
+
 void Logs::Loggers::flush() {
+	for (auto& it : self) {
+		if (*it.second && !it.second->flush())
+			fail(*it.second);
+	}
 	while (!_failed.empty()) {
 		Logger& logger(*_failed.front());
 		String message(logger.name, " log has failed");
@@ -86,8 +122,10 @@ void Logs::Loggers::flush() {
 		}
 		_failed.pop_back();
 		erase(logger.name); // erase here to remove it from _Loggers before dispatching loop
+		_LoggingThreadId = Thread::CurrentId();
+		_LoggingTime = Time::Now();
 		for (auto& it : _Loggers) {
-			if (*it.second && !it.second->log(LOG_ERROR, __FILE__, __LINE__, message))
+			if (*it.second && (!it.second->log(LOG_ERROR, __FILE__, __LINE__, message) || !it.second->flush()))
 				_failed.emplace_back(it.second.get());
 		}
 		if (fatal) // fatal is last to get logs on the other targets
@@ -95,5 +133,85 @@ void Logs::Loggers::flush() {
 	}
 }
 
+Logs::Async::~Async() {
+	stop();
+	lock_guard<mutex> lock(_Mutex);
+	flush();
+	_Loggers.flush();
+	reset(0, false); // logs of next static destructions are synchronous
+}
+
+Logs::Ring* Logs::Async::ring() {
+	if (_Ring && !_Ring->closed)
+		return _Ring.get();
+	lock_guard<mutex> lock(_mutex);
+	if (!capacity)
+		return NULL;
+	_rings.emplace_back(SET, capacity);
+	return (_Ring = _rings.back()).get();
+}
+
+void Logs::Async::reset(UInt32 capacity, bool block) {
+	lock_guard<mutex> lock(_mutex);
+	for (shared<Ring>& pRing : _rings) {
+		pRing->closed = true;
+		// wait the end of a push in progress, a push seeing closed falls back on a synchronous log
+		while (pRing->writing)
+			this_thread::yield();
+		drain(*pRing);
+	}
+	_rings.clear();
+	if (capacity) {
+		// round up to a power of 2 to index entries with a mask
+		UInt32 size(1);
+		while (size < capacity && size < 0x80000000)
+			size <<= 1;
+		capacity = size;
+	}
+	this->block = block;
+	this->capacity = capacity;
+}
+
+void Logs::Async::flush() {
+	lock_guard<mutex> lock(_mutex);
+	for (auto it = _rings.begin(); it != _rings.end();) {
+		Ring& ring(**it);
+		// ring referenced just by _rings => thread is gone, read before draining to not lose its last logs
+		bool orphan = it->use_count() == 1;
+		drain(ring);
+		if (orphan)
+			it = _rings.erase(it);
+		else
+			++it;
+	}
+}
+
+void Logs::Async::drain(Ring& ring) {
+	UInt32 head = ring.head.load(memory_order_acquire);
+	UInt32 tail = ring.tail.load(memory_order_relaxed);
+	while (tail != head) {
+		Ring::Entry& entry = ring.entries[tail & ring.mask];
+		_Loggers.log(entry.level, entry.file.c_str(), entry.line, entry.message, ring.threadId, entry.time);
+		if (entry.message.capacity() > 0xFF) {
+			entry.message.resize(0xFF);
+			entry.message.shrink_to_fit();
+		}
+		ring.tail.store(++tail, memory_order_release); // free entry immediatly for a blocked producer
+	}
+}
+
+bool Logs::Async::run(Exception& ex, const volatile bool& requestStop) {
+	_Logging = true; // logs of loggers are ignored as on synchronous way
+	while (!requestStop) {
+		if (!pending.exchange(false)) {
+			wakeUp.wait();
+			continue;
+		}
+		lock_guard<mutex> lock(_Mutex);
+		flush();
+		_Loggers.flush(); // one write by batch
+	}
+	return true;
+}
 
 } // namespace Mona
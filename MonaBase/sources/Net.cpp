@@ -89,7 +89,7 @@ const char* Net::ErrorToMessage(int error) {
 }
 
 
-Net::Net() {
+Net::Net() : _ioUring(false) {
 #if defined(_WIN32)
 	WORD    version = MAKEWORD(2, 2);
 	WSADATA data;
@@ -20,12 +20,100 @@ using namespace std;
 
 namespace Mona {
 
+Parameters::Map::Map(const Map& other) : _map(other._map), _count(0) {
+	if (!other._slots.empty())
+		index();
+}
+
+void Parameters::Map::index() {
+	for (auto it = _map.begin(); it != _map.end(); ++it)
+		index(Hash(it->first), it);
+}
+
+UInt32 Parameters::Map::Hash(const string& key) {
+	// FNV-1a on lower case, until the first null character like String::ICompare
+	UInt32 hash(2166136261);
+	for (char c : key) {
+		if (!c)
+			break;
+		if (c >= 'A' && c <= 'Z')
+			c += 'a' - 'A';
+		hash = (hash ^ UInt8(c)) * 16777619;
+	}
+	return hash ? hash : 1;
+}
+
+void Parameters::Map::index(UInt32 hash, const Container::iterator& it) {
+	if (++_count * 2 > _slots.size()) {
+		// grow and rehash
+		vector<Slot> slots(move(_slots));
+		_slots.resize(slots.empty() ? 32 : (slots.size() * 2));
+		_count = 1;
+		for (Slot& slot : slots) {
+			if (slot.hash)
+				index(slot.hash, slot.it);
+		}
+	}
+	UInt32 mask(_slots.size() - 1);
+	UInt32 i(hash & mask);
+	while (_slots[i].hash)
+		i = (i + 1) & mask;
+	_slots[i].hash = hash;
+	_slots[i].it = it;
+}
+
+Parameters::const_iterator Parameters::Map::find(const string& key, UInt32 hash) const {
+	UInt32 mask(_slots.size() - 1);
+	for (UInt32 i = hash & mask; _slots[i].hash; i = (i + 1) & mask) {
+		if (_slots[i].hash == hash && String::ICompare(_slots[i].it->first, key) == 0)
+			return _slots[i].it;
+	}
+	return end();
+}
+
+pair<Parameters::Map::Container::iterator, bool> Parameters::Map::index(const string& key) {
+	if (_slots.empty()) {
+		const auto& result(_map.emplace(key, string()));
+		if (result.second && _map.size() > INDEX_MIN)
+			index();
+		return result;
+	}
+	UInt32 hash(Hash(key));
+	const_iterator it(find(key, hash));
+	if (it != end())
+		return pair<Container::iterator, bool>(_map.erase(it, it), false); // const_iterator to iterator
+	const auto& result(_map.emplace(key, string()));
+	index(hash, result.first);
+	return result;
+}
+
+Parameters::const_iterator Parameters::Map::erase(const_iterator it) {
+	if (_slots.empty())
+		return _map.erase(it);
+	// remove from index with a backward shift of the following slots (no tombstone)
+	UInt32 mask(_slots.size() - 1);
+	UInt32 i(Hash(it->first) & mask);
+	while (_slots[i].it != it)
+		i = (i + 1) & mask;
+	for (UInt32 j = (i + 1) & mask; _slots[j].hash; j = (j + 1) & mask) {
+		UInt32 ideal(_slots[j].hash & mask);
+		// move slot j to the free slot i if its ideal position is not in (i, j]
+		if (i <= j ? (ideal <= i || ideal > j) : (ideal <= i && ideal > j)) {
+			_slots[i] = _slots[j];
+			i = j;
+		}
+	}
+	_slots[i].hash = 0;
+	--_count;
+	return _map.erase(it);
+}
+
 Parameters& Parameters::setParams(const Parameters& other) {
 	// clear self!
 	clear();
 	// copy data
 	if (other.count())
-		_pMap.set() = *other._pMap;
+		_pMap.set(*other._pMap);
 	// onChange!
 	for (auto& it : self)
 		onParamChange(it.first, &it.second);
@@ -18,6 +18,10 @@ details (or else see http://mozilla.org/MPL/2.0/).
 #include "Mona/FileSystem.h"
 #include "Mona/Util.h"
 #include "Mona/File.h"
+#include "Mona/Crypto.h"
+#include "Mona/BinaryReader.h"
+#include "Mona/BinaryWriter.h"
+#include "Mona/Logs.h"
 #include <openssl/evp.h>
 
 
@@ -25,14 +29,206 @@ using namespace std;
 
 namespace Mona {
 
+/*!
+Log record: size(4) crc32(4) type(1) path(7bit size + string) value */
+enum LogType {
+	LOG_ADD = 1,
+	LOG_REMOVE,
+	LOG_CLEAR
+};
+static const UInt32 _CompactionSize(0x100000); // no compaction under 1MB
+
+static UInt32 WriteRecord(Buffer& buffer, LogType type, const string& path, const Binary& value) {
+	UInt32 position(buffer.size());
+	BinaryWriter(buffer).next(8).write8(type).write7Bit<UInt32>(path.size()).write(path).write(value);
+	UInt32 size(buffer.size() - position - 8);
+	BinaryWriter(buffer.data() + position, 8).write32(size).write32(Crypto::ComputeCRC32(buffer.data() + position + 8, size));
+	return size + 8;
+}
+
+static string& LogPath(string& path) {
+	// Same formalization than folders format (to avoid possible /../.. issue), "" for root and "/path" else
+	if (path.empty() || (path.front() != '/' && path.front() != '\\'))
+		path.insert(0, "/");
+	FileSystem::Resolve(path);
+	while (!path.empty() && path.back() == '/')
+		path.pop_back();
+	return path;
+}
+
 void PersistentData::load(Exception& ex, const string& rootDir, const ForEach& forEach, bool disableTransaction) {
 	flush();
 	_disableTransaction = disableTransaction;
 	FileSystem::MakeFile(_rootPath=rootDir);
-	loadDirectory(ex,_rootPath , "", forEach);
+	if (format == FORMAT_LOG)
+		loadLog(ex, forEach);
+	else
+		loadDirectory(ex,_rootPath , "", forEach);
 	_disableTransaction = false;
 }
 
+void PersistentData::loadLog(Exception& ex, const ForEach& forEach) {
+	_pLog.reset();
+	_records.clear();
+	_logBuffer.clear();
+
+	// migration of a FORMAT_FOLDERS storage
+	string folder(_rootPath);
+	FileSystem::MakeFolder(folder);
+	bool migration = FileSystem::Exists(folder);
+	if (migration) {
+		loadDirectory(ex, folder, "", [this](const string& path, const Packet& packet) {
+			_records[path].value.set(move(packet)); // bufferize
+		});
+	}
+
+	bool compaction(migration);
+	if (!readLog(ex, _records, compaction)) {
+		// reading error, abort rather than to rewrite the log with just a part of records
+		_records.clear();
+		_logSize = _aliveSize = 0;
+		return;
+	}
+	// compaction rewrites a corrupted log too (to append after the last valid record)
+	_aliveSize = 0;
+	for (auto& it : _records) {
+		forEach(it.first, it.second.value);
+		_aliveSize += it.second.size;
+	}
+	if (compaction || (_logSize >= _CompactionSize && _logSize > 2 * _aliveSize)) {
+		if (writeLog(ex, _records) && migration)
+			FileSystem::Delete(ex, folder, FileSystem::MODE_HEAVY); // log written and synced, folders can be removed
+	}
+	for (auto& it : _records)
+		it.second.value = nullptr; // release log data
+}
+
+bool PersistentData::readLog(Exception& ex, Records& records, bool& corrupted) {
+	File file(_rootPath + ".log", File::MODE_READ);
+	if (!file.exists(true)) {
+		_logSize = 0;
+		return true; // no log yet
+	}
+	if (!file.load(ex))
+		return false;
+	// one sequential reading
+	shared<Buffer> pBuffer(SET, range<UInt32>(file.size()));
+	UInt32 readen(0);
+	while (readen < pBuffer->size()) {
+		int result = file.read(ex, pBuffer->data() + readen, pBuffer->size() - readen);
+		if (result <= 0) {
+			if (!ex)
+				ex.set<Ex::System::File>(file.path(), " reading interrupted after ", readen, " bytes on ", pBuffer->size());
+			return false;
+		}
+		readen += result;
+	}
+	Packet log(pBuffer);
+	records.reserve(records.size() + log.size() / 64);
+
+	BinaryReader reader(log.data(), log.size());
+	string path;
+	while (reader.available() >= 8) {
+		UInt32 size = reader.read32();
+		UInt32 crc = reader.read32();
+		if (!size || size > reader.available() || Crypto::ComputeCRC32(reader.current(), size) != crc)
+			break;
+		BinaryReader record(reader.current(), size);
+		reader.next(size);
+		UInt8 type = record.read8();
+		record.read(record.read7Bit<UInt32>(), path);
+		switch (type) {
+			case LOG_ADD: {
+				Record& entry = records[path];
+				entry.size = size + 8;
+				entry.value.set(move(log), record.current(), record.available()); // shares log buffer
+				break;
+			}
+			case LOG_REMOVE:
+				records.erase(path);
+				break;
+			case LOG_CLEAR:
+				records.clear();
+				break;
+			default:; // unknown record, ignore it
+		}
+	}
+	_logSize = reader.position();
+	if (!reader.available())
+		return true;
+	corrupted = true;
+	ex.set<Ex::Format>(file.path(), " corrupted after ", reader.position(), " bytes, following ", reader.available(), " bytes ignored");
+	return true;
+}
+
+bool PersistentData::writeLog(Exception& ex, Records& records) {
+	// write alive entries in a new log, then replace the current log
+	_pLog.reset();
+	string path(_rootPath + ".log");
+	string newPath(path + ".new"), parent;
+	if (!FileSystem::CreateDirectory(ex, FileSystem::GetParent(path, parent), FileSystem::MODE_HEAVY))
+		return false;
+	UInt64 aliveSize; // assigned on success only, to keep counters of the current log on failure
+	{
+		File file(newPath, File::MODE_WRITE);
+		Buffer buffer;
+		aliveSize = 0;
+		for (auto& it : records) {
+			aliveSize += (it.second.size = WriteRecord(buffer, LOG_ADD, it.first, it.second.value));
+			if (buffer.size() < 0x100000)
+				continue;
+			if (!file.write(ex, buffer.data(), buffer.size()))
+				return false;
+			buffer.clear();
+		}
+		if (!file.write(ex, buffer.data(), buffer.size()) || !file.sync(ex))
+			return false;
+	}
+	if (!FileSystem::Rename(newPath, path)) {
+		// on Windows rename fails if destination exists
+		if (!FileSystem::Delete(ex, path) || !FileSystem::Rename(newPath, path)) {
+			ex.set<Ex::System::File>("Impossible to replace ", path, " by ", newPath);
+			return false;
+		}
+	}
+	_logSize = _aliveSize = aliveSize;
+	return true;
+}
+
+bool PersistentData::flushLog(Exception& ex) {
+	if (_logBuffer.size()) {
+		if (!_pLog) {
+			string path(_rootPath + ".log"), parent;
+			if (!FileSystem::CreateDirectory(ex, FileSystem::GetParent(path, parent), FileSystem::MODE_HEAVY))
+				return false;
+			_pLog.set(path, File::MODE_APPEND);
+		}
+		// one write and one fsync by batch of entries
+		bool written = _pLog->write(ex, _logBuffer.data(), _logBuffer.size()) && _pLog->sync(ex);
+		_logSize += _logBuffer.size();
+		_logBuffer.clear();
+		if (!written)
+			return false;
+	}
+	if (_logSize < _CompactionSize || _logSize <= 2 * _aliveSize)
+		return true;
+	// compaction, more obsolete than alive data.
+	// On failure the current log stays valid, so error is displayed and compaction is retried on next flush
+	Exception exCompaction;
+	Records records;
+	bool corrupted(false);
+	if (!readLog(exCompaction, records, corrupted) || !writeLog(exCompaction, records)) {
+		ERROR("Compaction of ", _rootPath, ".log failed, ", exCompaction);
+		return true;
+	}
+	if (exCompaction)
+		WARN(exCompaction);
+	for (auto& it : records)
+		it.second.value = nullptr; // release log data
+	_records = move(records);
+	return true;
+}
+
 bool PersistentData::run(Exception& ex, const volatile bool& requestStop) {
 
 	for (;;) {
@@ -44,6 +240,7 @@ bool PersistentData::run(Exception& ex, const volatile bool& requestStop) {
 				if (_entries.empty()) {
 					if (!timeout && !requestStop)
 						break; // wait more
+					_pLog.reset(); // release log file while idle
 					stop(); // to set _stop immediatly!
 					return true;
 				}
@@ -57,12 +254,38 @@ bool PersistentData::run(Exception& ex, const volatile bool& requestStop) {
 					return false;
 				}
 			}
+			if (!flushLog(ex)) {
+				stop();
+				return false;
+			}
 		}
 	}
 }
 
 
 void PersistentData::processEntry(Exception& ex,Entry& entry) {
+	if (format == FORMAT_LOG) {
+		if (entry.clearing) {
+			_records.clear();
+			_aliveSize = 0;
+			WriteRecord(_logBuffer, LOG_CLEAR, String::Empty(), Packet::Null());
+			return;
+		}
+		if (entry) {
+			UInt32 size = WriteRecord(_logBuffer, LOG_ADD, LogPath(entry.path), entry);
+			Record& record = _records[entry.path];
+			_aliveSize = _aliveSize + size - record.size;
+			record.size = size;
+			return;
+		}
+		const auto& it = _records.find(LogPath(entry.path));
+		if (it == _records.end())
+			return; // nothing to remove
+		WriteRecord(_logBuffer, LOG_REMOVE, entry.path, Packet::Null());
+		_aliveSize -= it->second.size;
+		_records.erase(it);
+		return;
+	}
 	if (entry.clearing) {
 		FileSystem::Delete(ex, _rootPath, FileSystem::MODE_HEAVY);
 		return;
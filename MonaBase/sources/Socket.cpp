@@ -16,8 +16,17 @@ details (or else see http://mozilla.org/MPL/2.0/).
 
 
 #include "Mona/Socket.h"
+#include "Mona/IOSocket.h"
+#include "Mona/File.h"
 #if !defined(_WIN32)
 #include <fcntl.h>
+#include <netinet/udp.h>
+#endif
+#if defined(__linux__)
+#include <sys/sendfile.h>
+#if !defined(SO_MAX_PACING_RATE)
+#define SO_MAX_PACING_RATE 47
+#endif
 #endif
 
 
@@ -29,7 +38,7 @@ Socket::Socket(Type type) :
 #if !defined(_WIN32)
 	_pWeakThis(NULL), 
 #endif
-	_opened(false), pDecoder(NULL), externDecoder(false), _nonBlockingMode(false), _listening(false), _receiving(0), _queueing(0), _recvBufferSize(Net::GetRecvBufferSize()), _sendBufferSize(Net::GetSendBufferSize()), _reading(0), type(type), _recvTime(0), _sendTime(0), _id(NET_INVALID_SOCKET), _threadReceive(0) {
+	_opened(false), pDecoder(NULL), externDecoder(false), _nonBlockingMode(false), _listening(false), _receiving(0), _queueing(0), _sendSyscallsSaved(0), _gso(true), _recvBufferSize(Net::GetRecvBufferSize()), _sendBufferSize(Net::GetSendBufferSize()), _reading(0), _undeliveredSize(0), _flushing(0), type(type), _recvTime(0), _sendTime(0), _id(NET_INVALID_SOCKET), _pReactor(NULL) {
 
 	if (type < TYPE_OTHER) {
 		_id = ::socket(AF_INET6, type, 0);
@@ -46,7 +55,7 @@ Socket::Socket(NET_SOCKET id, const sockaddr& addr, Type type) : _peerAddress(ad
 #if !defined(_WIN32)
 	_pWeakThis(NULL),
 #endif
-	_opened(false), pDecoder(NULL), externDecoder(false), _nonBlockingMode(false), _listening(false), _receiving(0), _queueing(0), _recvBufferSize(Net::GetRecvBufferSize()), _sendBufferSize(Net::GetSendBufferSize()), _reading(0), type(type), _recvTime(Time::Now()), _sendTime(0), _id(id), _threadReceive(0) {
+	_opened(false), pDecoder(NULL), externDecoder(false), _nonBlockingMode(false), _listening(false), _receiving(0), _queueing(0), _sendSyscallsSaved(0), _gso(true), _recvBufferSize(Net::GetRecvBufferSize()), _sendBufferSize(Net::GetSendBufferSize()), _reading(0), _undeliveredSize(0), _flushing(0), type(type), _recvTime(Time::Now()), _sendTime(0), _id(id), _pReactor(NULL) {
 
 	if (type < TYPE_OTHER)
 		init();
@@ -162,6 +171,12 @@ bool Socket::processParams(Exception& ex, const Parameters& parameters, const ch
 		result = setRecvBufferSize(ex, value);
 	if (processParam(parameters, "sendBufferSize", value, prefix) || (bufferSizeRead || processParam(parameters, "bufferSize", value, prefix)))
 		result = setSendBufferSize(ex, value) && result;
+	UInt64 rate;
+	if (processParam(parameters, "pacingRate", rate, prefix)) {
+		UInt32 burst(0);
+		processParam(parameters, "pacingBurst", burst, prefix);
+		result = setPacing(ex, rate, burst) && result;
+	}
 	return result;
 }
 
@@ -433,6 +448,86 @@ int Socket::receive(Exception& ex, void* buffer, UInt32 size, int flags, SocketA
 	return rc;
 }
 
+int Socket::receive(Exception& ex, shared<Buffer>* pBuffers, SocketAddress* addresses, UInt32 count) {
+	if (_ex) {
+		ex = _ex;
+		return -1;
+	}
+	// size on first datagram, and at less 2048 to avoid a NET_EMSGSIZE error (where packet is lost!), 2048 is greater than max possible MTU (~1500 bytes)
+	UInt32 size(available());
+	if (size < 2048)
+		size = 2048;
+#if defined(MSG_WAITFORONE) // recvmmsg
+	if (count > RECV_BATCH_MAX)
+		count = RECV_BATCH_MAX;
+	// a datagram greater than size continues in an overflow area, then is copied into its buffer:
+	// no loss, and no big buffers for usual datagrams. The overflow area is a buffer of the pool sized on count,
+	// recycled between calls and threads rather than reserved by every receiving thread
+	Buffer overflows(count * 0x10000); // 0x10000 is greater than maximum UDP payload
+	mmsghdr msgs[RECV_BATCH_MAX];
+	iovec	iovecs[RECV_BATCH_MAX][2];
+	union {
+		struct sockaddr_in  sa_in;
+		struct sockaddr_in6 sa_in6;
+	} addrs[RECV_BATCH_MAX];
+	memset(msgs, 0, count*sizeof(mmsghdr));
+	for (UInt32 i = 0; i < count; ++i) {
+		if (pBuffers[i].unique())
+			pBuffers[i]->resize(size, false);
+		else // null or referenced elsewhere
+			pBuffers[i].set(size);
+		iovecs[i][0].iov_base = pBuffers[i]->data();
+		iovecs[i][0].iov_len = size;
+		iovecs[i][1].iov_base = overflows.data() + i * 0x10000;
+		iovecs[i][1].iov_len = 0x10000;
+		msgs[i].msg_hdr.msg_iov = iovecs[i];
+		msgs[i].msg_hdr.msg_iovlen = 2;
+		msgs[i].msg_hdr.msg_name = &addrs[i];
+		msgs[i].msg_hdr.msg_namelen = sizeof(addrs[i]);
+	}
+	int rc;
+	int error;
+	do {
+		rc = ::recvmmsg(_id, msgs, count, MSG_WAITFORONE, NULL); // MSG_WAITFORONE => don't wait more after a first datagram on a blocking socket
+	} while (rc < 0 && (error = Net::LastError()) == NET_EINTR);
+	if (rc < 0) {
+		SetException(error, ex, " (size=", size, ", count=", count, ")");
+		return -1;
+	}
+
+	if (!_address)
+		_address.set(IPAddress::Loopback(), 0); // to advise that address is computable
+
+	UInt32 received(0);
+	int result(0);
+	for (int i = 0; i < rc; ++i) {
+		received += msgs[i].msg_len;
+		if (msgs[i].msg_hdr.msg_flags&MSG_TRUNC) {
+			SetException(NET_EMSGSIZE, ex, " (from=", SocketAddress(reinterpret_cast<const sockaddr&>(addrs[i])), ", size=", size, ")");
+			continue; // lost!
+		}
+		if (result != i)
+			swap(pBuffers[result], pBuffers[i]);
+		pBuffers[result]->resize(msgs[i].msg_len, true);
+		if (msgs[i].msg_len > size)
+			memcpy(pBuffers[result]->data() + size, overflows.data() + i * 0x10000, msgs[i].msg_len - size);
+		addresses[result++].set(reinterpret_cast<const sockaddr&>(addrs[i]));
+	}
+	receive(received);
+	return result;
+#else
+	// no batch possible on this platform, just one datagram
+	if (pBuffers[0].unique())
+		pBuffers[0]->resize(size, false);
+	else // null or referenced elsewhere
+		pBuffers[0].set(size);
+	int rc = receive(ex, pBuffers[0]->data(), size, 0, addresses);
+	if (rc >= 0)
+		pBuffers[0]->resize(rc, true);
+	return rc < 0 ? -1 : 1;
+#endif
+}
+
 int Socket::sendTo(Exception& ex, const void* data, UInt32 size, const SocketAddress& address, int flags) {
 	if (_ex) {
 		ex = _ex;
@@ -469,9 +564,57 @@ int Socket::sendTo(Exception& ex, const void* data, UInt32 size, const SocketAdd
 	return rc;
 }
 
+bool Socket::setPacing(Exception& ex, UInt64 rate, UInt32 burst) {
+	if (_ex) {
+		ex = _ex;
+		return false;
+	}
+	if (rate && !burst)
+		burst = UInt32(max<UInt64>(min<UInt64>(rate / 100, 0xFFFFFFFF), UInt64(3000)));
+	{
+		lock_guard<mutex> lock(_mutexSending);
+		_pacing.rate = rate;
+		_pacing.burst = rate ? burst : 0;
+		_pacing.tokens = Int64(_pacing.burst) * 1000; // full bucket
+		_pacing.time = Time::Now();
+	}
+#if defined(SO_MAX_PACING_RATE)
+	// kernel pacing below queue, just a warning if unsupported (unsigned 32 bits value supported by every kernel version)
+	setOption(ex, SOL_SOCKET, SO_MAX_PACING_RATE, (rate && rate < 0xFFFFFFFF) ? UInt32(rate) : 0xFFFFFFFF);
+#endif
+	return true;
+}
+
+bool Socket::pace(UInt32& budget) {
+	budget = 0xFFFFFFFF;
+	UInt64 rate(_pacing.rate);
+	IOSocket* pReactor(_pReactor);
+	if (!rate || !pReactor)
+		return true; // no user pacing without IOSocket to schedule flush
+	Int64 now = Time::Now();
+	if (now > _pacing.time) {
+		Int64 missing = Int64(_pacing.burst) * 1000 - _pacing.tokens;
+		if ((now - _pacing.time) > missing / Int64(rate)) // full bucket (check before to avoid overflow)
+			_pacing.tokens += missing;
+		else
+			_pacing.tokens += Int64(rate) * (now - _pacing.time);
+		_pacing.time = now;
+	}
+	if (_pacing.tokens > 0) {
+		budget = UInt32(min<Int64>(max<Int64>(_pacing.tokens / 1000, 1), 0xFFFFFFFF));
+		return true;
+	}
+	if (!_pacing.scheduled) {
+		_pacing.scheduled = true;
+		pReactor->pace(_pacing.weakSocket, UInt32(-_pacing.tokens / rate) + 1);
+	}
+	return false;
+}
+
 int Socket::write(Exception& ex, const Packet& packet, const SocketAddress& address, int flags) {
 	lock_guard<mutex> lock(_mutexSending);
-	if(!_sendings.empty()) {
+	UInt32 budget;
+	if(!_sendings.empty() || !pace(budget)) {
 		_sendings.emplace_back(packet, address ? address : _peerAddress, flags);
 		_queueing += packet.size();
 		return 0;
@@ -492,45 +635,283 @@ int Socket::write(Exception& ex, const Packet& packet, const SocketAddress& addr
 			}
 			return -1;
 		}
-	} else if (UInt32(sent) >= packet.size())
-		return packet.size();
+	} else {
+		paced(sent);
+		if (UInt32(sent) >= packet.size())
+			return packet.size();
+	}
 
 	_sendings.emplace_back(packet+sent, address ? address : _peerAddress, flags);
 	_queueing += _sendings.back().size();
 	return sent;
 }
 
+int Socket::writeFile(Exception& ex, File& file, UInt32 size) {
+	if (_ex) {
+		ex = _ex;
+		return -1;
+	}
+#if defined(__linux__)
+	if (type != TYPE_STREAM) {
+		ex.set<Ex::Unsupported>("Zero-copy file writing impossible on datagram socket");
+		return -1;
+	}
+	if (!file.load(ex))
+		return -1;
+	if (file.mode) {
+		ex.set<Ex::Permission>(file.path(), " read unauthorized in writing, append or deletion mode");
+		return -1;
+	}
+	lock_guard<mutex> lock(_mutexSending);
+	UInt32 budget;
+	if (!_sendings.empty() || !pace(budget))
+		return 0; // wait flush to keep data order (or pacing)
+	int sent = sendFile(ex, file._handle, file._readen, min(size, budget));
+	if (sent <= 0) {
+		if (sent < 0 && !ex.cast<Ex::Unsupported>())
+			close(); // fail to send reliable data, shutdown as write
+		return sent;
+	}
+	lseek64(file._handle, sent, SEEK_CUR); // keep file reading position
+	if (!_address)
+		_address.set(IPAddress::Loopback(), 0); // to advise that address is computable
+	file._readen += sent;
+	send(UInt32(sent));
+	paced(sent);
+	return sent;
+#else
+	ex.set<Ex::Unsupported>("Zero-copy file writing unsupported on this platform");
+	return -1;
+#endif
+}
+
+#if defined(__linux__)
+int Socket::sendFile(Exception& ex, int handle, UInt64 offset, UInt32 size) {
+	off64_t position(offset);
+	ssize_t sent;
+	do {
+		sent = ::sendfile64(_id, handle, &position, size);
+	} while (sent < 0 && errno == EINTR);
+	if (sent >= 0)
+		return int(sent);
+	int error = Net::LastError();
+	if (error == NET_EWOULDBLOCK)
+		return 0;
+	if (error == NET_EINVAL || error == ENOSYS) // file system without mmap support
+		ex.set<Ex::Unsupported>("Zero-copy writing unsupported for this file");
+	else
+		SetException(error, ex, " (address=", _peerAddress, ", offset=", offset, ", size=", size, ")");
+	return -1;
+}
+#endif
+
+int Socket::flushSendings(Exception& ex, UInt32& written, UInt32 budget) {
+	if (_ex) {
+		ex = _ex;
+		return -1;
+	}
+	int flags = _sendings.front().flags;
+	UInt32 count(0);
+	int sent;
+	int error;
+
+	if (isSecure()) {
+		// Secure stream: coalesce the queue in one record (16KB maximum) rather than one record by packet
+		if (type == TYPE_STREAM && _sendings.size() > 1) {
+			Buffer buffer;
+			for (auto it = _sendings.begin(); it != _sendings.end() && it->flags == flags && (buffer.size() + it->size()) <= 0x4000 && (!count || (buffer.size() + it->size()) <= budget); ++it, ++count)
+				buffer.append(it->data(), it->size());
+			if (count > 1) {
+				if ((sent = sendTo(ex, buffer.data(), buffer.size(), SocketAddress::Wildcard(), flags)) < 0)
+					return -1;
+				_sendSyscallsSaved += count - 1;
+				return popSendings(sent, written) < buffer.size() ? 0 : 1;
+			}
+		}
+	}
+#if defined(MSG_WAITFORONE) // sendmmsg
+	else if (type == TYPE_DATAGRAM) {
+		// Build messages: each message is one datagram, or with UDP GSO a group of datagrams to the same address
+		// with the same size (excepting the last one which can be shorter) sent as one super-datagram segmented by the kernel
+		mmsghdr msgs[SEND_BATCH_MAX];
+		iovec	iovecs[SEND_BATCH_MAX];
+		UInt8	counts[SEND_BATCH_MAX];
+#if defined(UDP_SEGMENT)
+		union {
+			char	buffer[CMSG_SPACE(sizeof(UInt16))];
+			cmsghdr	align;
+		} controls[SEND_BATCH_MAX];
+#endif
+		UInt32 msgCount(0), bytes(0);
+		auto it = _sendings.begin();
+		while (count < SEND_BATCH_MAX && it != _sendings.end() && it->flags == flags && (!count || (bytes + it->size()) <= budget)) {
+			mmsghdr& msg(msgs[msgCount]);
+			memset(&msg, 0, sizeof(msg));
+			if (it->address) {
+				msg.msg_hdr.msg_name = (void*)it->address.data();
+				msg.msg_hdr.msg_namelen = it->address.size();
+			}
+			msg.msg_hdr.msg_iov = &iovecs[count];
+			const SocketAddress& address(it->address);
+			UInt32 segment(it->size()), size(0), segments(0);
+			do {
+				iovecs[count].iov_base = (void*)it->data();
+				size += (iovecs[count++].iov_len = it->size());
+				++segments;
+			} while (_gso && ++it != _sendings.end() && count < SEND_BATCH_MAX && segment && iovecs[count - 1].iov_len == segment &&
+					it->size() && it->size() <= segment && (size + it->size()) <= 0xFFFF - 512 && it->flags == flags && it->address == address && (bytes + size + it->size()) <= budget);
+			if (!_gso)
+				++it; // else already incremented by the GSO check
+			bytes += size;
+			msg.msg_hdr.msg_iovlen = counts[msgCount] = segments;
+#if defined(UDP_SEGMENT)
+			if (segments > 1) {
+				msg.msg_hdr.msg_control = controls[msgCount].buffer;
+				msg.msg_hdr.msg_controllen = sizeof(controls[msgCount].buffer);
+				cmsghdr* pCmsg = CMSG_FIRSTHDR(&msg.msg_hdr);
+				pCmsg->cmsg_level = SOL_UDP;
+				pCmsg->cmsg_type = UDP_SEGMENT;
+				pCmsg->cmsg_len = CMSG_LEN(sizeof(UInt16));
+				*(UInt16*)CMSG_DATA(pCmsg) = segment;
+			}
+#endif
+			++msgCount;
+		}
+#if defined(MSG_NOSIGNAL)
+		flags |= MSG_NOSIGNAL;
+#endif
+		do {
+			sent = ::sendmmsg(_id, msgs, msgCount, flags);
+		} while (sent < 0 && (error = Net::LastError()) == NET_EINTR);
+		if (sent < 0) {
+			if (counts[0] > 1 && (error == NET_EINVAL || error == EIO || error == NET_ENOPROTOOPT)) {
+				// UDP GSO refused (no kernel support, no checksum offload, or segment greater than MTU)
+				_gso = false;
+				return flushSendings(ex, written, budget);
+			}
+			const Sending& sending(_sendings.front());
+			SetException(error, ex, " (address=", sending.address ? sending.address : _peerAddress, ", size=", sending.size(), ", flags=", flags, ")");
+			return -1;
+		}
+		if (!_address)
+			_address.set(IPAddress::Loopback(), 0); // to advise that address is computable
+		count = 0;
+		UInt32 size(0);
+		for (int i = 0; i < sent; ++i) {
+			size += msgs[i].msg_len;
+			count += counts[i];
+		}
+		if (count > 1)
+			_sendSyscallsSaved += count - 1;
+		written += size;
+		send(size);
+		while (count--)
+			_sendings.pop_front();
+		return 1;
+	}
+#endif
+#if !defined(_WIN32)
+	else if (type == TYPE_STREAM && _sendings.size() > 1) {
+		// Scatter-gather sending of the queue
+		iovec	iovecs[SEND_BATCH_MAX];
+		UInt32 size(0);
+		for (auto it = _sendings.begin(); count < SEND_BATCH_MAX && it != _sendings.end() && it->flags == flags && size < budget; ++it) {
+			iovecs[count].iov_base = (void*)it->data();
+			size += (iovecs[count++].iov_len = min(it->size(), budget - size));
+		}
+		msghdr msg;
+		memset(&msg, 0, sizeof(msg));
+		msg.msg_iov = iovecs;
+		msg.msg_iovlen = count;
+#if defined(MSG_NOSIGNAL)
+		flags |= MSG_NOSIGNAL;
+#endif
+		do {
+			sent = ::sendmsg(_id, &msg, flags);
+		} while (sent < 0 && (error = Net::LastError()) == NET_EINTR);
+		if (sent < 0) {
+			SetException(error, ex, " (address=", _peerAddress, ", size=", size, ", flags=", flags, ")");
+			return -1;
+		}
+		if (!_address)
+			_address.set(IPAddress::Loopback(), 0); // to advise that address is computable
+		send(sent);
+		count = _sendings.size();
+		if (popSendings(sent, written) < size)
+			count -= _sendings.size() - 1; // the last one is partially sent
+		else
+			count -= _sendings.size();
+		if (count > 1)
+			_sendSyscallsSaved += count - 1;
+		return UInt32(sent) < size ? 0 : 1;
+	}
+#endif
+
+	// one packet (a stream can be sent partially to respect budget)
+	Sending& sending(_sendings.front());
+	UInt32 size(type == TYPE_STREAM ? min(sending.size(), budget) : sending.size());
+	if ((sent = sendTo(ex, sending.data(), size, sending.address, sending.flags)) < 0)
+		return -1;
+	written += sent;
+	if (UInt32(sent) < sending.size()) {
+		sending += sent;
+		return UInt32(sent) < size ? 0 : 1; // can't send more if less than size
+	}
+	_sendings.pop_front();
+	return 1;
+}
+
+UInt32 Socket::popSendings(UInt32 size, UInt32& written) {
+	written += size;
+	UInt32 rest(size);
+	while (!_sendings.empty()) {
+		Sending& sending(_sendings.front());
+		if (rest < sending.size()) {
+			if (rest)
+				sending += rest; // partially sent
+			break;
+		}
+		rest -= sending.size();
+		_sendings.pop_front();
+	}
+	return size;
+}
+
 bool Socket::flush(Exception& ex, bool deleting) {
 	UInt32 written(0);
 
 	unique_lock<mutex> lock(_mutexSending, defer_lock);
 	if (!deleting)
 		lock.lock();
-	int sent(0);
-	while(sent>=0 && !_sendings.empty()) {
-		Sending& sending(_sendings.front());
-		sent = sendTo(ex, sending.data(), sending.size(), sending.address, sending.flags);
-		if (sent >= 0) {
-			written += sent;
-			if (UInt32(sent) < sending.size()) {
-				// can't send more!
-				sending += sent;
-				break;
-			}
+	if (_flushing) {
+		// io_uring sendings in progress, IOSocket continues the flush on their completion (data in flight are referenced by IOSocket)
+		if (deleting)
+			_sendings.clear();
+		return true;
+	}
+	int result(1);
+	UInt32 budget(0xFFFFFFFF);
+	_pacing.scheduled = false;
+	while (result > 0 && !_sendings.empty() && (deleting || pace(budget))) {
+		UInt32 size(written);
+		result = flushSendings(ex, written, budget);
+		paced(written - size);
+	}
+	if (result < 0) {
+		int code = ex.cast<Ex::Net::Socket>().code;
+		if ((code == NET_ENOTCONN && _peerAddress) || code == NET_EWOULDBLOCK) {
+			// is connecting, can't send more now (wait onFlush)
+			ex = nullptr;
+		} else if (type == TYPE_STREAM) {
+			// fail to send few reliable data, shutdown send!
+			close(); // shutdown system to avoid to try to send before shutdown!
+			_sendings.clear();
+			return false;
 		} else {
-			int code = ex.cast<Ex::Net::Socket>().code;
-			if ((code == NET_ENOTCONN && _peerAddress) || code == NET_EWOULDBLOCK) {
-				// is connecting, can't send more now (wait onFlush)
-				ex = nullptr;
-				break;
-			} else if (type == TYPE_STREAM) {
-				// fail to send few reliable data, shutdown send!
-				close(); // shutdown system to avoid to try to send before shutdown!
-				_sendings.clear();
-				return false;
-			}
+			// datagram lost
+			written += _sendings.front().size();
+			_sendings.pop_front();
 		}
-		_sendings.pop_front();
 	}
 	if (deleting) {
 		_sendings.clear();
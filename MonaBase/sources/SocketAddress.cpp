@@ -80,6 +80,14 @@ bool SocketAddress::operator < (const SocketAddress& address) const {
 	return (port() < address.port());
 }
 
+UInt32 SocketAddress::hash() const {
+	UInt32 hash(2166136261);
+	const UInt8* data(BIN host().data());
+	for (UInt8 i = 0; i < host().size(); ++i)
+		hash = (hash ^ data[i]) * 16777619;
+	hash = (hash ^ UInt8(port())) * 16777619;
+	return (hash ^ UInt8(port() >> 8)) * 16777619;
+}
 
 const SocketAddress& SocketAddress::Wildcard(IPAddress::Family family) {
 	if (family == IPv6) {
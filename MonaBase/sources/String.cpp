@@ -18,6 +18,11 @@ details (or else see http://mozilla.org/MPL/2.0/).
 #include "Mona/Exceptions.h"
 #include <limits>
 #include <cctype>
+#include <cmath>
+#if (defined(_GLIBCXX_RELEASE) && _GLIBCXX_RELEASE >= 12) || (defined(_MSC_VER) && _MSC_VER >= 1924 && _HAS_CXX17) || defined(__cpp_lib_to_chars)
+	#define TO_CHARS // floating point to_chars/from_chars available
+	#include <charconv>
+#endif
 
 using namespace std;
 
@@ -109,6 +114,229 @@ size_t String::TrimRight(const char* value, size_t size) {
 	return size;
 }
 
+static const char _Digits[] =
+	"0001020304050607080910111213141516171819"
+	"2021222324252627282930313233343536373839"
+	"4041424344454647484950515253545556575859"
+	"6061626364656667686970717273747576777879"
+	"8081828384858687888990919293949596979899";
+
+UInt8 String::FromNumber(UInt64 value, bool negative, char* buffer) {
+	// two digits by division
+	char digits[20];
+	char* cur(digits + sizeof(digits));
+	while (value >= 100) {
+		const char* pair(_Digits + (value % 100) * 2);
+		value /= 100;
+		*--cur = pair[1];
+		*--cur = pair[0];
+	}
+	if (value >= 10) {
+		*--cur = _Digits[value * 2 + 1];
+		*--cur = _Digits[value * 2];
+	} else
+		*--cur = char('0' + value);
+	UInt8 size(digits + sizeof(digits) - cur);
+	if (negative)
+		*buffer++ = '-';
+	memcpy(buffer, cur, size);
+	return negative ? size + 1 : size;
+}
+
+template<typename Type>
+static UInt8 FromFloatingNumber(Type value, Int32 precision, char* buffer) {
+	char* begin(buffer);
+	if (signbit(value))
+		*buffer++ = '-';
+	if (isnan(value) || isinf(value)) {
+		memcpy(buffer, isnan(value) ? "nan" : "inf", 3);
+		return UInt8(buffer + 3 - begin);
+	}
+	if (value == 0) {
+		*buffer = '0';
+		return UInt8(buffer + 1 - begin);
+	}
+
+	// shortest digits which give the same value when parsed
+	char scientific[48];
+#if defined(TO_CHARS)
+	const char* end(to_chars(scientific, scientific + sizeof(scientific), value, chars_format::scientific).ptr);
+#else
+	const char* end;
+	for (Int32 digits = 0; ; ++digits) {
+		end = scientific + snprintf(scientific, sizeof(scientific), "%.*e", digits, value);
+		if (digits >= (precision + 1) || Type(strtod(scientific, NULL)) == value)
+			break;
+	}
+#endif
+	char digits[32];
+	UInt8 count(0);
+	Int32 exponent(0);
+	for (const char* cur = scientific; cur < end; ++cur) {
+		if (isdigit(*cur)) {
+			digits[count++] = *cur;
+			continue;
+		}
+		if (*cur != 'e')
+			continue; // sign or decimal point (locale free)
+		bool negative(*++cur == '-');
+		while (++cur < end)
+			exponent = exponent * 10 + (*cur - '0');
+		if (negative)
+			exponent = -exponent;
+	}
+	while (count > 1 && digits[count - 1] == '0')
+		--count;
+
+	// %g style
+	if (exponent < -4 || exponent >= precision) {
+		*buffer++ = digits[0];
+		if (count > 1) {
+			*buffer++ = '.';
+			memcpy(buffer, digits + 1, count - 1);
+			buffer += count - 1;
+		}
+		*buffer++ = 'e';
+		*buffer++ = exponent < 0 ? '-' : '+';
+		if (exponent < 0)
+			exponent = -exponent;
+		if (exponent >= 100) {
+			*buffer++ = char('0' + exponent / 100);
+			exponent %= 100;
+		}
+		memcpy(buffer, _Digits + exponent * 2, 2);
+		return UInt8(buffer + 2 - begin);
+	}
+	if (exponent < 0) {
+		memcpy(buffer, "0.0000", 1 - exponent);
+		buffer += 1 - exponent;
+		memcpy(buffer, digits, count);
+		return UInt8(buffer + count - begin);
+	}
+	for (Int32 i = 0; i <= exponent; ++i)
+		*buffer++ = i < count ? digits[i] : '0';
+	if (count > ++exponent) {
+		*buffer++ = '.';
+		memcpy(buffer, digits + exponent, count - exponent);
+		buffer += count - exponent;
+	}
+	return UInt8(buffer - begin);
+}
+
+UInt8 String::FromNumber(double value, char* buffer) { return FromFloatingNumber(value, 16, buffer); }
+UInt8 String::FromNumber(float value, char* buffer) { return FromFloatingNumber(value, 8, buffer); }
+
+template<typename Type>
+static bool ToDecimalNumber(const char* begin, const char* end, bool negative, Type& result, false_type /*integer*/) {
+	UInt64 number(0);
+	for (; begin < end && *begin != '.' && *begin != ','; ++begin) {
+		UInt8 digit(*begin - '0');
+		if (number > (0xFFFFFFFFFFFFFFFFull - digit) / 10)
+			return false;
+		number = number * 10 + digit;
+	}
+	// decimals are truncated
+	if (number > UInt64(numeric_limits<Type>::max()) + (negative && numeric_limits<Type>::is_signed ? 1 : 0))
+		return false;
+	result = Type(negative ? (0 - number) : number);
+	return true;
+}
+
+template<typename Type>
+static bool ToDecimalNumber(const char* begin, const char* end, bool negative, Type& result, true_type /*floating point*/) {
+#if defined(TO_CHARS)
+	char buffer[128];
+	const char* comma((const char*)memchr(begin, ',', end - begin));
+	if (comma) {
+		// from_chars expects a point
+		if ((end - begin) > Int32(sizeof(buffer)))
+			return false;
+		memcpy(buffer, begin, end - begin);
+		buffer[comma - begin] = '.';
+		end = buffer + (end - begin);
+		begin = buffer;
+	}
+	from_chars_result parsing(from_chars(begin, end, result, chars_format::general));
+	if (parsing.ec != errc() || parsing.ptr != end)
+		return false;
+#else
+	// long double computing
+	long double number(0);
+	UInt64 comma(0);
+	for (; begin < end && *begin != 'e' && *begin != 'E'; ++begin) {
+		if (*begin == '.' || *begin == ',') {
+			comma = 1;
+			continue;
+		}
+		number = number * 10 + (*begin - '0');
+		comma *= 10;
+	}
+	if (comma)
+		number /= comma;
+	if (begin < end)
+		number *= powl(10, strtol(begin + 1, NULL, 10));
+	if (number > numeric_limits<Type>::max())
+		return false;
+	result = Type(number);
+#endif
+	if (negative)
+		result = -result;
+	return true;
+}
+
+template<typename Type>
+static bool ToDecimalNumber(Exception& ex, const char* value, size_t size, Type& result) {
+	// no locale, no allocation, and exact for floating point
+	const char* end;
+	if (size == string::npos)
+		end = value + strlen(value);
+	else if (!(end = (const char*)memchr(value, 0, size)))
+		end = value + size;
+	const char* begin(value);
+	while (begin < end && (iscntrl(*begin) || *begin == ' '))
+		++begin;
+	if (begin == end) {
+		ex.set<Ex::Format>("Empty string is not a number");
+		return false;
+	}
+	bool negative(*begin == '-');
+	if (negative || *begin == '+')
+		++begin;
+	// digits [(.|,) digits] [(e|E) [sign] digits], exponent just for floating point
+	bool comma(false);
+	for (const char* cur = begin; cur < end; ++cur) {
+		if (UInt8(*cur - '0') < 10)
+			continue;
+		if ((*cur == '.' || *cur == ',') && !comma && cur != begin) {
+			comma = true;
+			continue;
+		}
+		if ((*cur == 'e' || *cur == 'E') && is_floating_point<Type>::value && cur != begin) {
+			if (++cur < end && (*cur == '-' || *cur == '+'))
+				++cur;
+			if (cur < end) {
+				while (cur < end && UInt8(*cur - '0') < 10)
+					++cur;
+				if (cur == end)
+					break;
+			}
+		} else if (isalnum(*cur)) {
+			ex.set<Ex::Format>(*cur, " is not a correct digit");
+			return false;
+		}
+		ex.set<Ex::Format>(value, " is not a correct number");
+		return false;
+	}
+	if (begin == end) {
+		ex.set<Ex::Format>(value, " is not a correct number");
+		return false;
+	}
+	if (ToDecimalNumber(begin, end, negative, result, is_floating_point<Type>()))
+		return true;
+	ex.set<Ex::Format>(value, " exceeds maximum number capacity");
+	return false;
+}
+
 template<typename Type>
 bool String::ToNumber(const char* value, size_t size, Type& result, Math base)  {
 	Exception ex;
@@ -118,6 +346,8 @@ bool String::ToNumber(const char* value, size_t size, Type& result, Math base)
 template<typename Type>
 bool String::ToNumber(Exception& ex, const char* value, size_t size, Type& result, Math base) {
 	STATIC_ASSERT(is_arithmetic<Type>::value);
+	if (base == BASE_10)
+		return ToDecimalNumber(ex, value, size, result);
 	if (base > 36) {
 		ex.set<Ex::Format>(base, " is impossible to represent with ascii table, maximum base is 36");
 		return false;
@@ -334,6 +564,8 @@ template bool  String::ToNumber(const char*, size_t, unsigned char&, Math base);
 template bool  String::ToNumber(Exception& ex, const char*, size_t, unsigned char&, Math base);
 template bool  String::ToNumber(const char*, size_t, char&, Math base);
 template bool  String::ToNumber(Exception& ex, const char*, size_t, char&, Math base);
+template bool  String::ToNumber(const char*, size_t, signed char&, Math base);
+template bool  String::ToNumber(Exception& ex, const char*, size_t, signed char&, Math base);
 template bool  String::ToNumber(const char*, size_t, short&, Math base);
 template bool  String::ToNumber(Exception& ex, const char*, size_t, short&, Math base);
 template bool  String::ToNumber(const char*, size_t, unsigned short&, Math base);
@@ -47,7 +47,7 @@ shared<Socket> TCPClient::newSocket() {
 }
 const shared<Socket>& TCPClient::socket() {
 	if (!_pSocket) {
-		_sendingTrack = 0;
+		_sendingTrack.reset();
 		_pSocket = newSocket();
 		Exception ex;
 		_subscribed = io.subscribe(ex, _pSocket, newDecoder(), _onReceived, _onFlush, onError, _onDisconnection);
@@ -91,7 +91,7 @@ bool TCPClient::connect(Exception& ex, const shared<Socket>& pSocket) {
 		io.unsubscribe(_pSocket);
 	else
 		_subscribed = true;
-	_sendingTrack = 0;
+	_sendingTrack.reset();
 	_pSocket = pSocket;
 	return true;
 }
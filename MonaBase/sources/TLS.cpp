@@ -16,12 +16,29 @@ details (or else see http://mozilla.org/MPL/2.0/).
 
 
 #include "Mona/TLS.h"
+#include <openssl/rand.h>
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+#include <openssl/core_names.h>
+#else
+#include <openssl/hmac.h>
+#endif
 
 
 using namespace std;
 
 namespace Mona {
 
+TLS::TLS(SSL_CTX* pCTX) : _pCTX(pCTX), _hits(0), _misses(0), _sessionsSize(0), _ticketKeysTime(0), _ticketKeysRotation(0) {
+	SSL_CTX_set_app_data(pCTX, this);
+	SSL_CTX_set_info_callback(pCTX, Socket::InfoCallback);
+}
+
+TLS::~TLS() {
+	for (auto& it : _sessions)
+		SSL_SESSION_free(it.second);
+	SSL_CTX_free(_pCTX);
+}
+
 bool TLS::Create(Exception& ex, shared<TLS>& pTLS, const SSL_METHOD* method) {
 	// load and configure in constructor to be thread safe!
 	SSL_CTX* pCTX(SSL_CTX_new(method));
@@ -29,7 +46,7 @@ bool TLS::Create(Exception& ex, shared<TLS>& pTLS, const SSL_METHOD* method) {
 		/* If the underlying BIO is blocking, SSL_read()/SSL_write() will only return, once the read operation has been finished or an error occurred,
 		except when a renegotiation take place, in which case a SSL_ERROR_WANT_READ may occur.
 		This behaviour can be controlled with the SSL_MODE_AUTO_RETRY flag of the SSL_CTX_set_mode call. */
-		SSL_CTX_set_mode(pCTX, SSL_MODE_AUTO_RETRY);
+		SSL_CTX_set_mode(pCTX, SSL_MODE_AUTO_RETRY | SSL_MODE_ACCEPT_MOVING_WRITE_BUFFER); // moving buffer because Socket::flush coalesces queue in a new buffer on retry
 		pTLS = new TLS(pCTX);
 		return true;
 	}
@@ -46,7 +63,7 @@ bool TLS::Create(Exception& ex, const char* cert, const char* key, shared<TLS>&
 			/* If the underlying BIO is blocking, SSL_read()/SSL_write() will only return, once the read operation has been finished or an error occurred,
 			except when a renegotiation take place, in which case a SSL_ERROR_WANT_READ may occur.
 			This behaviour can be controlled with the SSL_MODE_AUTO_RETRY flag of the SSL_CTX_set_mode call. */
-			SSL_CTX_set_mode(pCTX, SSL_MODE_AUTO_RETRY);
+			SSL_CTX_set_mode(pCTX, SSL_MODE_AUTO_RETRY | SSL_MODE_ACCEPT_MOVING_WRITE_BUFFER); // moving buffer because Socket::flush coalesces queue in a new buffer on retry
 			pTLS = new TLS(pCTX);
 			return true;
 		}
@@ -56,9 +73,138 @@ bool TLS::Create(Exception& ex, const char* cert, const char* key, shared<TLS>&
 	return false;
 }
 
-TLS::Socket::Socket(Type type, const shared<TLS>& pTLS) : pTLS(pTLS), Mona::Socket(type), _ssl(NULL) {}
+bool TLS::setKTLS(Exception& ex, bool enable) {
+#if defined(MONA_KTLS)
+	if (enable)
+		SSL_CTX_set_options(_pCTX, SSL_OP_ENABLE_KTLS);
+	else
+		SSL_CTX_clear_options(_pCTX, SSL_OP_ENABLE_KTLS);
+	return true;
+#else
+	if (!enable)
+		return true;
+	ex.set<Ex::Unsupported>("kTLS unsupported, requires linux and OpenSSL >= 3.0 built with kTLS");
+	return false;
+#endif
+}
+
+bool TLS::kTLS() const {
+#if defined(MONA_KTLS)
+	return (SSL_CTX_get_options(_pCTX) & SSL_OP_ENABLE_KTLS) ? true : false;
+#else
+	return false;
+#endif
+}
+
+bool TLS::setSessionCache(Exception& ex, UInt32 size, UInt32 timeout) {
+	SSL_CTX_set_timeout(_pCTX, timeout);
+	if (SSL_CTX_get0_certificate(_pCTX)) {
+		// server
+		static const unsigned char Context[] = "Mona";
+		SSL_CTX_set_session_id_context(_pCTX, Context, sizeof(Context) - 1);
+		SSL_CTX_sess_set_cache_size(_pCTX, size);
+		SSL_CTX_set_session_cache_mode(_pCTX, size ? SSL_SESS_CACHE_SERVER : SSL_SESS_CACHE_OFF);
+		return true;
+	}
+	// client, sessions are kept in _sessions by peer address and server name
+	SSL_CTX_set_session_cache_mode(_pCTX, size ? (SSL_SESS_CACHE_CLIENT | SSL_SESS_CACHE_NO_INTERNAL_STORE) : SSL_SESS_CACHE_OFF);
+	SSL_CTX_sess_set_new_cb(_pCTX, size ? Socket::NewSessionCallback : NULL);
+	lock_guard<mutex> lock(_mutex);
+	_sessionsSize = size;
+	while (_sessions.size() > size) {
+		SSL_SESSION_free(_sessions.begin()->second);
+		_sessions.erase(_sessions.begin());
+	}
+	return true;
+}
+
+int TLS::ticketKey(UInt8* name, bool encrypting, TicketKey& key) {
+	lock_guard<mutex> lock(_mutex);
+	Int64 now = Time::Now();
+	UInt64 rotations = _ticketKeysRotation ? UInt64(now - _ticketKeysTime) / (_ticketKeysRotation * 1000ull) : 0;
+	if (rotations) {
+		// rotate, the previous key allows to decrypt tickets delivered during the previous rotation
+		if (rotations > 1)
+			RAND_bytes(BIN &_ticketKeys[1], sizeof(TicketKey));
+		else
+			_ticketKeys[1] = _ticketKeys[0];
+		RAND_bytes(BIN &_ticketKeys[0], sizeof(TicketKey));
+		_ticketKeysTime = now;
+	}
+	if (encrypting) {
+		key = _ticketKeys[0];
+		memcpy(name, key.name, sizeof(key.name));
+		return 1;
+	}
+	for (UInt8 i = 0; i < 2; ++i) {
+		if (memcmp(name, _ticketKeys[i].name, sizeof(key.name)) == 0) {
+			key = _ticketKeys[i];
+			return i + 1;
+		}
+	}
+	return 0;
+}
+
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+int TLS::TicketKeyCallback(SSL* ssl, unsigned char* name, unsigned char* iv, EVP_CIPHER_CTX* pCipher, EVP_MAC_CTX* pMAC, int enc) {
+#else
+int TLS::TicketKeyCallback(SSL* ssl, unsigned char* name, unsigned char* iv, EVP_CIPHER_CTX* pCipher, HMAC_CTX* pMAC, int enc) {
+#endif
+	TicketKey key;
+	int result = ((TLS*)SSL_CTX_get_app_data(SSL_get_SSL_CTX(ssl)))->ticketKey(name, enc ? true : false, key);
+	if (!result)
+		return 0; // unknown or expired key => full handshake
+	if (!enc && SSL_version(ssl) >= TLS1_3_VERSION)
+		result = 2; // TLS 1.3 client uses a ticket one time, renew it to allow the next resumption
+	if (enc) {
+		if (RAND_bytes(iv, EVP_CIPHER_iv_length(EVP_aes_256_cbc())) != 1 || EVP_EncryptInit_ex(pCipher, EVP_aes_256_cbc(), NULL, key.aes, iv) != 1)
+			return -1;
+	} else if (EVP_DecryptInit_ex(pCipher, EVP_aes_256_cbc(), NULL, key.aes, iv) != 1)
+		return -1;
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+	OSSL_PARAM params[] = {
+		OSSL_PARAM_construct_octet_string(OSSL_MAC_PARAM_KEY, key.hmac, sizeof(key.hmac)),
+		OSSL_PARAM_construct_utf8_string(OSSL_MAC_PARAM_DIGEST, (char*)"SHA256", 0),
+		OSSL_PARAM_construct_end()
+	};
+	if (EVP_MAC_CTX_set_params(pMAC, params) != 1)
+		return -1;
+#else
+	if (HMAC_Init_ex(pMAC, key.hmac, sizeof(key.hmac), EVP_sha256(), NULL) != 1)
+		return -1;
+#endif
+	return result;
+}
+
+bool TLS::setTicketKeysRotation(Exception& ex, UInt32 rotation) {
+	if (!SSL_CTX_get0_certificate(_pCTX)) {
+		ex.set<Ex::Unsupported>("Session tickets keys are for a server TLS context");
+		return false;
+	}
+	{
+		lock_guard<mutex> lock(_mutex);
+		_ticketKeysRotation = rotation;
+		_ticketKeysTime = Time::Now();
+		RAND_bytes(BIN _ticketKeys, sizeof(_ticketKeys));
+	}
+	if (!rotation) {
+		SSL_CTX_set_options(_pCTX, SSL_OP_NO_TICKET);
+		return true;
+	}
+	SSL_CTX_clear_options(_pCTX, SSL_OP_NO_TICKET);
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+	if (SSL_CTX_set_tlsext_ticket_key_evp_cb(_pCTX, TicketKeyCallback) == 1)
+#else
+	if (SSL_CTX_set_tlsext_ticket_key_cb(_pCTX, TicketKeyCallback) == 1)
+#endif
+		return true;
+	ex.set<Ex::Extern::Crypto>(Crypto::LastErrorMessage());
+	return false;
+}
+
+TLS::Socket::Socket(Type type, const shared<TLS>& pTLS) : pTLS(pTLS), Mona::Socket(type), _ssl(NULL), _handshaked(false) {}
 
-TLS::Socket::Socket(NET_SOCKET sockfd, const sockaddr& addr, const shared<TLS>& pTLS) : pTLS(pTLS), Mona::Socket(sockfd, addr), _ssl(NULL) {}
+TLS::Socket::Socket(NET_SOCKET sockfd, const sockaddr& addr, const shared<TLS>& pTLS) : pTLS(pTLS), Mona::Socket(sockfd, addr), _ssl(NULL), _handshaked(false) {}
 
 TLS::Socket::~Socket() {
 	if (!_ssl)
@@ -86,15 +232,23 @@ UInt32 TLS::Socket::available() const {
 	return SSL_pending(_ssl); // max buffer possible size (nothing to read)
 }
 
+bool TLS::Socket::isKTLS() const {
+#if defined(MONA_KTLS)
+	if (!pTLS)
+		return false;
+	lock_guard<mutex> lock(_mutex);
+	return _ssl && BIO_get_ktls_send(SSL_get_wbio(_ssl));
+#else
+	return false;
+#endif
+}
+
 Mona::Socket* TLS::Socket::newSocket(Exception& ex, NET_SOCKET sockfd, const sockaddr& addr) {
 	if(!pTLS)
 		return Mona::Socket::newSocket(ex, sockfd, addr); // normal socket
 
 	Socket* pSocket(new Socket(sockfd, addr, pTLS));
-	pSocket->_ssl = SSL_new(pTLS->_pCTX);
-	if (!pSocket->_ssl || SSL_set_fd(pSocket->_ssl, *pSocket) != 1) {
-		// Certainly a TLS error context
-		ex.set<Ex::Extern::Crypto>(Crypto::LastErrorMessage());
+	if (!pSocket->newSSL(ex)) {
 		delete pSocket;
 		return NULL;
 	}
@@ -102,6 +256,54 @@ Mona::Socket* TLS::Socket::newSocket(Exception& ex, NET_SOCKET sockfd, const soc
 	return pSocket;
 }
 
+bool TLS::Socket::newSSL(Exception& ex) {
+	_ssl = SSL_new(pTLS->_pCTX);
+	if (!_ssl || SSL_set_fd(_ssl, self) != 1) {
+		// Certainly a TLS error context
+		ex.set<Ex::Extern::Crypto>(Crypto::LastErrorMessage());
+		return false;
+	}
+	SSL_set_app_data(_ssl, this);
+	return true;
+}
+
+void TLS::Socket::InfoCallback(const SSL* ssl, int where, int ret) {
+	if (!(where & SSL_CB_HANDSHAKE_DONE))
+		return;
+	Socket* pSocket = (Socket*)SSL_get_app_data(ssl);
+	if (!pSocket || pSocket->_handshaked)
+		return; // TLS 1.3 server can signal it again after session tickets sending
+	pSocket->_handshaked = true;
+	++(SSL_session_reused((SSL*)ssl) ? pSocket->pTLS->_hits : pSocket->pTLS->_misses);
+}
+
+int TLS::Socket::NewSessionCallback(SSL* ssl, SSL_SESSION* pSession) {
+	// client side, keep session to resume it on next connection to this peer with the same server name
+	Socket* pSocket = (Socket*)SSL_get_app_data(ssl);
+	if (!pSocket || !pSocket->peerAddress())
+		return 0;
+	TLS& tls(*pSocket->pTLS);
+	lock_guard<mutex> lock(tls._mutex);
+	if (!tls._sessionsSize)
+		return 0;
+	pair<SocketAddress, string> key(pSocket->peerAddress(), pSocket->_serverName);
+	auto it = tls._sessions.lower_bound(key);
+	if (it != tls._sessions.end() && it->first == key) {
+		SSL_SESSION_free(it->second);
+		it->second = pSession;
+		return 1;
+	}
+	if (tls._sessions.size() >= tls._sessionsSize) {
+		// full, replace the next one (pseudo random eviction)
+		if (it == tls._sessions.end())
+			it = tls._sessions.begin();
+		SSL_SESSION_free(it->second);
+		it = tls._sessions.erase(it);
+	}
+	tls._sessions.emplace_hint(it, move(key), pSession);
+	return 1; // session owned
+}
+
 bool TLS::Socket::connect(Exception& ex, const SocketAddress& address, UInt16 timeout) {
 	if (!Mona::Socket::connect(ex, address, timeout))
 		return false;
@@ -115,13 +317,18 @@ bool TLS::Socket::connect(Exception& ex, const SocketAddress& address, UInt16 ti
 	if (_ssl) // already connected!
 		return true;
 
-	_ssl = SSL_new(pTLS->_pCTX);
-	if (!_ssl || SSL_set_fd(_ssl, self) != 1) {
-		// Certainly a TLS error context
-		ex.set<Ex::Extern::Crypto>(Crypto::LastErrorMessage());
+	if (!newSSL(ex))
 		return false;
+	if (!_serverName.empty() && !SSL_set_tlsext_host_name(_ssl, _serverName.c_str())) {
+		ex.set<Ex::Extern::Crypto>(Crypto::LastErrorMessage(), " (server name=", _serverName, ")");
+		return false;
+	}
+	{	// resume the previous session with this peer and server name
+		lock_guard<mutex> lock(pTLS->_mutex);
+		auto it = pTLS->_sessions.find(make_pair(address, _serverName));
+		if (it != pTLS->_sessions.end())
+			SSL_set_session(_ssl, it->second);
 	}
-	
 	SSL_set_connect_state(_ssl);
 	// do the handshake now to send the client-hello message! (if non-blocking socket it's set before the call to connect)
 	return connecting ? true : catchResult(ex, SSL_do_handshake(_ssl), " (address=", address, ")") >= 0;
@@ -165,6 +372,36 @@ int TLS::Socket::sendTo(Exception& ex, const void* data, UInt32 size, const Sock
 	return result;
 }
 
+#if defined(__linux__)
+int TLS::Socket::sendFile(Exception& ex, int handle, UInt64 offset, UInt32 size) {
+	if (!pTLS)
+		return Mona::Socket::sendFile(ex, handle, offset, size); // normal socket
+	lock_guard<mutex> lock(_mutex);
+	if (!_ssl)
+		return Mona::Socket::sendFile(ex, handle, offset, size); // normal socket
+#if defined(MONA_KTLS)
+	if (BIO_get_ktls_send(SSL_get_wbio(_ssl))) {
+		// kernel encrypts, file can be sent without user space copy
+		ossl_ssize_t result = SSL_sendfile(_ssl, handle, offset, size, 0);
+		if (result >= 0)
+			return int(result);
+		int error = Net::LastError();
+		if (catchResult(ex, -1, " (address=", peerAddress(), ", offset=", offset, ", size=", size, ")") >= 0 || error == NET_EINVAL || error == ENOSYS) {
+			// nothing sent and no socket error (file unsupported by kernel sendfile or SSL state without error), fall back to the copy path
+			ex.set<Ex::Unsupported>("Zero-copy writing with kTLS unsupported for this file");
+			return -1;
+		}
+		if (ex.cast<Ex::Net::Socket>().code != NET_EWOULDBLOCK)
+			return -1;
+		ex = nullptr;
+		return 0; // congested
+	}
+#endif
+	ex.set<Ex::Unsupported>("Zero-copy writing impossible on secure socket without kTLS");
+	return -1;
+}
+#endif
+
 bool TLS::Socket::flush(Exception& ex, bool deleting) {
 	// Call when Writable!
 	if (!pTLS || queueing()) // if queueing a SLL_Write will do the handshake!
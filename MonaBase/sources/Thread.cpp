@@ -173,14 +173,16 @@ void Thread::start(Priority priority) {
 }
 
 void Thread::stop() {
-	_requestStop = true; // advise thread (intern)
-	wakeUp.set(); // wakeUp a sleeping thread
 	if (_Me == this) {
+		_requestStop = true; // advise thread (intern)
+		wakeUp.set();
 		// In the unique case were the caller is the thread itself, set _stop to true to allow to an extern caller to restart it!
 		_stop = true;
 		return;
 	}
-	std::lock_guard<std::mutex> lock(_mutex);
+	std::lock_guard<std::mutex> lock(_mutex); // before to request stop, else a concurrent start could reset the request
+	_requestStop = true; // advise thread (intern)
+	wakeUp.set(); // wakeUp a sleeping thread
 	if (_thread.joinable())
 		_thread.join();
 }
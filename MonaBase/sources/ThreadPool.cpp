@@ -24,14 +24,29 @@ namespace Mona {
 void ThreadPool::init(UInt16 threads, Thread::Priority priority) {
 	_threads.resize(_size = threads ? threads : Thread::ProcessorCount());
 	for (UInt16 i = 0; i < _size; ++i)
-		_threads[i].set(priority);
+		_threads[i] = new ThreadQueue(this, priority);
+}
+
+UInt16 ThreadPool::lessLoaded(UInt16 preferred) const {
+	UInt16 thread(preferred);
+	UInt32 minimum(preferred ? _threads[preferred - 1]->pending() : 0xFFFFFFFF);
+	// round-robin start to distribute on equality
+	for (UInt16 i = 0, current = _current++; minimum && i < _size; ++i) {
+		UInt16 index = (current + i) % _size;
+		UInt32 pending = _threads[index]->pending();
+		if (pending < minimum) {
+			minimum = pending;
+			thread = index + 1;
+		}
+	}
+	return thread;
 }
 
 UInt16 ThreadPool::join() {
 	UInt16 count(0);
 	for (unique<ThreadQueue>& pThread : _threads) {
-		if (!pThread->running())
-			continue;
+		if (!pThread->running() && !pThread->pending())
+			continue; // stopped and not flushing before sleeping (see ThreadQueue::run)
 		++count;
 		pThread->stop();
 	}
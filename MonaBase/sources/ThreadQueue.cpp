@@ -15,6 +15,7 @@ details (or else see http://mozilla.org/MPL/2.0/).
 */
 
 #include "Mona/ThreadQueue.h"
+#include "Mona/ThreadPool.h"
 
 
 using namespace std;
@@ -24,29 +25,107 @@ namespace Mona {
 
 thread_local ThreadQueue* ThreadQueue::_PCurrent(NULL);
 
+void ThreadQueue::push(Job&& job) {
+	FATAL_CHECK(job.pRunner); // more easy to debug that if it fails in the thread!
+	++_pending;
+	_runners.push(move(job));
+	wake();
+}
+
+void ThreadQueue::queueStealable(shared<Runner>&& pRunner) {
+	FATAL_CHECK(pRunner); // more easy to debug that if it fails in the thread!
+	++_pending;
+	{
+		lock_guard<mutex> lock(_mutexStealables);
+		_stealables.emplace_back(move(pRunner));
+		++_stealablesCount;
+	}
+	wake();
+}
+
+void ThreadQueue::wake() {
+	// only the producer which awakes the thread starts it, and the thread sleeps just when it leaves run (see run),
+	// so start never waits a thread still flushing
+	if (!_awake.exchange(true)) {
+		lock_guard<mutex> lock(_mutex); // protect concurrent starts
+		start(_priority);
+	}
+	wakeUp.set();
+}
+
 bool ThreadQueue::run(Exception&, const volatile bool& requestStop) {
 	_PCurrent = this;
 	
 	for (;;) {
 		bool timeout = !wakeUp.wait(120000); // 2 mn of timeout
-		for(;;) {
-			deque<shared<Runner>> runners;
-			{
-				lock_guard<mutex> lock(_mutex);
-				if (_runners.empty()) {
-					if (!timeout && !requestStop)
-						break; // wait more
-					stop(); // to set _stop immediatly!
-					return true;
-				}
-				runners = move(_runners);
-			}
-			for (shared<Runner>& pRunner : runners) {
-				pRunner->run(pRunner->name);
-				pRunner.reset(); // release resources
-			}
+		while (flush() || steal());
+		if (!timeout && !requestStop)
+			continue; // wait more
+		stop(); // to set _stop immediatly!
+		for (;;) {
+			_awake = false; // from here the next producer restarts the thread
+			if (!_pending)
+				return true;
+			// a runner has been queued before sleeping, flush it if no producer is restarting the thread
+			if (_awake.exchange(true))
+				return true;
+			if (!flush())
+				this_thread::yield(); // push in progress
+			while (flush());
+		}
+	}
+}
+
+UInt32 ThreadQueue::flush() {
+	UInt32 count = _runners.flush([this](Job& job) { run(job); });
+	// stealables one by one to let other threads steal meanwhile
+	for (UInt32 stealables = _stealablesCount; stealables; --stealables) {
+		Job job;
+		{
+			lock_guard<mutex> lock(_mutexStealables);
+			if (_stealables.empty())
+				break; // stolen
+			job.pRunner = move(_stealables.front());
+			_stealables.pop_front();
+			--_stealablesCount;
+		}
+		run(job);
+		++count;
+	}
+	return count;
+}
+
+void ThreadQueue::run(Job& job) {
+	job.pRunner->run(job.pRunner->name);
+	job.pRunner.reset(); // release resources
+	if (job.pTrack) {
+		--*job.pTrack; // after run, a track without pending runner can move (see ThreadPool::queue)
+		job.pTrack.reset();
+	}
+	--_pending;
+}
+
+bool ThreadQueue::steal() {
+	if (!_pPool)
+		return false;
+	for (const unique<ThreadQueue>& pThread : _pPool->_threads) {
+		if (pThread.get() == this || !pThread->_stealablesCount)
+			continue;
+		Job job;
+		{
+			lock_guard<mutex> lock(pThread->_mutexStealables);
+			if (pThread->_stealables.empty())
+				continue;
+			job.pRunner = move(pThread->_stealables.back()); // owner consumes from the front
+			pThread->_stealables.pop_back();
+			--pThread->_stealablesCount;
 		}
+		++_pending; // run decrements
+		--pThread->_pending;
+		run(job);
+		return true;
 	}
+	return false;
 }
 
 } // namespace Mona
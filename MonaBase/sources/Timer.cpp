@@ -16,84 +16,174 @@ details (or else see http://mozilla.org/MPL/2.0/).
 
 
 #include "Mona/Timer.h"
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
 
 
 using namespace std;
 
 namespace Mona {
 
+static UInt8 LowestBit(UInt64 value) {
+#if defined(_MSC_VER)
+	unsigned long index;
+	_BitScanForward64(&index, value);
+	return UInt8(index);
+#else
+	return UInt8(__builtin_ctzll(value));
+#endif
+}
+
+/*!
+Returns the first used slot in [from, to[, or -1 */
+static Int16 NextUsed(const UInt64* used, UInt16 from, UInt16 to) {
+	while (from < to) {
+		UInt64 bits = used[from >> 6] >> (from & 63);
+		if (bits) {
+			from += LowestBit(bits);
+			return from < to ? from : -1;
+		}
+		from = (from | 63) + 1;
+	}
+	return -1;
+}
+
+Timer::Timer() : _count(0), _time(Time::Now()) {
+	memset(_slots, 0, sizeof(_slots));
+	memset(_used, 0, sizeof(_used));
+}
+
 Timer::~Timer() {
-	for(const auto& it : _timers) {
-		for (const OnTimer* pTimer : *it.second)
+	for (const OnTimer* pTimer : _slots) {
+		for (; pTimer; pTimer = pTimer->_pNext) {
 			pTimer->_nextRaising = 0;
+			pTimer->_pTimer = NULL;
+		}
 	}
 }
 
 const Timer::OnTimer& Timer::set(const OnTimer& onTimer,  UInt32 timeout) const {
-	shared<std::set<const OnTimer*>> pMove;
-	if (!remove(onTimer, pMove)) {
-		add(onTimer, timeout);
-		return onTimer;
-	}
-	if (timeout) {
-		// MOVE (more efficient!)
-		++_count;
-		const auto& it = _timers.emplace(onTimer._nextRaising = Time::Now() + timeout, move(pMove));
-		if (!it.second)
-			it.first->second->emplace(&onTimer);
-		 else if (!it.first->second)
-			 it.first->second.set().emplace(&onTimer);
+	if (onTimer._nextRaising) {
+		if (onTimer._pTimer != this) {
+			FATAL_ERROR("Timer already used on an other Timer machine, create both individual Timer::Type rather");
+			return onTimer;
+		}
+		unlink(onTimer);
+		--_count;
 	}
+	add(onTimer, timeout);
 	return onTimer;
 }
 
-void Timer::add(const OnTimer& onTimer,  UInt32 timeout) const {
+void Timer::add(const OnTimer& onTimer, UInt32 timeout) const {
 	if (!timeout)
 		return;
-	++_count;
-	auto& it(_timers[(onTimer._nextRaising=Time::Now() + timeout)]);
-	if (!it)
-		it.set();
-	it->emplace(&onTimer);
+	Int64 now = Time::Now();
+	if (!_count++)
+		_time = now; // wheels are empty, move them to now (can have been not raised since a long time)
+	onTimer._nextRaising = now + timeout;
+	onTimer._pTimer = this;
+	link(onTimer);
 }
 
-bool Timer::remove(const OnTimer& onTimer, shared<std::set<const OnTimer*>>& pMove) const {
-	if (!onTimer._nextRaising)
-		return false;
-	const auto& it(_timers.find(onTimer._nextRaising));
-	if (it != _timers.end()) {
-		onTimer._nextRaising = 0;
-		--_count;
-		if (it->second->size() == 1) {
-			if(*it->second->begin() == &onTimer) {
-				pMove = move(it->second);
-				_timers.erase(it);
-				return true;
-			}
-		} else if(it->second->erase(&onTimer))
-			return true;
+void Timer::link(const OnTimer& onTimer) const {
+	// time can't be before _time (past slots are already raised) neither after the last wheel cycle
+	Int64 time = max(Int64(onTimer._nextRaising), _time);
+	UInt64 delta = min(UInt64(time - _time), (UInt64(1) << (BITS*WHEELS)) - 1);
+	UInt8 wheel = 0;
+	while (delta >= (UInt64(1) << (BITS*(wheel + 1))))
+		++wheel;
+	link(onTimer, wheel*SLOTS + UInt8((_time + delta) >> (BITS*wheel)));
+}
+
+void Timer::link(const OnTimer& onTimer, UInt16 slot) const {
+	onTimer._slot = slot;
+	onTimer._pPrev = NULL;
+	if ((onTimer._pNext = _slots[slot]))
+		onTimer._pNext->_pPrev = &onTimer;
+	_slots[slot] = &onTimer;
+	if (slot < RAISING)
+		_used[slot >> BITS][(slot & (SLOTS - 1)) >> 6] |= UInt64(1) << (slot & 63);
+}
+
+void Timer::unlink(const OnTimer& onTimer) const {
+	if (onTimer._pPrev)
+		onTimer._pPrev->_pNext = onTimer._pNext;
+	else if (!(_slots[onTimer._slot] = onTimer._pNext) && onTimer._slot < RAISING)
+		_used[onTimer._slot >> BITS][(onTimer._slot & (SLOTS - 1)) >> 6] &= ~(UInt64(1) << (onTimer._slot & 63));
+	if (onTimer._pNext)
+		onTimer._pNext->_pPrev = onTimer._pPrev;
+	onTimer._nextRaising = 0;
+	onTimer._pTimer = NULL;
+}
+
+void Timer::cascade(UInt8 wheel) const {
+	UInt8 index = UInt8(_time >> (BITS*wheel));
+	if (!index && wheel < (WHEELS - 1))
+		cascade(wheel + 1); // upper wheel first, its timers can fall in the current slot of this wheel
+	UInt16 slot = wheel*SLOTS + index;
+	const OnTimer* pTimer = _slots[slot];
+	if (!pTimer)
+		return;
+	_slots[slot] = NULL;
+	_used[wheel][index >> 6] &= ~(UInt64(1) << (index & 63));
+	while (pTimer) {
+		const OnTimer* pNext = pTimer->_pNext;
+		link(*pTimer); // relink in a lower wheel
+		pTimer = pNext;
 	}
-	FATAL_ERROR("Timer already used on an other Timer machine, create both individual Timer::Type rather");
-	return false;
+}
+
+Int64 Timer::next() const {
+	// first wheel gives an exact time, upper wheels give the time of their next cascade
+	Int64 next(numeric_limits<Int64>::max());
+	for (UInt8 wheel = 0; wheel < WHEELS; ++wheel) {
+		Int64 cycle = _time >> (BITS*wheel);
+		UInt16 from = UInt8(cycle) + (wheel ? 1 : 0);
+		Int16 index = NextUsed(_used[wheel], from, SLOTS);
+		if (index >= 0)
+			cycle += index - UInt8(cycle);
+		else if ((index = NextUsed(_used[wheel], 0, from)) >= 0)
+			cycle += SLOTS + index - UInt8(cycle);
+		else
+			continue;
+		next = min(next, cycle << (BITS*wheel));
+	}
+	return next;
 }
 
 UInt32 Timer::raise() {
-	while (!_timers.empty()) {
-		const auto& it(_timers.begin());
-		Int64 waiting(it->first-Time::Now());
-		if (waiting>0)
-			return UInt32(waiting); // > 0!
-		auto itTimers(move(it->second));
-		_timers.erase(it);
-		for (const OnTimer* pTimer : *itTimers) {
-			pTimer->_nextRaising = 0;
-			UInt32 timeout = (*pTimer)(UInt32(-waiting));
-			--_count;
-			if(timeout)
-				add(*pTimer, timeout);
+	Int64 now = Time::Now();
+	if (!_count) {
+		_time = now + 1;
+		return 0; //empty!
+	}
+	while (_time <= now) {
+		UInt8 index = UInt8(_time);
+		if (_slots[index]) {
+			// move slot in raising slot, to allow a timer callback to remove any other timer
+			const OnTimer* pTimer = _slots[RAISING] = _slots[index];
+			_slots[index] = NULL;
+			_used[0][index >> 6] &= ~(UInt64(1) << (index & 63));
+			for (; pTimer; pTimer = pTimer->_pNext)
+				pTimer->_slot = RAISING;
+			while ((pTimer = _slots[RAISING])) {
+				UInt32 delay = UInt32(now - pTimer->_nextRaising);
+				unlink(*pTimer);
+				UInt32 timeout = (*pTimer)(delay);
+				if (timeout)
+					set(*pTimer, timeout);
+				--_count;
+			}
 		}
+		// jump to the next used slot of this cycle, or to the next cycle
+		Int16 next = NextUsed(_used[0], index + 1, SLOTS);
+		_time = min(next >= 0 ? (_time + next - index) : ((_time | (SLOTS - 1)) + 1), now + 1);
+		if (!UInt8(_time))
+			cascade(1);
 	}
-	return 0; //empty!
+	return _count ? UInt32(next() - now) : 0; // > 0!
 }
 
 
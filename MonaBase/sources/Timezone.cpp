@@ -565,22 +565,53 @@ Int32 Timezone::offset(const Date& date, bool& isDST) {
 
 	time += date.offset();
 
-	auto it(_transitions.lower_bound(time));
-	if (it == _transitions.end()) {
-		// use default rules
-		if (time < ruleToTime(date.year(), true, _startDST) || time >= ruleToTime(date.year(), false, _endDST))
-			return _offset;
-		isDST = true;
-		return _dstOffset;
-	}
-	if (it->first != time) {
-		if (it == _transitions.begin())
-			return _offset; // before every transition, so no daylight (in the past, no daylight saving time!)
-		--it;
+	// offset is constant during a DST period, keep the last period by thread to skip transitions search and rules computation
+	static thread_local struct Period { // trivially destructible to stay usable by logs of static destructions
+		Period() : start(0), end(0), offset(0), isDST(false) {}
+		Int64	start;
+		Int64	end;
+		Int32	offset;
+		bool	isDST;
+	} _Period;
+	if (time < _Period.start || time >= _Period.end) {
+		_Period.offset = _offset;
+		_Period.isDST = false;
+		auto it(_transitions.lower_bound(time));
+		if (it == _transitions.end()) {
+			// use default rules, period is bounded by the year and its transitions
+			Int32 year(Date(time, Timezone::GMT).year());
+			Int64 startDST(ruleToTime(year, true, _startDST)), endDST(ruleToTime(year, false, _endDST));
+			_Period.start = _transitions.empty() ? Int64(Date(year, 1, 1, Timezone::GMT)) : max(Int64(Date(year, 1, 1, Timezone::GMT)), _transitions.rbegin()->first + 1);
+			_Period.end = Date(year + 1, 1, 1, Timezone::GMT);
+			for (Int64 boundary : { startDST, endDST }) {
+				if (boundary <= time)
+					_Period.start = max(_Period.start, boundary);
+				else
+					_Period.end = min(_Period.end, boundary);
+			}
+			if (time >= startDST && time < endDST) {
+				_Period.offset = _dstOffset;
+				_Period.isDST = true;
+			}
+		} else if (it->first == time) {
+			_Period.start = time;
+			_Period.end = ++it == _transitions.end() ? (time + 1) : it->first;
+			--it;
+			_Period.offset = it->second.offset;
+			_Period.isDST = it->second.isDST;
+		} else {
+			_Period.end = it->first;
+			if (it == _transitions.begin()) // before every transition, so no daylight (in the past, no daylight saving time!)
+				_Period.start = -1693785600;
+			else {
+				_Period.start = (--it)->first;
+				_Period.offset = it->second.offset;
+				_Period.isDST = it->second.isDST;
+			}
+		}
 	}
-	if (it->second.isDST)
-		isDST = true;
-	return it->second.offset;
+	isDST = _Period.isDST;
+	return _Period.offset;
 }
 
 Int64 Timezone::ruleToTime(Int32 year, bool isDST, const TransitionRule& rule) {
@@ -25,7 +25,7 @@ namespace Mona {
 
 const shared<Socket>& UDPSocket::socket() {
 	if (!_pSocket) {
-		_sendingTrack = 0;
+		_sendingTrack.reset();
 		_pSocket.set(Socket::TYPE_DATAGRAM);
 		Exception ex;
 		_subscribed = io.subscribe(ex, _pSocket, newDecoder(), onPacket, onFlush, onError);
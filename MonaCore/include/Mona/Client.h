@@ -73,6 +73,7 @@ struct Client : Entity, virtual Object, Net::Stats {
 	Time						sendTime() const { return _pNetStats->sendTime(); }
 	UInt64						sendByteRate() const { return _pNetStats->sendByteRate(); }
 	double						sendLostRate() const { return _pNetStats->sendLostRate(); }
+	UInt64						sendSyscallsSaved() const { return _pNetStats->sendSyscallsSaved(); }
 	
 	Writer&						writer() { return *_pWriter; }
 
@@ -27,11 +27,14 @@ namespace Mona {
 
 struct HTTPFileSender : HTTPSender, File, File::Decoder, virtual Object {
 	/*!
-	File send */
+	File send, zero-copy sending (sendfile) if file size >= zeroCopy (0 to disable) on a not secure or kTLS connection */
 	HTTPFileSender(const shared<const HTTP::Header>& pRequest, const shared<Socket>& pSocket,
-		const Path& file, Parameters& properties);
+		const Path& file, Parameters& properties, UInt32 zeroCopy = 0);
 
 	const Path& path() const { return self; }
+	/*!
+	To call on socket flush, returns true if sending has been paused on congestion and must be resumed by a new reading */
+	bool		flushed() { _flushed = true; return _paused.exchange(false); }
 
 private:
 	bool				load(Exception& ex);
@@ -42,6 +45,9 @@ private:
 	Parameters				_properties;
 	MIME::Type				_mime;
 	const char*				_subMime;
+	UInt32					_zeroCopy;
+	std::atomic<bool>		_paused;
+	std::atomic<bool>		_flushed;
 
 	// For search!
 	Parameters::const_iterator	_result;
@@ -37,6 +37,9 @@ struct HTTPWriter : Writer, Media::Target, virtual Object {
 	void			endRequest();
 
 	UInt64			queueing() const { return _session->queueing(); }
+	/*!
+	Minimum file size to send it with zero-copy on a not secure connection, 0 to disable */
+	UInt32			zeroCopy;
 
 	void			clear() { _pResponse.reset(); _senders.clear();  }
 
@@ -32,6 +32,7 @@ struct HTTProtocol : TCProtocol, virtual Object {
 		setNumber("timeout", 10); // ideal value between 7 and 10, but take 10 to be equal to max keyframe interval configurable for a video (10sec), to allow a live streaming not interrupted by session timeout
 		setBoolean("index", true); // index directory, if false => forbid directory index, otherwise redirection to index
 		setBoolean("rendezVous", false);
+		setNumber("zeroCopy", 0x40000); // file from 256KB are sent with zero-copy (sendfile) on not secure or kTLS connection, 0 to disable
 
 		onConnection = [this](const shared<Socket>& pSocket) {
 			// Create session
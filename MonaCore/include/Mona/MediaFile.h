@@ -152,7 +152,7 @@ struct MediaFile : virtual Static  {
 			Write(const shared<File>& pFile) : _pFile(pFile), Runner("MediaFileWrite") {}
 		private:
 			virtual void process(Exception& ex, File& file) = 0;
-			bool run(Exception& ex) { process(ex, *_pFile); return true; }
+			bool run(Exception& ex) { Buffer::Allocator::Tag::Scope tag(MediaWriter::BufferTag); process(ex, *_pFile); return true; }
 			shared<File>		_pFile;
 		};
 
@@ -181,7 +181,7 @@ struct MediaFile : virtual Static  {
 
 		shared<File>			 _pFile;
 		shared<MediaWriter>		 _pWriter;
-		UInt16					 _writeTrack;
+		ThreadPool::Track		 _writeTrack;
 		bool					 _append;
 		UInt8					 _sequences;
 		shared<Playlist::Writer> _pPlaylist;
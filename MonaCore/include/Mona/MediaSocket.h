@@ -124,7 +124,7 @@ struct MediaSocket : virtual Static {
 			MediaWriter::OnWrite	onWrite;
 			shared<MediaWriter>		pWriter;
 		private:
-			virtual bool run(Exception& ex) { pWriter->beginMedia(onWrite); return true; }
+			virtual bool run(Exception& ex) { Buffer::Allocator::Tag::Scope tag(MediaWriter::BufferTag); pWriter->beginMedia(onWrite); return true; }
 
 			shared<Socket>			_pSocket;
 			shared<std::string>		_pName;
@@ -134,11 +134,11 @@ struct MediaSocket : virtual Static {
 		struct MediaSend : Send, MediaType, virtual Object {
 			MediaSend(MediaStream::Type type, const shared<std::string>& pName, const shared<Socket>& pSocket, const shared<MediaWriter>& pWriter,
 				UInt8 track, const typename MediaType::Tag& tag, const Packet& packet) : Send(type, pName, pSocket,pWriter), MediaType(tag, packet, track) {}
-			bool run(Exception& ex) { pWriter->writeMedia(*this, onWrite); return true; }
+			bool run(Exception& ex) { Buffer::Allocator::Tag::Scope tag(MediaWriter::BufferTag); pWriter->writeMedia(*this, onWrite); return true; }
 		};
 		struct EndSend : Send, virtual Object {
 			EndSend(MediaStream::Type type, const shared<std::string>& pName, const shared<Socket>& pSocket, const shared<MediaWriter>& pWriter) : Send(type, pName, pSocket, pWriter) {}
-			bool run(Exception& ex) { pWriter->endMedia(onWrite); return true; }
+			bool run(Exception& ex) { Buffer::Allocator::Tag::Scope tag(MediaWriter::BufferTag); pWriter->endMedia(onWrite); return true; }
 		};
 
 		Socket::OnDisconnection			_onSocketDisconnection;
@@ -148,7 +148,7 @@ struct MediaSocket : virtual Static {
 		shared<Socket>					_pSocket;
 		shared<TLS>						_pTLS;
 		shared<MediaWriter>				_pWriter;
-		UInt16							_sendTrack;
+		ThreadPool::Track				_sendTrack;
 		shared<std::string>				_pName;
 		bool							_httpAnswer; /// true to send an http answer if instanciated by MediaServer
 	};
@@ -27,6 +27,9 @@ struct MediaWriter : virtual Object {
 	/// Media container writer must be able to support a dynamic change of audio/video codec!
 
 	static unique<MediaWriter> New(const char* subMime);
+	/*!
+	Allocation tag to scope media writing (see Buffer::Allocator::Tag) */
+	static Buffer::Allocator::Tag BufferTag;
 
 	virtual const char*	format() const;
 	virtual MIME::Type	mime() const;
@@ -35,7 +35,7 @@ struct RTMFPReceiver : RTMFP::Session, virtual Object {
 		const UInt8* decryptKey, const UInt8* encryptKey,
 		const SocketAddress& address, const shared<RendezVous>& pRendezVous);
 
-	UInt16					track;
+	ThreadPool::Track		track;
 	bool					obsolete(const Time& now = Time::Now());
 	std::set<SocketAddress>	localAddresses;
 	
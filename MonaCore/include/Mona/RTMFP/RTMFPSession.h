@@ -80,7 +80,7 @@ private:
 	std::map<UInt64,Flow>					_flows;
 	std::map<UInt64, shared<RTMFPWriter>>	_writers;
 	UInt64									_nextWriterId;
-	UInt16									_senderTrack;
+	ThreadPool::Track						_senderTrack;
 	Flow*									_pFlow;
 
 	shared<RTMFP::Session>					_pSession;
@@ -33,7 +33,7 @@ struct Server : protected ServerAPI, private Thread {
 		ServerAPI& _api;
 	};
 
-	Server(UInt16 cores=0);
+	Server(UInt16 cores=0, UInt16 reactors=1);
 	virtual ~Server();
 
 	void start() { Parameters parameters;  start(parameters); }// params by default
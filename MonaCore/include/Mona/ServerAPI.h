@@ -23,6 +23,7 @@ details (or else see http://www.gnu.org/licenses/).
 #include "Mona/Publication.h"
 #include "Mona/ThreadPool.h"
 #include "Mona/IOFile.h"
+#include "Mona/DNSResolver.h"
 #include "Mona/Timer.h"
 #include "Mona/TLS.h"
 #include "Mona/Protocols.h"
@@ -42,9 +43,23 @@ struct ServerAPI : virtual Object, Parameters {
 	
 	const std::map<std::string, Publication>&	publications() { return _publications; }
 
+	/*!
+	Buffer allocation statistics by size class, nothing if buffers are not pooled ("poolBuffers" configuration) */
+	void							bufferStats(std::vector<Buffer::Allocator::Stats>& stats) const { Buffer::Allocator::Statistics(stats); }
+	/*!
+	Buffer allocation tags => for (const Buffer::Allocator::Tag* pTag = api.bufferTags(); pTag; pTag = pTag->next()) */
+	const Buffer::Allocator::Tag*	bufferTags() const { return Buffer::Allocator::Tag::First(); }
+	/*!
+	TLS handshakes resumed (hits) and full (misses) of server side, or client side if client is true, 0 without TLS */
+	UInt64							tlsHits(bool client = false) const { const shared<TLS>& pTLS(client ? pTLSClient : pTLSServer); return pTLS ? pTLS->hits() : 0; }
+	UInt64							tlsMisses(bool client = false) const { const shared<TLS>& pTLS(client ? pTLSClient : pTLSServer); return pTLS ? pTLS->misses() : 0; }
+
 	ThreadPool 				threadPool; // keep in first (must be build before ioSocket and ioFile)
 	IOSocket				ioSocket;
 	IOFile					ioFile;
+	/*!
+	Asynchronous DNS resolution, to call from server thread */
+	DNSResolver				dnsResolver;
 
 	shared<TLS>				pTLSClient;
 	shared<TLS>				pTLSServer;
@@ -102,7 +117,7 @@ struct ServerAPI : virtual Object, Parameters {
 	virtual void			onUnsubscribe(Subscription& subscription, Publication& publication, Client* pClient){}
 
 protected:
-	ServerAPI(std::string& www, std::map<std::string, Publication>& publications, const Handler& handler, const Protocols& protocols, const Timer& timer, UInt16 cores=0);
+	ServerAPI(std::string& www, std::map<std::string, Publication>& publications, const Handler& handler, const Protocols& protocols, const Timer& timer, UInt16 cores=0, UInt16 reactors=1);
 
 private:
 	bool					subscribe(Exception& ex, std::string& stream, Subscription& subscription, Client* pClient);
@@ -95,6 +95,7 @@ private:
 	Protocol&					_protocol;
 	UInt32						_timeout;
 	Congestion					_congestion;
+	Timer::OnTimer				_onManage;
 
 
 	friend struct Sessions;
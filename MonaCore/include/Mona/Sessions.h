@@ -22,6 +22,9 @@ details (or else see http://www.gnu.org/licenses/).
 #include "Mona/Socket.h"
 #include "Mona/Logs.h"
 #include "Mona/Entity.h"
+#include "Mona/SlotMap.h"
+#include "Mona/HashMap.h"
+#include "Mona/Timer.h"
 
 namespace Mona {
 
@@ -32,20 +35,22 @@ enum {
 };
 
 /*!
-Allow to manage sessions + override obsolete session on address duplication */
+Allow to manage sessions + override obsolete session on address duplication.
+Session id comes from a slot table (index + generation, see SlotMap), find by id or by address are O(1).
+Every session is managed by its own timer every MANAGE_INTERVAL ms, with a random first timeout to spread sessions on the interval */
 class Session;
 struct Sessions : virtual Object {
+	enum {
+		MANAGE_INTERVAL = 2000
+	};
 
-	Sessions() {}
+	Sessions(const Timer& timer);
 	virtual ~Sessions();
 
 	template<typename SessionType = Session>
 	SessionType* findByAddress(const SocketAddress& address, Socket::Type type) {
-		auto& map(type == Socket::TYPE_DATAGRAM ? _sessionsByAddress[0] : _sessionsByAddress[1]);
-		const auto& it = map.find(address);
-		if (it == map.end())
-			return NULL;
-		return dynamic_cast<SessionType*>(it->second);
+		Session** ppSession = _sessionsByAddress[type == Socket::TYPE_DATAGRAM ? 0 : 1].find(address);
+		return ppSession ? dynamic_cast<SessionType*>(*ppSession) : NULL;
 	}
 
 
@@ -60,36 +65,28 @@ struct Sessions : virtual Object {
 
 	template<typename SessionType = Session>
 	SessionType* find(UInt32 id) {
-		const auto& it = _sessions.find(id);
-		if (it == _sessions.end())
-			return NULL;
-		return dynamic_cast<SessionType*>(it->second);
+		Session** ppSession = _sessions.find(id);
+		return ppSession ? dynamic_cast<SessionType*>(*ppSession) : NULL;
 	}
 
 	template<typename SessionType, SESSION_OPTIONS options = SESSION_BYADDRESS, typename ...Args>
 	SessionType& create(Args&&... args) {
 		SessionType* pSession = new SessionType(std::forward<Args>(args)...);
-		if (!_freeIds.empty()) {
-			pSession->_id = _freeIds.front()-1;
-			_freeIds.pop_front();
-		} else if (!_sessions.empty())
-			pSession->_id = _sessions.rbegin()->first;
-		
-		while (!_sessions.emplace(++pSession->_id, pSession).second)
-			CRITIC("Bad computing session id, id ", pSession->_id, " already exists");
+		if (!(pSession->_id = _sessions.emplace(pSession)))
+			FATAL_ERROR("Impossible to create more than ", UInt32(SlotMap<Session*>::MAX_SIZE), " sessions");
 
 		pSession->_sessionsOptions = options;
 		addByPeer(*pSession);
 		addByAddress(*pSession);
+		schedule(*pSession);
 		DEBUG(pSession->name(), " created (client.id=", String::Hex(pSession->peer.id, Entity::SIZE),")");
 		return *pSession;
 	}
 
-	void	 manage();
-	
 private:
-
-	void    remove(const std::map<UInt32, Session*>::iterator& it, SESSION_OPTIONS options);
+	void	schedule(Session& session);
+	UInt32	manage(Session& session);
+	void    remove(Session& session, SESSION_OPTIONS options);
 
 	void	addByPeer(Session& session);
 	void	removeByPeer(Session& session);
@@ -98,10 +95,13 @@ private:
 	void	removeByAddress(Session& session);
 	void	removeByAddress(const SocketAddress& address, Session& session);
 
-	std::map<UInt32, Session*>			_sessions;
-	std::deque<UInt32>					_freeIds;
+	SlotMap<Session*>					_sessions;
 	Entity::Map<Session>				_sessionsByPeerId;
-	std::map<SocketAddress, Session*>	_sessionsByAddress[2]; // 0 - UDP, 1 - TCP
+	HashMap<SocketAddress, Session*>	_sessionsByAddress[2]; // 0 - UDP, 1 - TCP
+
+	const Timer&						_timer;
+	Timer::OnTimer						_onRemove; // removes died sessions out of their timer callback (a timer can't be deleted by its callback)
+	std::vector<UInt32>					_died;
 };
 
 
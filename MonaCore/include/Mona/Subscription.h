@@ -21,6 +21,7 @@ details (or else see http://www.gnu.org/licenses/).
 #include "Mona/Mona.h"
 #include "Mona/Congestion.h"
 #include "Mona/MediaWriter.h"
+#include <set>
 
 namespace Mona {
 
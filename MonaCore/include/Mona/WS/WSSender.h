@@ -28,8 +28,10 @@ details (or else see http://www.gnu.org/licenses/).
 
 namespace Mona {
 
+/*!
+Send a WS frame, masked sends payload xored with a random key as required for frames of a client (copied after header) */
 struct WSSender : Runner, virtual Object {
-	WSSender(const shared<Socket>& pSocket, WS::Type type, const Packet& packet, const char* name = NULL);
+	WSSender(const shared<Socket>& pSocket, WS::Type type, const Packet& packet, const char* name = NULL, bool masked = false);
 
 	DataWriter&		writer();
 
@@ -48,10 +50,11 @@ private:
 	shared<Socket>		_pSocket;
 	WS::Type			_type;
 	const char*			_name;
+	const bool			_masked;
 };
 
 struct WSDataSender : WSSender, virtual Object {
-	WSDataSender(const shared<Socket>& pSocket, Media::Data::Type packetType, const Packet& packet, const char* name = NULL) : _packetType(packetType), WSSender(pSocket, WS::TYPE_NIL, packet, name) {}
+	WSDataSender(const shared<Socket>& pSocket, Media::Data::Type packetType, const Packet& packet, const char* name = NULL, bool masked = false) : _packetType(packetType), WSSender(pSocket, WS::TYPE_NIL, packet, name, masked) {}
 private:
 	bool run(Exception&);
 
@@ -27,7 +27,9 @@ namespace Mona {
 
 
 struct WSWriter : Writer, Media::TrackTarget, virtual Object {
-	WSWriter(TCPClient& client, const char* name = NULL) : _client(client), _name(name) {}
+	/*!
+	masked for a client writer, its frames have to be masked */
+	WSWriter(TCPClient& client, const char* name = NULL, bool masked = false) : _client(client), _name(name), _masked(masked) {}
 	
 	const char*		name() const { return _name ? _name : (_client->isSecure() ? "WSS" : "WS"); }
 
@@ -64,10 +66,11 @@ private:
 		if (closed())
 			return NULL;
 		_senders.emplace_back();
-		return &_senders.back().set<SenderType>(_client.socket(), std::forward<Args>(args)..., _name);
+		return &_senders.back().set<SenderType>(_client.socket(), std::forward<Args>(args)..., _name, _masked);
 	}
 
 	const char*						_name;
+	const bool						_masked;
 	TCPClient&						_client;
 	std::vector<shared<WSSender>>	_senders;
 };
@@ -25,8 +25,8 @@ namespace Mona {
 
 
 HTTPFileSender::HTTPFileSender(const shared<const HTTP::Header>& pRequest, const shared<Socket>& pSocket,
-	const Path& file, Parameters& properties) : HTTPSender("HTTPFileSender", pRequest, pSocket),
-		File(file, File::MODE_READ), _properties(move(properties)), _mime(MIME::TYPE_UNKNOWN),
+	const Path& file, Parameters& properties, UInt32 zeroCopy) : HTTPSender("HTTPFileSender", pRequest, pSocket),
+		File(file, File::MODE_READ), _properties(move(properties)), _mime(MIME::TYPE_UNKNOWN), _zeroCopy(zeroCopy), _paused(false), _flushed(false),
 		_pos(0), _step(properties.count()), _stage(0) {
 		_result = _properties.begin(); // do it here to get compatible _properties.begin() and not properties.begin()
 }
@@ -89,7 +89,10 @@ UInt32 HTTPFileSender::decode(shared<Buffer>& pBuffer, bool end) {
 			_mime = MIME::TYPE_APPLICATION;
 			_subMime = "octet-stream";
 		}
-		if (!send(HTTP_CODE_200, _mime, _subMime, end ? size : UINT64_MAX))
+		// zero-copy just for big file without properties to replace (content-length is known), secure connection requires kTLS (else writeFile fails with Ex::Unsupported)
+		if (end || _properties.count() || pRequest->type == HTTP::TYPE_HEAD || File::size() < _zeroCopy)
+			_zeroCopy = 0;
+		if (!send(HTTP_CODE_200, _mime, _subMime, end ? size : (_zeroCopy ? File::size() : UINT64_MAX)))
 			return 0;
 	}
 	// CONTENT
@@ -98,8 +101,30 @@ UInt32 HTTPFileSender::decode(shared<Buffer>& pBuffer, bool end) {
 			if (!send(packet))
 				return 0;
 		}
-		if(!end)
-			return pSocket->queueing() ? 0 : 0xFFFF; // wait next!
+		while (!end) {
+			_flushed = false;
+			if (!pSocket->queueing()) {
+				if (!_zeroCopy || readen() >= File::size())
+					return 0xFFFF; // wait next!
+				// zero-copy sending while socket accepts data
+				Exception ex;
+				int sent = pSocket->writeFile(ex, self, UInt32(min(File::size() - readen(), UInt64(0x100000))));
+				if (sent > 0)
+					continue;
+				if (sent < 0) {
+					if (!ex.cast<Ex::Unsupported>()) {
+						DEBUG(ex); // socket shutdown
+						return 0;
+					}
+					_zeroCopy = 0; // continue with buffered sending
+					continue;
+				}
+			}
+			// congested, wait onFlush to continue (see HTTPWriter::flushing), excepting if it has already happened meanwhile
+			_paused = true;
+			if (!_flushed || !_paused.exchange(false))
+				return 0;
+		}
 	}
 	// END
 	send(Packet::Null()); // to end possible chunked transfer
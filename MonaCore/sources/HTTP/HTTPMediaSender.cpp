@@ -38,6 +38,7 @@ HTTPMediaSender::~HTTPMediaSender() {
 }
 
 void HTTPMediaSender::run() {
+	Buffer::Allocator::Tag::Scope tag(MediaWriter::BufferTag);
 	MediaWriter::OnWrite onWrite([this](const Packet& packet) { send(packet); });
 	if (_first) {
 		// first packet streaming
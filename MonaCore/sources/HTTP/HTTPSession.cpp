@@ -202,6 +202,7 @@ void HTTPSession::onParameters(const Parameters& parameters) {
 	TCPSession::onParameters(parameters);
 	if (_pUpgradeSession)
 		return _pUpgradeSession->onParameters(parameters);
+	_pWriter->zeroCopy = parameters.getNumber<UInt32>("zeroCopy");
 	_index.clear(); // default value
 	_indexDirectory = true; // default value
 	if (parameters.getString("index", _index)) {
@@ -78,7 +78,7 @@ private:
 };
 
 
-HTTPWriter::HTTPWriter(TCPSession& session) : _requestCount(0), _requesting(false), _session(session),
+HTTPWriter::HTTPWriter(TCPSession& session) : _requestCount(0), _requesting(false), _session(session), zeroCopy(0),
 	_onFileReaden([this](shared<Buffer>& pBuffer, bool end) {
 #if !defined(_DEBUG)
 		if (_flushings.empty())
@@ -175,8 +175,8 @@ void HTTPWriter::flushing() {
 		_senders.pop_front();
 	};
 
-	// continue to read the file if paused on congestion
-	if (flushing && !_session->queueing() && _flushings.front().unique()) // if !_flushings.front().unique() => is reading (+ can cause a double call to _onFileReaden)
+	// continue to read the file if paused on congestion (once, a double reading would cause a double call to _onFileReaden)
+	if (flushing && !_session->queueing() && static_pointer_cast<HTTPFileSender>(_flushings.front())->flushed())
 		_session.api.ioFile.read(static_pointer_cast<HTTPFileSender>(_flushings.front()));
 }
 
@@ -208,7 +208,7 @@ void HTTPWriter::writeFile(const Path& file, Parameters& properties) {
 	if(file.isFolder())
 		newSender<HTTPFolderSender>(true, file, properties);
 	else
-		newSender<HTTPFileSender>(true, file, properties);
+		newSender<HTTPFileSender>(true, file, properties, zeroCopy);
 }
 
 DataWriter& HTTPWriter::writeMessage(bool isResponse) {
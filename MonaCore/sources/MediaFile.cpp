@@ -171,7 +171,7 @@ void MediaFile::Writer::Begin::process(Exception& ex, File& file) {
 }
 
 MediaFile::Writer::Writer(const Path& path, unique<MediaWriter>&& pWriter, IOFile& io) : _sequences(1), _append(false),
-	MediaStream(TYPE_FILE, path), io(io), _writeTrack(0), _pWriter(move(pWriter)) {
+	MediaStream(TYPE_FILE, path), io(io), _pWriter(move(pWriter)) {
 	if (String::ICompare(path.extension(), "m3u8") == 0)
 		_pPlaylist.set<M3U8::Writer>(io);
 	if(_pPlaylist)
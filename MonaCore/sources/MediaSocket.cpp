@@ -214,13 +214,13 @@ MediaSocket::Writer::Send::Send(Type type, const shared<string>& pName, const sh
 }
 
 MediaSocket::Writer::Writer(Type type, const Path& path, unique<MediaWriter>&& pWriter, const SocketAddress& address, IOSocket& io, const shared<TLS>& pTLS) :
-	MediaStream(type, path), io(io), _pTLS(pTLS), address(address.host() ? address.host() : IPAddress::Loopback(), address.port()), _sendTrack(0), 
+	MediaStream(type, path), io(io), _pTLS(pTLS), address(address.host() ? address.host() : IPAddress::Loopback(), address.port()), 
 	_pWriter(move(pWriter)), _httpAnswer(false), _subscribed(false) {
 	_onSocketDisconnection = [this]() { stop<Ex::Net::Socket>(LOG_WARN, this->address, " disconnection"); };
 	_onSocketError = [this](const Exception& ex) { stop(state() == STATE_STARTING ? LOG_DEBUG : LOG_WARN, ex); };
 }
 MediaSocket::Writer::Writer(Type type, const Path& path, unique<MediaWriter>&& pWriter, const shared<Socket>& pSocket, IOSocket& io) : _pSocket(pSocket),
-	MediaStream(type, path), io(io), address(pSocket->peerAddress()), _sendTrack(0),
+	MediaStream(type, path), io(io), address(pSocket->peerAddress()),
 	_pWriter(move(pWriter)), _httpAnswer(true), _subscribed(false) {
 	_onSocketDisconnection = [this]() { stop<Ex::Net::Socket>(LOG_WARN, this->address, " disconnection"); };
 	_onSocketError = [this](const Exception& ex) { stop(state() == STATE_STARTING ? LOG_DEBUG : LOG_WARN, ex); };
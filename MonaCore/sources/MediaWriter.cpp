@@ -64,6 +64,8 @@ static const map<size_t, Format> _Formats({
 	{ typeid(RTPWriter<RTP_MPEG>).hash_code(), Format("rtp_mpeg", MIME::TYPE_VIDEO, NULL) }, // Keep NULL to force RTPReader to redefine mime()!
 	{ typeid(RTPWriter<RTP_H264>).hash_code(), Format("rtp_h264", MIME::TYPE_VIDEO, NULL) } // Keep NULL to force RTPReader to redefine mime()!
 });
+Buffer::Allocator::Tag MediaWriter::BufferTag("media writer");
+
 const char* MediaWriter::format() const {
 	return _Formats.at(typeid(*this).hash_code()).name; // keep exception if no exists => developper warn! Add it!
 }
@@ -29,10 +29,10 @@ struct RTMFPDecoder::Handshake : virtual Object {
 	OnHandshake		onHandshake;
 	OnEdgeMember	onEdgeMember;
 
-	Handshake(const Handler& handler, const shared<RendezVous>& pRendezVous) : _recvTime(Time::Now()), track(0), _pResponse(SET), _pRendezVous(pRendezVous), _handler(handler) {}
+	Handshake(const Handler& handler, const shared<RendezVous>& pRendezVous) : _recvTime(Time::Now()), _pResponse(SET), _pRendezVous(pRendezVous), _handler(handler) {}
 
 	Packet					tag;
-	UInt16					track;
+	ThreadPool::Track		track;
 	shared<RTMFPReceiver>	pReceiver;
 
 	bool obsolete(const Time& now = Time::Now()) const { return (now - _recvTime) > 95000; } // 95 seconds, must be less that RTMFPSession timeout (120 seconds), 95 = RTMFP spec.
@@ -30,7 +30,7 @@ RTMFPReceiver::RTMFPReceiver(const Handler& handler,
 		const UInt8* farPubKey, UInt8 farPubKeySize,
 		const UInt8* decryptKey, const UInt8* encryptKey,
 		const SocketAddress& address, const shared<RendezVous>& pRendezVous) : RTMFP::Session(id, farId, farPubKey, farPubKeySize, decryptKey, encryptKey, pRendezVous),
-			_initiatorTime(-1), _echoTime(-1), _handler(handler), track(0), _died(0), _obsolete(0), _address(address),
+			_initiatorTime(-1), _echoTime(-1), _handler(handler), _died(0), _obsolete(0), _address(address),
 			_output([this](UInt64 flowId, UInt32& lost, const Packet& packet) {
 				_handler.queue(onMessage, flowId, lost, packet);
 				lost = 0;
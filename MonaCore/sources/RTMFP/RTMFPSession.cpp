@@ -43,7 +43,7 @@ void RTMFPSession::Flow::unjoin() {
 }
 
 RTMFPSession::RTMFPSession(RTMFProtocol& protocol, ServerAPI& api, shared<Peer>& pPeer) : 
-		_recvLostRate(_recvByteRate), _pFlow(NULL), _mainStream(api, peer), _killing(0), _senderTrack(0), Session(protocol, pPeer), _nextWriterId(0), _timesKeepalive(0) {
+		_recvLostRate(_recvByteRate), _pFlow(NULL), _mainStream(api, peer), _killing(0), Session(protocol, pPeer), _nextWriterId(0), _timesKeepalive(0) {
 
 	_mainStream.onStart = [this](UInt16 id, FlashWriter& writer) {
 		// Stream Begin signal
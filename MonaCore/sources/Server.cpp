@@ -26,7 +26,7 @@ using namespace std;
 namespace Mona {
 
 
-Server::Server(UInt16 cores) : Thread("Server"), ServerAPI(_www, _publications, _handler, _protocols, _timer, cores), _protocols(*this), _handler(wakeUp) {
+Server::Server(UInt16 cores, UInt16 reactors) : Thread("Server"), ServerAPI(_www, _publications, _handler, _protocols, _timer, cores, reactors), _protocols(*this), _handler(wakeUp) {
 	DEBUG(threadPool.threads(), " threads in server threadPool");
 }
  
@@ -85,9 +85,24 @@ bool Server::run(Exception&, const volatile bool& requestStop) {
 			WARN("No TLS/SSL server protocols, no ", key.name(), " file")
 		else
 			AUTO_ERROR(TLS::Create(ex=nullptr, cert, key, pTLSServer), "SSL Server");
+		// kernel TLS offload, sockets which can't get it stay on user space encryption
+		if (getBoolean<false>("TLS.kTLS")) {
+			if (pTLSClient)
+				AUTO_WARN(pTLSClient->setKTLS(ex = nullptr, true), "SSL Client kTLS");
+			if (pTLSServer)
+				AUTO_WARN(pTLSServer->setKTLS(ex = nullptr, true), "SSL Server kTLS");
+		}
+		// session resumption, reconnections avoid a full handshake
+		UInt32 sessionCache(getNumber<UInt32, 20480>("TLS.sessionCache")), sessionTimeout(getNumber<UInt32, 300>("TLS.sessionTimeout"));
+		if (pTLSClient)
+			AUTO_WARN(pTLSClient->setSessionCache(ex = nullptr, sessionCache, sessionTimeout), "SSL Client session cache");
+		if (pTLSServer) {
+			AUTO_WARN(pTLSServer->setSessionCache(ex = nullptr, sessionCache, sessionTimeout), "SSL Server session cache");
+			AUTO_WARN(pTLSServer->setTicketKeysRotation(ex = nullptr, getNumber<UInt32, 3600>("TLS.ticketKeysRotation")), "SSL Server session tickets");
+		}
 	
 		UInt32 countClient(0);
-		Sessions sessions;
+		Sessions sessions(_timer);
 		_protocols.start(self, sessions);
 	
 		onStart();
@@ -96,7 +111,6 @@ bool Server::run(Exception&, const volatile bool& requestStop) {
 		loadIniStreams();
 
 		onManage = ([&](UInt32) {
-			sessions.manage(); // in first to detect session useless died
 			_protocols.manage(); // manage custom protocol manage (resource protocols)
 
 			// Reset subscriptions of streams target
@@ -144,6 +158,8 @@ bool Server::run(Exception&, const volatile bool& requestStop) {
 	Thread::stop(); // to set running() to false (and not more allows to handler to queue Runner)
 	// Stop onManage (useless now)
 	_timer.set(onManage, 0);
+	// Cancel DNS resolutions (their callbacks can reference sessions) and release its socket
+	dnsResolver.clear();
 
 	// Close server sockets to stop reception
 	_protocols.stop();
@@ -24,11 +24,25 @@ using namespace std;
 
 namespace Mona {
 
+Sessions::Sessions(const Timer& timer) : _timer(timer) {
+	_onRemove = [this](UInt32 delay) {
+		for (UInt32 id : _died) {
+			Session** ppSession = _sessions.find(id);
+			if (ppSession) // else already removed (overloaded)
+				remove(**ppSession, SESSION_BYPEER | SESSION_BYADDRESS);
+		}
+		_died.clear();
+		return 0;
+	};
+}
+
 Sessions::~Sessions() {
+	_timer.set(_onRemove, 0);
 	// delete sessions
 	if (!_sessions.empty())
 		WARN("sessions are deleting");
 	for (auto& it : _sessions) {
+		_timer.set(it.second->_onManage, 0);
 		it.second->kill(Session::ERROR_SERVER);
 		delete it.second;
 	}
@@ -50,13 +64,13 @@ void Sessions::addByAddress(Session& session) {
 		const auto& it = map.emplace(session.peer.address, &session);
 		if (it.second)
 			return;
-		INFO(it.first->second->name(), " overloaded by ", session.name(), " (by ", session.peer.address, ")");
-		const auto& itSession = _sessions.find(it.first->second->_id);
-		if (itSession == _sessions.end())
-			CRITIC("Overloaded ", it.first->second->name(), " impossible to find in sessions collection")
+		Session& overloaded(**it.first);
+		INFO(overloaded.name(), " overloaded by ", session.name(), " (by ", session.peer.address, ")");
+		*it.first = &session; // before remove which can move entries of map
+		if (!_sessions.find(overloaded._id))
+			CRITIC("Overloaded ", overloaded.name(), " impossible to find in sessions collection")
 		else
-			remove(itSession, SESSION_BYPEER);
-		it.first->second = &session;
+			remove(overloaded, SESSION_BYPEER);
 	}
 }
 
@@ -73,15 +87,14 @@ void Sessions::removeByAddress(const SocketAddress& address, Session& session) {
 			return; // if no address, was not registered!
 
 		auto& map(dynamic_cast<UDProtocol*>(&session.protocol()) ? _sessionsByAddress[0] : _sessionsByAddress[1]);
-		if (map.erase(address) == 0) {
+		if (!map.erase(address)) {
 			ERROR(session.name(), " unfound in address sessions collection with key ", address);
-			for (auto it = map.begin(); it != map.end(); ++it) {
-				if (it->second == &session) {
-					INFO("The correct key was ", it->first);
-					map.erase(it);
-					break;
-				}
-			}
+			map.eraseIf([&session](const SocketAddress& address, Session* pSession) {
+				if (pSession != &session)
+					return false;
+				INFO("The correct key was ", address);
+				return true;
+			});
 		}
 	}
 }
@@ -91,13 +104,13 @@ void Sessions::addByPeer(Session& session) {
 		const auto& it = _sessionsByPeerId.emplace(session);
 		if (it.second)
 			return;
-		INFO(it.first->second->name(), " overloaded by ", session.name(), " (by peer id)");
-		const auto& itSession = _sessions.find(it.first->second->_id);
-		if (itSession == _sessions.end())
-			CRITIC("Overloaded ", it.first->second->name(), " impossible to find in sessions collection")
-		else
-			remove(itSession, SESSION_BYADDRESS);
+		Session& overloaded(*it.first->second);
+		INFO(overloaded.name(), " overloaded by ", session.name(), " (by peer id)");
 		it.first->second = &session;
+		if (!_sessions.find(overloaded._id))
+			CRITIC("Overloaded ", overloaded.name(), " impossible to find in sessions collection")
+		else
+			remove(overloaded, SESSION_BYADDRESS);
 	}
 }
 
@@ -116,8 +129,7 @@ void Sessions::removeByPeer(Session& session) {
 	}
 }
 
-void Sessions::remove(const map<UInt32, Session*>::iterator& it, SESSION_OPTIONS options) {
-	Session& session(*it->second);
+void Sessions::remove(Session& session, SESSION_OPTIONS options) {
 	DEBUG(session.name(), " deleted (client.id=", String::Hex(session.peer.id, Entity::SIZE),")");
 
 	if (options&SESSION_BYPEER)
@@ -129,25 +141,26 @@ void Sessions::remove(const map<UInt32, Session*>::iterator& it, SESSION_OPTIONS
 	// Here it means an obsolete session, we can kill it
 	session.kill(Session::ERROR_ZOMBIE);
 
-	_freeIds.emplace_back(session._id);
+	_timer.set(session._onManage, 0);
+	_sessions.erase(session._id);
 	delete &session;
-	_sessions.erase(it);
 }
 
 
-void Sessions::manage() {
-	auto it = _sessions.begin();
-	while (it != _sessions.end()) {
-		Session& session(*it->second);
-		if (!session.died && session.manage())
-			session.flush();
-		if (session.died) {
-			auto itRemove(it++);
-			remove(itRemove, SESSION_BYPEER | SESSION_BYADDRESS);
-			continue;
-		}
-		++it;
-	}
+void Sessions::schedule(Session& session) {
+	session._onManage = [this, &session](UInt32 delay) { return manage(session); };
+	_timer.set(session._onManage, 1 + Util::Random<UInt32>() % MANAGE_INTERVAL);
+}
+
+UInt32 Sessions::manage(Session& session) {
+	if (!session.died && session.manage())
+		session.flush();
+	if (!session.died)
+		return MANAGE_INTERVAL;
+	_died.emplace_back(session._id);
+	if (!_onRemove)
+		_timer.set(_onRemove, 1);
+	return 0;
 }
 
 
@@ -55,12 +55,9 @@ BinaryWriter& WS::WriteKey(BinaryWriter& writer, const string& key) {
 }
 
 BinaryReader& WS::Unmask(BinaryReader& reader) {
-	UInt32 i;
-	const UInt8* mask(reader.current());
+	const UInt8* key(reader.current());
 	reader.next(4);
-	UInt8* bytes = BIN reader.current();
-	for(i=0;i<reader.available();++i)
-		bytes[i] ^= mask[i%4];
+	Crypto::Mask(key, BIN reader.current(), reader.available());
 	return reader;
 }
 
@@ -23,10 +23,10 @@ using namespace std;
 namespace Mona {
 
 WSClient::WSClient(IOSocket& io, const char* name) :TCPClient(io), binaryData(false),
-	Client("WS", SocketAddress::Wildcard()), _writer(self, name ? name : "WSClient") {
+	Client("WS", SocketAddress::Wildcard()), _writer(self, name ? name : "WSClient", true) {
 }
 WSClient::WSClient(IOSocket& io, const shared<TLS>& pTLS, const char* name) :TCPClient(io, pTLS), binaryData(false),
-	Client(pTLS ? "WSS" : "WS", SocketAddress::Wildcard()), _writer(self, name ? name : (pTLS ? "WSSClient" : "WSClient")) {
+	Client(pTLS ? "WSS" : "WS", SocketAddress::Wildcard()), _writer(self, name ? name : (pTLS ? "WSSClient" : "WSClient"), true) {
 }
 
 const string& WSClient::url() const {
@@ -52,7 +52,7 @@ bool WSClient::send(Exception& ex, const Packet& packet, int flags) {
 		Socket::SetException(NET_ENOTCONN, ex);
 		return false;
 	}
-	TCPClient::send<WSSender>(socket(), WS::Type(flags ? flags : (binaryData ? WS::TYPE_BINARY : WS::TYPE_TEXT)), packet, _writer.name());
+	TCPClient::send<WSSender>(socket(), WS::Type(flags ? flags : (binaryData ? WS::TYPE_BINARY : WS::TYPE_TEXT)), packet, _writer.name(), true);
 	return true;
 }
 
@@ -18,17 +18,18 @@ details (or else see http://www.gnu.org/licenses/).
 
 #include "Mona/WS/WSSender.h"
 #include "Mona/Session.h"
+#include "Mona/Crypto.h"
 
 using namespace std;
 
 namespace Mona {
 
-WSSender::WSSender(const shared<Socket>& pSocket, WS::Type type, const Packet& packet, const char* name) :
-	_pSocket(pSocket), _packet(move(packet)), _type(type), Runner("WSSender"), _name(name) {}
+WSSender::WSSender(const shared<Socket>& pSocket, WS::Type type, const Packet& packet, const char* name, bool masked) :
+	_pSocket(pSocket), _packet(move(packet)), _type(type), Runner("WSSender"), _name(name), _masked(masked) {}
 
 DataWriter& WSSender::writer() {
 	if (!_pWriter) { 
-		_pBuffer.set(10); // 10 => expect place for header!
+		_pBuffer.set(14); // 14 => expect place for header (with mask key)!
 		if (_type)
 			_pWriter.set<StringWriter<>>(*_pBuffer);
 		else
@@ -55,22 +56,42 @@ bool WSSender::run(Exception&) {
 	}
 
 	if(!_pBuffer)
-		_pBuffer.set(10);
+		_pBuffer.set(14);
 
-	UInt32 size(_pBuffer->size() - 10 + _packet.size());
+	UInt32 size(_pBuffer->size() - 14 + _packet.size());
 	UInt8 headerSize(size < 126 ? 2 : (size < 65536 ? 4 : 10));
+	if (_masked)
+		headerSize += 4;
 
-	_pBuffer->clip(10 - headerSize); // += offset
+	_pBuffer->clip(14 - headerSize); // += offset
 
 	// Write header
 	BinaryWriter writer(_pBuffer->data(), headerSize);
 	writer.write8(_type | 0x80);
-	if (headerSize == 2)
-		writer.write8(size);
-	else if (headerSize == 4)
-		writer.write8(126).write16(size);
+	UInt8 masked(_masked ? 0x80 : 0);
+	if (size < 126)
+		writer.write8(masked | size);
+	else if (size < 65536)
+		writer.write8(masked | 126).write16(size);
 	else
-		writer.write8(127).write64(size);
+		writer.write8(masked | 127).write64(size);
+
+	if (_masked) {
+		UInt8 key[4];
+		Util::Random(key, sizeof(key));
+		writer.write(key, sizeof(key));
+		UInt32 written(_pBuffer->size() - headerSize);
+		Crypto::Mask(key, _pBuffer->data() + headerSize, written);
+		if (_packet) {
+			// packet is masked on copy (shared, can't be modified), key continues where buffer stops
+			UInt8 next[4];
+			for (UInt8 i = 0; i < 4; ++i)
+				next[i] = key[(written + i) & 3];
+			_pBuffer->resize(_pBuffer->size() + _packet.size());
+			Crypto::Mask(next, _packet.data(), _packet.size(), _pBuffer->data() + headerSize + written);
+			_packet = nullptr;
+		}
+	}
 
 	if (!send(Packet(_pBuffer)))
 		return true;
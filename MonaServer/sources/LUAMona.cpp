@@ -38,6 +38,55 @@ static int time(lua_State *pState) {
 		SCRIPT_WRITE_DOUBLE(Time::Now())
 	SCRIPT_CALLBACK_RETURN
 }
+static int bufferStats(lua_State *pState) {
+	SCRIPT_CALLBACK(ServerAPI, api)
+		// size classes
+		vector<Buffer::Allocator::Stats> stats;
+		api.bufferStats(stats);
+		lua_createtable(pState, stats.size(), 0);
+		int index = 0;
+		for (const Buffer::Allocator::Stats& stat : stats) {
+			lua_createtable(pState, 0, 6);
+			lua_pushnumber(pState, stat.capacity);
+			lua_setfield(pState, -2, "capacity");
+			lua_pushnumber(pState, (lua_Number)stat.hits);
+			lua_setfield(pState, -2, "hits");
+			lua_pushnumber(pState, (lua_Number)stat.misses);
+			lua_setfield(pState, -2, "misses");
+			lua_pushnumber(pState, (lua_Number)stat.cached());
+			lua_setfield(pState, -2, "cached");
+			lua_pushnumber(pState, (lua_Number)stat.inUse());
+			lua_setfield(pState, -2, "inUse");
+			lua_pushnumber(pState, (lua_Number)stat.collected);
+			lua_setfield(pState, -2, "collected");
+			lua_rawseti(pState, -2, ++index);
+		}
+		// allocation tags
+		lua_newtable(pState);
+		for (const Buffer::Allocator::Tag* pTag = api.bufferTags(); pTag; pTag = pTag->next()) {
+			lua_createtable(pState, 0, 2);
+			lua_pushnumber(pState, (lua_Number)pTag->count());
+			lua_setfield(pState, -2, "count");
+			lua_pushnumber(pState, (lua_Number)pTag->bytes());
+			lua_setfield(pState, -2, "bytes");
+			lua_setfield(pState, -2, pTag->name);
+		}
+	SCRIPT_CALLBACK_RETURN
+}
+static int tlsStats(lua_State *pState) {
+	SCRIPT_CALLBACK(ServerAPI, api)
+		// { server = { hits, misses }, client = { hits, misses } }
+		lua_createtable(pState, 0, 2);
+		for (UInt8 client = 0; client < 2; ++client) {
+			lua_createtable(pState, 0, 2);
+			lua_pushnumber(pState, (lua_Number)api.tlsHits(client ? true : false));
+			lua_setfield(pState, -2, "hits");
+			lua_pushnumber(pState, (lua_Number)api.tlsMisses(client ? true : false));
+			lua_setfield(pState, -2, "misses");
+			lua_setfield(pState, -2, client ? "client" : "server");
+		}
+	SCRIPT_CALLBACK_RETURN
+}
 static int newIPAddress(lua_State *pState) {
 	SCRIPT_CALLBACK_TRY(ServerAPI, api)
 		if (SCRIPT_NEXT_READABLE) {
@@ -213,6 +262,8 @@ template<> void Script::ObjInit(lua_State *pState, ServerAPI& api) {
 		SCRIPT_DEFINE_FUNCTION("__call", &LUAMap<const Parameters>::Call<LUAMap<const Parameters>::Mapper<ServerAPI>>);
 		SCRIPT_DEFINE_FUNCTION("__pairs", &LUAMap<const Parameters>::Pairs<LUAMap<const Parameters>::Mapper<ServerAPI>>);
 		SCRIPT_DEFINE_FUNCTION("time", &time);
+		SCRIPT_DEFINE_FUNCTION("bufferStats", &bufferStats);
+		SCRIPT_DEFINE_FUNCTION("tlsStats", &tlsStats);
 		SCRIPT_DEFINE_FUNCTION("newPath", &newPath);
 		SCRIPT_DEFINE_FUNCTION("newIPAddress", &newIPAddress);
 		SCRIPT_DEFINE_FUNCTION("newSocketAddress", &newSocketAddress);
@@ -53,6 +53,11 @@ static int sendLostRate(lua_State *pState) {
 		SCRIPT_WRITE_DOUBLE(stats.sendLostRate());
 	SCRIPT_CALLBACK_RETURN;
 }
+static int sendSyscallsSaved(lua_State *pState) {
+	SCRIPT_CALLBACK(Net::Stats, stats);
+		SCRIPT_WRITE_DOUBLE(stats.sendSyscallsSaved());
+	SCRIPT_CALLBACK_RETURN;
+}
 static int queueing(lua_State *pState) {
 	SCRIPT_CALLBACK(Net::Stats, stats);
 		SCRIPT_WRITE_DOUBLE(stats.queueing());
@@ -67,6 +72,7 @@ template<> void Script::ObjInit(lua_State *pState, Net::Stats& stats) {
 		SCRIPT_DEFINE_FUNCTION("sendTime", sendTime);
 		SCRIPT_DEFINE_FUNCTION("sendByteRate", sendByteRate);
 		SCRIPT_DEFINE_FUNCTION("sendLostRate", sendLostRate);
+		SCRIPT_DEFINE_FUNCTION("sendSyscallsSaved", sendSyscallsSaved);
 		SCRIPT_DEFINE_FUNCTION("queueing", queueing);
 	SCRIPT_END;
 }
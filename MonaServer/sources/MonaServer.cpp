@@ -28,7 +28,8 @@ using namespace std;
 namespace Mona {
 
 MonaServer::MonaServer(const Parameters& configs, TerminateSignal& terminateSignal) : _starting(false),
-	Server(configs.getNumber<UInt16>("cores")), _terminateSignal(terminateSignal), _dataPath(configs.getString("data.dir", "data/")) {
+	Server(configs.getNumber<UInt16>("cores"), configs.getNumber<UInt16, 1>("reactors")), _terminateSignal(terminateSignal), _dataPath(configs.getString("data.dir", "data/")),
+	_persistentData("PersistentData", configs.getBoolean<false>("data.log") ? PersistentData::FORMAT_LOG : PersistentData::FORMAT_FOLDERS) {
 
 }
 
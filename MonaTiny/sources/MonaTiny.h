@@ -27,8 +27,8 @@ namespace Mona {
 
 
 struct MonaTiny : Server {
-	MonaTiny(TerminateSignal& terminateSignal, UInt16 cores = 0) :
-		Server(cores), _terminateSignal(terminateSignal) {}
+	MonaTiny(TerminateSignal& terminateSignal, UInt16 cores = 0, UInt16 reactors = 1) :
+		Server(cores, reactors), _terminateSignal(terminateSignal) {}
 
 	virtual ~MonaTiny() { stop(); }
 
@@ -19,7 +19,7 @@ struct ServerApp : ServerApplication  {
 	int main(TerminateSignal& terminateSignal) {
 
 		// starts the server
-		MonaTiny server(terminateSignal, getNumber<UInt16>("cores"));
+		MonaTiny server(terminateSignal, getNumber<UInt16>("cores"), getNumber<UInt16, 1>("reactors"));
 
 		server.start(*this);
 
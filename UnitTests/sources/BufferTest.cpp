@@ -74,4 +74,77 @@ ADD_TEST(BufferPool) {
 	CHECK(buffer1.capacity() == 1024);
 }
 
+ADD_TEST(BufferPoolStats) {
+	static Buffer::Allocator::Tag Tag("test");
+	Buffer::Allocator::Set<BufferPool>();
+	{
+		Buffer::Allocator::Tag::Scope scope(Tag);
+		Buffer buffer1(100), buffer2(100);
+	}
+	{
+		Buffer buffer(100); // from pool
+		CHECK(buffer.capacity() == 128);
+	}
+	CHECK(Tag.count() == 2 && Tag.bytes() == 256);
+	const Buffer::Allocator::Tag* pTag = Buffer::Allocator::Tag::First();
+	while (pTag && pTag != &Tag)
+		pTag = pTag->next();
+	CHECK(pTag);
+
+	vector<Buffer::Allocator::Stats> stats;
+	Buffer::Allocator::Statistics(stats);
+	const Buffer::Allocator::Stats* pStats = NULL;
+	for (const Buffer::Allocator::Stats& stat : stats) {
+		if (stat.capacity == 128)
+			pStats = &stat;
+	}
+	CHECK(pStats && pStats->misses == 2 && pStats->hits == 1 && pStats->frees == 3 && pStats->cached() == 256 && !pStats->inUse() && !pStats->collected);
+
+	Buffer::Allocator::Set(); // default allocator has no statistics
+	stats.clear();
+	Buffer::Allocator::Statistics(stats);
+	CHECK(stats.empty());
+}
+
+ADD_TEST(BufferPoolThreads) {
+	Buffer::Allocator::Set<BufferPool>();
+	// buffers allocated by a thread can be released by an other thread, and content stays intact
+	std::mutex mutex;
+	vector<shared<Buffer>> exchanged;
+	atomic<UInt32> errors(0);
+	vector<thread> threads;
+	for (UInt8 i = 1; i <= 4; ++i) {
+		threads.emplace_back([&mutex, &exchanged, &errors, i]() {
+			vector<shared<Buffer>> buffers;
+			for (UInt32 j = 0; j < 50000; ++j) {
+				UInt32 size = (j & 63) ? (1 + (j * 7919) % 4096) : 300000; // sometimes a big buffer (without magazine)
+				shared<Buffer> pBuffer(SET, size);
+				*pBuffer->data() = pBuffer->data()[size - 1] = i;
+				buffers.emplace_back(move(pBuffer));
+				if (buffers.size() < 32)
+					continue;
+				// check and release buffers, half of them by an other thread
+				lock_guard<std::mutex> lock(mutex);
+				for (shared<Buffer>& pBuffer : exchanged) {
+					if (!*pBuffer->data() || *pBuffer->data() != pBuffer->data()[pBuffer->size() - 1])
+						++errors;
+				}
+				exchanged.clear();
+				for (UInt8 k = 0; k < 16; ++k)
+					exchanged.emplace_back(move(buffers[k]));
+				for (shared<Buffer>& pBuffer : buffers) {
+					if (pBuffer && (*pBuffer->data() != i || pBuffer->data()[pBuffer->size() - 1] != i))
+						++errors;
+				}
+				buffers.clear();
+			}
+		});
+	}
+	for (thread& thread : threads)
+		thread.join();
+	exchanged.clear();
+	CHECK(!errors);
+	Buffer::Allocator::Set(); // release pool with magazines of ended threads
+}
+
 }
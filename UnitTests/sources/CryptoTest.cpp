@@ -0,0 +1,156 @@
+/*
+This file is a part of MonaSolutions Copyright 2017
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License received along this program for more
+details (or else see http://www.gnu.org/licenses/).
+
+*/
+
+#include "Mona/UnitTest.h"
+#include "Mona/Crypto.h"
+#include "Mona/Util.h"
+#include "Mona/Stopwatch.h"
+
+using namespace std;
+using namespace Mona;
+
+namespace CryptoTest {
+
+// previous implementation, table driven byte at a time
+static UInt32 CRC32(const UInt8* data, UInt32 size, ROTATE_OPTIONS options) {
+	static const struct Table {
+		Table() {
+			for (UInt32 i = 0; i < 256; ++i) {
+				values[i] = i << 24;
+				for (UInt8 bit = 0; bit < 8; ++bit)
+					values[i] = (values[i] & 0x80000000) ? ((values[i] << 1) ^ 0x04C11DB7) : (values[i] << 1);
+			}
+		}
+		UInt32 values[256];
+	} Table;
+	UInt32 crc(0xFFFFFFFF);
+	for (UInt32 i = 0; i < size; ++i) {
+		if (options&ROTATE_INPUT)
+			crc = (crc << 8) ^ Table.values[(crc >> 24) ^ Crypto::Rotate8(*data++)];
+		else
+			crc = (crc << 8) ^ Table.values[(crc >> 24) ^ *data++];
+	}
+	return options&ROTATE_OUTPUT ? Crypto::Rotate32(crc) : crc;
+}
+
+ADD_TEST(CRC32) {
+	// check values of CRC-32/MPEG-2 and CRC-32/JAMCRC
+	CHECK(Crypto::ComputeCRC32(BIN EXPAND("123456789")) == 0x0376E6E7);
+	CHECK(Crypto::ComputeCRC32(BIN EXPAND("123456789"), ROTATE_INPUT | ROTATE_OUTPUT) == 0x340BC6D9);
+	CHECK(Crypto::ComputeCRC32(NULL, 0) == 0xFFFFFFFF);
+
+	// every size (table tail, slices of 8 bytes, 16 bytes blocks, 64 bytes lanes) and every alignment
+	vector<UInt8> data(4096 + 16);
+	Util::Random(data.data(), data.size());
+	for (ROTATE_OPTIONS options = 0; options <= (ROTATE_INPUT | ROTATE_OUTPUT); ++options) {
+		for (UInt32 size = 0; size <= 300; ++size) {
+			for (UInt8 offset = 0; offset < 16; offset += 5)
+				CHECK(Crypto::ComputeCRC32(data.data() + offset, size, options) == CRC32(data.data() + offset, size, options));
+		}
+		for (UInt32 size = 1000; size <= 4096; size += 613)
+			CHECK(Crypto::ComputeCRC32(data.data() + 3, size, options) == CRC32(data.data() + 3, size, options));
+	}
+	// all zeros and all ones
+	memset(data.data(), 0, data.size());
+	CHECK(Crypto::ComputeCRC32(data.data(), 1024) == CRC32(data.data(), 1024, 0));
+	memset(data.data(), 0xFF, data.size());
+	CHECK(Crypto::ComputeCRC32(data.data(), 1024, ROTATE_INPUT) == CRC32(data.data(), 1024, ROTATE_INPUT));
+}
+
+ADD_TEST(CRC32Benchmark) {
+	// PSI tables (PAT/PMT of TS packets) and large buffers
+	static const UInt32 Sizes[] = { 183, 4096, 1024 * 1024 };
+	vector<UInt8> data(1024 * 1024);
+	Util::Random(data.data(), data.size());
+	for (UInt32 size : Sizes) {
+		for (ROTATE_OPTIONS options = 0; options <= ROTATE_INPUT; options += ROTATE_INPUT) {
+			UInt32 loops = 64 * 1024 * 1024 / size, crc(0);
+			Stopwatch chrono;
+			chrono.start();
+			for (UInt32 i = 0; i < loops; ++i)
+				crc ^= Crypto::ComputeCRC32(data.data(), size, options);
+			chrono.stop();
+			Int64 elapsed(chrono.elapsed());
+			// previous implementation on 8x less data
+			chrono.restart();
+			for (UInt32 i = 0; i < loops; i += 8)
+				crc ^= CRC32(data.data(), size, options);
+			chrono.stop();
+			CHECK(crc != 0x5A5A5A5A); // use result
+			NOTE("CRC32", options ? " ROTATE_INPUT" : "", " of ", size, " bytes: ", UInt64(loops) * size / 1000 / (elapsed + 1), "MB/s (previous ", UInt64(loops / 8) * size / 1000 / (chrono.elapsed() + 1), "MB/s)");
+		}
+	}
+}
+
+
+// previous implementation of WS::Unmask, byte at a time
+static void Mask(const UInt8* key, UInt8* data, UInt32 size) {
+	for (UInt32 i = 0; i < size; ++i)
+		data[i] ^= key[i % 4];
+}
+
+ADD_TEST(Mask) {
+	// every size (vectors of 16 and 32 bytes, unrolled loops, 8 bytes words and bytes tail), every alignment of data and output
+	const UInt8 key[] = { 0x37, 0xFA, 0x21, 0x3D };
+	vector<UInt8> data(4096 + 32), expected(data.size()), output(data.size() + 32);
+	Util::Random(data.data(), data.size());
+	for (UInt32 size = 0; size <= 300; ++size) {
+		for (UInt8 offset = 0; offset < 32; offset += 7) {
+			memcpy(expected.data(), data.data() + offset, size);
+			Mask(key, expected.data(), size);
+			CHECK(Crypto::Mask(key, data.data() + offset, size, output.data() + 31 - offset) == output.data() + 31 - offset);
+			CHECK(memcmp(output.data() + 31 - offset, expected.data(), size) == 0);
+			// in place
+			memcpy(output.data() + offset, data.data() + offset, size);
+			Crypto::Mask(key, output.data() + offset, size);
+			CHECK(memcmp(output.data() + offset, expected.data(), size) == 0);
+		}
+	}
+	for (UInt32 size = 1000; size <= 4096; size += 613) {
+		memcpy(expected.data(), data.data() + 3, size);
+		Mask(key, expected.data(), size);
+		CHECK(memcmp(Crypto::Mask(key, data.data() + 3, size, output.data() + 1), expected.data(), size) == 0);
+		// unmask restores data
+		Crypto::Mask(key, output.data() + 1, size);
+		CHECK(memcmp(output.data() + 1, data.data() + 3, size) == 0);
+	}
+}
+
+ADD_TEST(MaskBenchmark) {
+	// WS frames from 1KB to 1MB, in place as WS::Unmask
+	const UInt8 key[] = { 0x37, 0xFA, 0x21, 0x3D };
+	vector<UInt8> data(1024 * 1024 + 1);
+	Util::Random(data.data(), data.size());
+	for (UInt32 size = 1024; size <= 1024 * 1024; size *= 4) {
+		UInt32 loops = 1024 * 1024 * 1024 / size;
+		Stopwatch chrono;
+		chrono.start();
+		for (UInt32 i = 0; i < loops; ++i)
+			Crypto::Mask(key, data.data() + 1, size); // unaligned
+		chrono.stop();
+		Int64 elapsed(chrono.elapsed());
+		// previous implementation on 32x less data
+		chrono.restart();
+		for (UInt32 i = 0; i < loops; i += 32)
+			Mask(key, data.data() + 1, size);
+		chrono.stop();
+		NOTE("Mask of ", size, " bytes: ", String::Format<double>("%.2f", double(loops) * size / 1000000 / (elapsed + 1)), "GB/s (previous ", String::Format<double>("%.2f", double(loops / 32) * size / 1000000 / (chrono.elapsed() + 1)), "GB/s)");
+	}
+}
+
+}
@@ -0,0 +1,205 @@
+/*
+This file is a part of MonaSolutions Copyright 2017
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License received along this program for more
+details (or else see http://www.gnu.org/licenses/).
+
+*/
+
+#include "Mona/UnitTest.h"
+#include "Mona/DNSResolver.h"
+#include "Mona/BinaryReader.h"
+#include "Mona/BinaryWriter.h"
+
+using namespace std;
+using namespace Mona;
+
+namespace DNSResolverTest {
+
+struct MainHandler : Handler {
+	MainHandler() : Handler(_signal) {}
+	bool join(Timer& timer, const function<bool()>& joined) {
+		for (;;) {
+			UInt32 timeout = timer.raise(); // timeout gives result too
+			if (joined())
+				return true;
+			if (!_signal.wait(timeout ? timeout : 14000) && !timeout)
+				return false;
+			flush();
+		}
+	}
+private:
+	Signal _signal;
+};
+
+static ThreadPool	_ThreadPool;
+
+/*!
+Stub DNS server on 127.0.0.1:
+- host.test => A 1.2.3.4 and AAAA ::1, TTL 1s
+- alias.test => CNAME host.test + records of host.test
+- nohost.test => NXDOMAIN, SOA minimum 1s
+- fail.test => SERVFAIL
+- mute.test => no answer
+- spoof.test => answer of host.test sent from an other address */
+struct DNSServer : UDPSocket {
+	DNSServer(IOSocket& io) : UDPSocket(io), _spoofer(Socket::TYPE_DATAGRAM) {
+		onError = [](const Exception& ex) { FATAL_ERROR("DNSServer, ", ex); };
+		onPacket = [this](shared<Buffer>& pBuffer, const SocketAddress& address) {
+			BinaryReader reader(pBuffer->data(), pBuffer->size());
+			UInt16 id = reader.read16();
+			reader.next(10);
+			string name;
+			while (UInt8 size = reader.read8()) {
+				if (!name.empty())
+					name += '.';
+				name.append(STR reader.current(), size);
+				reader.next(size);
+			}
+			UInt16 type = reader.read16();
+			reader.next(2);
+			++queries[name];
+			if (name == "mute.test")
+				return;
+
+			UInt16 rcode = name == "fail.test" ? 2 : (name == "nohost.test" ? 3 : 0);
+			bool alias = name == "alias.test";
+			shared<Buffer> pAnswer(SET);
+			BinaryWriter writer(*pAnswer);
+			writer.write16(id).write16(0x8180 | rcode).write16(1).write16(rcode ? 0 : (alias ? 2 : 1)).write16(rcode == 3 ? 1 : 0).write16(0);
+			writer.write(pBuffer->data() + 12, reader.position() - 12); // question
+			UInt16 owner = 12; // pointer on question name
+			if (alias) {
+				writer.write16(0xC000 | owner).write16(5).write16(1).write32(60).write16(11);
+				owner = UInt16(pAnswer->size());
+				writer.write8(4).write(EXPAND("host")).write8(4).write(EXPAND("test")).write8(0);
+			}
+			if (!rcode) {
+				writer.write16(0xC000 | owner).write16(type).write16(1).write32(1);
+				if (type == 1)
+					writer.write16(4).write32(0x01020304);
+				else
+					writer.write16(16).write32(0).write32(0).write32(0).write32(1);
+			} else if (rcode == 3) // SOA (root owner, mname and rname), minimum = 1s
+				writer.write8(0).write16(6).write16(1).write32(3600).write16(22).write8(0).write8(0).write32(1).write32(0).write32(0).write32(0).write32(1);
+			Exception ex;
+			if (name == "spoof.test") {
+				CHECK(_spoofer.sendTo(ex, pAnswer->data(), pAnswer->size(), address) == int(pAnswer->size()) && !ex);
+			} else
+				CHECK(send(ex, Packet(pAnswer), address) && !ex);
+		};
+	}
+	~DNSServer() {
+		onPacket = nullptr;
+		onError = nullptr;
+	}
+	map<string, UInt32> queries;
+private:
+	Socket _spoofer;
+};
+
+ADD_TEST(Resolve) {
+	MainHandler	handler;
+	IOSocket	io(handler, _ThreadPool);
+	Timer		timer;
+	Exception	ex;
+
+	DNSServer server(io);
+	CHECK(server.bind(ex, IPAddress::Loopback()) && !ex);
+
+	DNSResolver resolver(io, timer);
+	resolver.servers.assign(1, SocketAddress(IPAddress::Loopback(), server->address().port()));
+	resolver.timeout = 100;
+	resolver.attempts = 2;
+
+	UInt32 resolved(0);
+	Exception result;
+	set<IPAddress> addresses;
+	string name;
+	vector<string> aliases;
+	DNSResolver::OnResolved onResolved([&](const Exception& ex, const HostEntry& host) {
+		++resolved;
+		result = ex;
+		addresses = host.addresses();
+		name = host.name();
+		aliases = host.aliases();
+	});
+	IPAddress ipv4, ipv6;
+	CHECK(ipv4.set(ex, "1.2.3.4") && ipv6.set(ex, "::1") && !ex);
+
+	// IP doesn't need a query
+	resolver.resolve("127.0.0.1", onResolved);
+	CHECK(resolved == 1 && !result && addresses.size() == 1 && *addresses.begin() == IPAddress::Loopback() && server.queries.empty());
+
+	// A + AAAA
+	resolver.resolve("Host.Test.", onResolved);
+	CHECK(resolved == 1 && resolver.resolving() == 1);
+	CHECK(handler.join(timer, [&]() { return resolved == 2; }));
+	CHECK(!result && name == "host.test" && aliases.empty() && addresses.size() == 2 && addresses.count(ipv4) && addresses.count(ipv6));
+	CHECK(server.queries["host.test"] == 2 && !resolver.resolving() && resolver.cached() == 1);
+	// cache
+	resolver.resolve("host.test", onResolved);
+	CHECK(resolved == 3 && !result && addresses.size() == 2 && server.queries["host.test"] == 2);
+
+	// CNAME, and concurrent resolutions share the same queries
+	resolver.resolve("alias.test", onResolved);
+	resolver.resolve("alias.test", onResolved);
+	CHECK(handler.join(timer, [&]() { return resolved == 5; }));
+	CHECK(!result && name == "host.test" && aliases.size() == 1 && aliases[0] == "alias.test" && addresses.size() == 2);
+	CHECK(server.queries["alias.test"] == 2);
+
+	// negative cache
+	resolver.resolve("nohost.test", onResolved);
+	CHECK(handler.join(timer, [&]() { return resolved == 6; }));
+	CHECK(result && addresses.empty() && server.queries["nohost.test"] == 2);
+	resolver.resolve("nohost.test", onResolved);
+	CHECK(resolved == 7 && result && server.queries["nohost.test"] == 2);
+
+	// server failure is not cached
+	resolver.resolve("fail.test", onResolved);
+	CHECK(handler.join(timer, [&]() { return resolved == 8; }));
+	CHECK(result && addresses.empty());
+	resolver.resolve("fail.test", onResolved);
+	CHECK(resolved == 8 && resolver.resolving() == 1);
+	CHECK(handler.join(timer, [&]() { return resolved == 9; }));
+
+	// timeout after 2 attempts
+	resolver.resolve("mute.test", onResolved);
+	CHECK(handler.join(timer, [&]() { return resolved == 10; }));
+	CHECK(result && server.queries["mute.test"] == 4 && !resolver.resolving());
+
+	// answer from an other address than server queried is ignored
+	resolver.resolve("spoof.test", onResolved);
+	CHECK(handler.join(timer, [&]() { return resolved == 11; }));
+	CHECK(result && addresses.empty() && server.queries["spoof.test"] == 4);
+
+	// TTL expiration (1s for host.test and nohost.test)
+	Thread::Sleep(1100);
+	resolver.resolve("host.test", onResolved);
+	resolver.resolve("nohost.test", onResolved);
+	CHECK(resolved == 11);
+	CHECK(handler.join(timer, [&]() { return resolved == 13; }));
+	CHECK(server.queries["host.test"] == 4 && server.queries["nohost.test"] == 4);
+
+	// invalid name
+	resolver.resolve("bad..test", onResolved);
+	CHECK(resolved == 14 && result);
+
+	resolver.clear();
+	CHECK(!resolver.cached());
+	server.close();
+	_ThreadPool.join();
+	handler.flush();
+}
+
+}
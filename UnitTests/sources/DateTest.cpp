@@ -21,6 +21,7 @@ details (or else see http://www.gnu.org/licenses/).
 #include "Mona/Timezone.h"
 #include "Mona/Util.h"
 #include "Mona/Logs.h"
+#include "Mona/Stopwatch.h"
 
 using namespace Mona;
 using namespace std;
@@ -330,4 +331,55 @@ ADD_TEST(ParseGuess) {
 	CHECK(Parse("2005-01-08T12:30:00.123456-02:00", 2005,1,8, 6, 12, 30, 0, 123, -7200000));
 }
 
+static const char* _Formats[] = { Date::FORMAT_ISO8601, Date::FORMAT_ISO8601_FRAC, Date::FORMAT_ISO8601_SHORT_FRAC, Date::FORMAT_RFC822, Date::FORMAT_HTTP,
+	Date::FORMAT_RFC850, Date::FORMAT_ASCTIME, Date::FORMAT_SORTABLE, "%d/%m %H:%M:%S.%c  ", "%i|%F|%c|%s|%Ts|%Tx|%%|%" };
+
+ADD_TEST(FormatCache) {
+	// cached format gives the same result than format for every format, offset and time (milliseconds patched, second changes, negative times)
+	String out, cached;
+	Int64 now(Time::Now());
+	for (Int32 offset : { Int32(Timezone::LOCAL), Int32(Timezone::GMT), 3600000, -5400000 }) {
+		for (const char* format : _Formats) {
+			for (UInt32 i = 0; i < 2000; ++i) {
+				Int64 time = i < 1000 ? (now + i * 7) : (Int64(Util::Random<Int32>()) * 1000 + Util::Random<UInt16>() % 1000);
+				CHECK(Date::Format(format, time, cached.clear(), offset) == Date(time, offset).format(format, out.clear()));
+			}
+		}
+	}
+	// result can be appended
+	CHECK(Date::Format(Date::FORMAT_SORTABLE, 1000000000123, out.clear(), Timezone::GMT) == "2001-09-09 01:46:40");
+
+	// offset of DST periods kept by thread: same result whatever thread and order of times
+	vector<Int32> offsets;
+	Int64 time(Date(Date(now).year() - 2, 1, 1, Timezone::GMT));
+	for (UInt32 i = 0; i < 5 * 365 * 24; ++i)
+		offsets.emplace_back(Date(time + i * 3600000ll).offset());
+	thread([&offsets, time]() {
+		for (UInt32 i = offsets.size(); i > 0; --i)
+			CHECK(Date(time + (i - 1) * 3600000ll).offset() == offsets[i - 1]);
+	}).join();
+}
+
+ADD_TEST(FormatBenchmark) {
+	// logs and HTTP Date header format the current time, here 1M times of 1ms progression
+	static const UInt32 Count(1000000);
+	Int64 now(Time::Now());
+	String out;
+	Stopwatch chrono;
+	for (const char* format : { Date::FORMAT_HTTP, "%d/%m %H:%M:%S.%c  " }) {
+		UInt32 size(0);
+		chrono.restart();
+		for (UInt32 i = 0; i < Count; ++i)
+			size += Date(now + i).format(format, out.clear()).size();
+		chrono.stop();
+		Int64 elapsed(chrono.elapsed());
+		chrono.restart();
+		for (UInt32 i = 0; i < Count; ++i)
+			size -= Date::Format(format, now + i, out.clear()).size();
+		chrono.stop();
+		CHECK(!size);
+		NOTE("\"", format, "\" ", Count, " formats: Date::format ", elapsed, "ms, Date::Format cached ", chrono.elapsed(), "ms");
+	}
+}
+
 }
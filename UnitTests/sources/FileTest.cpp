@@ -19,6 +19,9 @@ details (or else see http://www.gnu.org/licenses/).
 #include "Mona/UnitTest.h"
 #include "Mona/FileReader.h"
 #include "Mona/FileWriter.h"
+#include "Mona/Stopwatch.h"
+#include "Mona/Net.h"
+#include <ctime>
 
 using namespace std;
 using namespace Mona;
@@ -66,6 +69,17 @@ static struct MainHandler : Handler {
 		};
 		return count == done;
 	}
+	bool join(const function<bool()>& joined, UInt32 timeout = 5000) {
+		Stopwatch chrono;
+		chrono.start();
+		while (!joined()) {
+			if (chrono.elapsed() > timeout)
+				return false;
+			_signal.wait(100);
+			Handler::flush();
+		}
+		return true;
+	}
 
 private:
 	void flush() {}
@@ -73,7 +87,7 @@ private:
 } _Handler;
 static ThreadPool	_ThreadPool;
 
-ADD_TEST(FileReader) {
+static void TestFileReader() {
 	IOFile		io(_Handler, _ThreadPool);
 
 	const char* name("temp.mona");
@@ -100,7 +114,11 @@ ADD_TEST(FileReader) {
 	CHECK(_Handler.join(3));
 }
 
-ADD_TEST(FileWriter) {
+ADD_TEST(FileReader) {
+	TestFileReader();
+}
+
+static void TestFileWriter() {
 	IOFile		io(_Handler, _ThreadPool);
 	const char* name("temp.mona");
 	Exception ex;
@@ -135,4 +153,167 @@ ADD_TEST(FileWriter) {
 	CHECK(FileSystem::Delete(ex, name) && !ex);
 }
 
+ADD_TEST(FileWriter) {
+	TestFileWriter();
+}
+
+ADD_TEST(FileIOUring) {
+	if (!IOUring::Supported()) {
+		NOTE("io_uring unsupported on this system");
+		return;
+	}
+	// Same readings and writings completed by io_uring
+	Net::SetIOUring(true);
+	const char* name("temp.mona");
+	Exception ex;
+	CHECK(File(name, File::MODE_WRITE).write(ex, EXPAND("Salut")) && !ex);
+	TestFileReader();
+	TestFileWriter();
+
+	// writings of a file stay ordered
+	{
+		IOFile		io(_Handler, _ThreadPool);
+		FileWriter writer(io);
+		writer.onError = [](const Exception& ex) {
+			FATAL_ERROR("FileWriter, ", ex);
+		};
+		writer.open(name);
+		for (UInt8 i = 0; i < 100; ++i) {
+			shared<Buffer> pBuffer(SET);
+			String::Append(*pBuffer, UInt32(i), ' ');
+			writer.write(Packet(pBuffer));
+		}
+		io.join();
+		CHECK(writer->written() == 290 && !writer->queueing());
+		writer.close();
+	}
+	{
+		File file(name, File::MODE_READ);
+		char data[290];
+		CHECK(file.read(ex, data, sizeof(data)) == 290 && !ex);
+		String::ForEach forEach([](UInt32 index, const char* value) {
+			UInt32 number;
+			CHECK(String::ToNumber(value, number) && number == index);
+			return true;
+		});
+		CHECK(String::Split(data, sizeof(data), " ", forEach, SPLIT_IGNORE_EMPTY) == 100);
+	}
+	CHECK(FileSystem::Delete(ex, name) && !ex);
+	Net::SetIOUring(false);
+}
+
+
+static void Write(const string& file, const char* value) {
+	Exception ex;
+	CHECK(File(file, File::MODE_WRITE).write(ex, value, strlen(value)) && !ex);
+}
+
+ADD_TEST(FileWatcher) {
+	struct Update : virtual Object {
+		Update() : count(0), firstWatch(false), exists(false) {}
+		UInt32	count;
+		bool	firstWatch;
+		bool	exists;
+	};
+	map<string, Update> updates;
+	FileWatcher::OnUpdate onUpdate([&updates](const Path& file, bool firstWatch) {
+		Update& update = updates[file.name()];
+		++update.count;
+		update.firstWatch = firstWatch;
+		update.exists = file.exists(true);
+	});
+	Exception ex;
+	string dir("FileWatcherTest/");
+	FileSystem::Delete(ex, dir, FileSystem::MODE_HEAVY);
+	CHECK(FileSystem::CreateDirectory(ex, dir) && !ex);
+	Write(dir + "a.txt", "a");
+	{
+		IOFile io(_Handler, _ThreadPool);
+		shared<FileWatcher> pWatcher(SET, Path(dir, "*.txt"));
+		io.watch(pWatcher, onUpdate);
+		CHECK(_Handler.join([&updates]() { return updates["a.txt"].count == 1; }));
+		CHECK(updates["a.txt"].firstWatch && updates["a.txt"].exists);
+
+		// creation, file not matching is ignored
+		Write(dir + "b.log", "b");
+		Write(dir + "b.txt", "b");
+		CHECK(_Handler.join([&updates]() { return updates["b.txt"].count == 1; }));
+		CHECK(!updates["b.txt"].firstWatch && updates["b.txt"].exists);
+
+		// modification (change of second required if changes are polled)
+		Thread::Sleep(1000);
+		Write(dir + "a.txt", "aa");
+		CHECK(_Handler.join([&updates]() { return updates["a.txt"].count == 2; }));
+		CHECK(!updates["a.txt"].firstWatch && updates["a.txt"].exists);
+
+		// deletion
+		CHECK(FileSystem::Delete(ex, dir + "b.txt") && !ex);
+		CHECK(_Handler.join([&updates]() { return updates["b.txt"].count == 2; }));
+		CHECK(!updates["b.txt"].exists);
+
+		CHECK(!_Handler.join([&updates]() { return updates.size() > 2; }, 500) && updates.size() == 2);
+		CHECK(updates["a.txt"].count == 2 && updates["b.txt"].count == 2);
+	}
+	_Handler.Handler::flush(); // updates queued before IOFile deletion reference this test
+	CHECK(FileSystem::Delete(ex, dir, FileSystem::MODE_HEAVY) && !ex);
+}
+
+ADD_TEST(FileWatcherBenchmark) {
+	// 10k files watched by one watcher of the folder and one watcher by file
+	const UInt32 count(10000);
+	Exception ex;
+	string dir("FileWatcherBenchmark/");
+	FileSystem::Delete(ex, dir, FileSystem::MODE_HEAVY);
+	CHECK(FileSystem::CreateDirectory(ex, dir) && !ex);
+	for (UInt32 i = 0; i < count; ++i)
+		Write(String(dir, i, ".txt"), "0");
+
+	// cost of a polling round (done every second without notification)
+	{
+		FileWatcher::OnUpdate onUpdate([](const Path& file, bool firstWatch) {});
+		vector<unique<FileWatcher>> watchers;
+		watchers.emplace_back(SET, Path(dir, "*"));
+		for (UInt32 i = 0; i < count; ++i)
+			watchers.emplace_back(SET, Path(dir, i, ".txt"));
+		for (unique<FileWatcher>& pWatcher : watchers)
+			pWatcher->watch(ex, onUpdate);
+		Stopwatch chrono;
+		chrono.start();
+		for (unique<FileWatcher>& pWatcher : watchers)
+			CHECK(pWatcher->watch(ex, onUpdate) > 0 && !ex);
+		chrono.stop();
+		NOTE("Polling of ", count, " files by ", watchers.size(), " watchers: ", chrono.elapsed(), "ms by round");
+	}
+
+	UInt32 updates(0);
+	FileWatcher::OnUpdate onUpdate([&updates](const Path& file, bool firstWatch) { ++updates; });
+	{
+		IOFile io(_Handler, _ThreadPool);
+		vector<shared<FileWatcher>> watchers;
+		watchers.emplace_back(SET, Path(dir, "*"));
+		for (UInt32 i = 0; i < count; ++i)
+			watchers.emplace_back(SET, Path(dir, i, ".txt"));
+		for (shared<FileWatcher>& pWatcher : watchers)
+			io.watch(pWatcher, onUpdate);
+		CHECK(_Handler.join([&updates, count]() { return updates == 2 * count; }, 30000));
+
+		// idle CPU (process time), after the second watch done on new folders observed
+		_Handler.join([]() { return false; }, 1000);
+		clock_t cpu = clock();
+		_Handler.join([]() { return false; }, 2000);
+		cpu = clock() - cpu;
+
+		// latency of a change notification
+		Stopwatch chrono;
+		chrono.start();
+		Write(String(dir, count / 2, ".txt"), "1");
+		CHECK(_Handler.join([&updates, count]() { return updates == 2 * count + 2; }));
+		chrono.stop();
+		NOTE("Watching of ", count, " files by ", watchers.size(), " watchers: ", chrono.elapsed(), "ms of update latency, ", cpu * 1000 / CLOCKS_PER_SEC / 2, "ms of CPU by idle second");
+		watchers.clear();
+	}
+	_Handler.Handler::flush(); // updates queued before IOFile deletion reference this test
+	CHECK(FileSystem::Delete(ex, dir, FileSystem::MODE_HEAVY) && !ex);
+}
+
 }
@@ -0,0 +1,249 @@
+/*
+This file is a part of MonaSolutions Copyright 2017
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License received along this program for more
+details (or else see http://www.gnu.org/licenses/).
+
+*/
+
+#include "Mona/UnitTest.h"
+#include "Mona/Handler.h"
+#include "Mona/ThreadPool.h"
+#include "Mona/Stopwatch.h"
+#include <deque>
+
+using namespace Mona;
+using namespace std;
+
+namespace HandlerTest {
+
+ADD_TEST(MPSCQueue) {
+	// every producer values have to be received in order
+	MPSCQueue<UInt32> queue;
+	UInt32 value;
+	CHECK(queue.empty() && !queue.pop(value));
+	queue.push(1);
+	queue.push(2);
+	CHECK(!queue.empty() && queue.pop(value) && value == 1 && queue.pop(value) && value == 2 && !queue.pop(value) && queue.empty());
+
+	const UInt32 producers(8), count(100000);
+	vector<thread> threads;
+	for (UInt32 i = 0; i < producers; ++i) {
+		threads.emplace_back([&queue, i, count]() {
+			for (UInt32 j = 0; j < count; ++j)
+				queue.push((i << 24) | j);
+		});
+	}
+	vector<UInt32> nexts(producers, 0);
+	UInt32 received(0);
+	while (received < producers * count) {
+		received += queue.flush([&nexts](UInt32 value) {
+			CHECK((value & 0xFFFFFF) == nexts[value >> 24]++);
+		});
+	}
+	for (thread& thread : threads)
+		thread.join();
+	CHECK(queue.empty());
+	for (UInt32 next : nexts)
+		CHECK(next == count);
+
+	// values queued are released on deletion
+	shared<UInt32> pValue(SET, 0);
+	{
+		MPSCQueue<shared<UInt32>> queue;
+		queue.push(pValue);
+		queue.push(pValue);
+		CHECK(pValue.use_count() == 3);
+	}
+	CHECK(pValue.unique());
+}
+
+ADD_TEST(Handler) {
+	struct Runner : Mona::Runner, virtual Object {
+		Runner(atomic<UInt32>& count) : Mona::Runner("Runner"), _count(count) {}
+		bool run(Exception& ex) { ++_count; return true; }
+	private:
+		atomic<UInt32>& _count;
+	};
+	Signal signal;
+	Handler handler(signal);
+	atomic<UInt32> count(0);
+	CHECK(!handler.flush() && !signal.wait(1));
+	handler.queue<Runner>(count);
+	handler.queue<Runner>(count);
+	CHECK(signal.wait() && handler.flush() == 2 && count == 2);
+	// signaled again after flush
+	handler.queue<Runner>(count);
+	CHECK(signal.wait() && handler.flush() == 1 && count == 3);
+
+	// ThreadQueue
+	ThreadQueue threadQueue;
+	for (UInt32 i = 0; i < 1000; ++i)
+		threadQueue.queue(make_shared<Runner>(count));
+	threadQueue.stop();
+	CHECK(count == 1003 && !threadQueue.running());
+	threadQueue.queue(make_shared<Runner>(count)); // restart
+	threadQueue.stop();
+	CHECK(count == 1004);
+	// runners queued while the thread stops and restarts are never lost
+	atomic<bool> producing(true);
+	thread producer([&threadQueue, &count, &producing]() {
+		for (UInt32 i = 0; i < 20000; ++i)
+			threadQueue.queue(make_shared<Runner>(count));
+		producing = false;
+	});
+	while (producing)
+		threadQueue.stop();
+	producer.join();
+	threadQueue.stop();
+	CHECK(count == 21004 && !threadQueue.pending());
+}
+
+ADD_TEST(ThreadPool) {
+	struct Runner : Mona::Runner, virtual Object {
+		Runner(const function<void()>& run) : Mona::Runner("Runner"), _run(run) {}
+		bool run(Exception& ex) { _run(); return true; }
+	private:
+		function<void()> _run;
+	};
+	ThreadPool threadPool(4);
+
+	// runners of a same track never run in parallel and keep their order, even if track moves
+	{
+		struct Sequence : virtual Object {
+			Sequence() : next(0), running(false) {}
+			ThreadPool::Track	track;
+			UInt32				next;
+			atomic<bool>		running;
+		};
+		vector<Sequence> sequences(64);
+		atomic<UInt32> errors(0), done(0);
+		for (UInt32 i = 0; i < 200; ++i) {
+			for (Sequence& sequence : sequences) {
+				threadPool.queue<Runner>(sequence.track, [&sequence, &errors, &done, i]() {
+					if (sequence.running.exchange(true))
+						++errors;
+					if (sequence.next++ != i)
+						++errors;
+					sequence.running = false;
+					++done;
+				});
+			}
+		}
+		while (done < 200 * sequences.size())
+			Thread::Sleep(1);
+		CHECK(!errors);
+		for (Sequence& sequence : sequences)
+			CHECK(sequence.next == 200 && !sequence.track.pending() && sequence.track.thread());
+
+		// concurrent producers on a new track, runners never run in parallel
+		Sequence sequence;
+		vector<thread> producers;
+		done = 0;
+		for (UInt32 i = 0; i < 4; ++i) {
+			producers.emplace_back([&]() {
+				for (UInt32 j = 0; j < 1000; ++j) {
+					threadPool.queue<Runner>(sequence.track, [&sequence, &errors, &done]() {
+						if (sequence.running.exchange(true))
+							++errors;
+						sequence.running = false;
+						++done;
+					});
+				}
+			});
+		}
+		for (thread& producer : producers)
+			producer.join();
+		while (done < 4000)
+			Thread::Sleep(1);
+		CHECK(!errors && !sequence.track.pending());
+	}
+
+	// a busy thread doesn't delay runners without order neither tracks without pending runner
+	atomic<bool> block(true);
+	atomic<ThreadQueue*> pThread(NULL);
+	ThreadPool::Track busy, track;
+	threadPool.queue<Runner>(track, [&pThread]() { pThread = ThreadQueue::Current(); });
+	while (track.pending())
+		Thread::Sleep(1);
+	UInt16 thread = track.thread();
+	CHECK(thread && pThread);
+	do { // block the thread of track
+		busy.reset();
+		threadPool.queue<Runner>(busy, [&block, &pThread]() {
+			while (block && ThreadQueue::Current() == pThread)
+				Thread::Sleep(1);
+		});
+	} while (busy.thread() != thread);
+	atomic<UInt32> done(0);
+	threadPool.queue<Runner>(track, [&done]() { ++done; });
+	CHECK(track.thread() != thread);
+	for (UInt32 i = 0; i < 100; ++i)
+		threadPool.queue<Runner>(nullptr, [&done]() { ++done; });
+	Stopwatch chrono;
+	chrono.start();
+	while (done < 101 && chrono.elapsed() < 5000)
+		Thread::Sleep(1);
+	CHECK(done == 101);
+	block = false;
+	threadPool.join();
+}
+
+template<typename Push, typename Flush>
+static void Bench(const char* name, UInt32 producers, const Push& push, const Flush& flush) {
+	const UInt32 total(1000000);
+	Stopwatch chrono;
+	chrono.start();
+	vector<thread> threads;
+	for (UInt32 i = 0; i < producers; ++i) {
+		threads.emplace_back([&push, producers, total]() {
+			for (UInt32 j = total / producers; j > 0; --j)
+				push(j);
+		});
+	}
+	UInt32 received(0);
+	while (received < (total / producers) * producers)
+		received += flush();
+	chrono.stop();
+	for (thread& thread : threads)
+		thread.join();
+	NOTE(name, " ", producers, " producers, ", received, " values in ", chrono.elapsed(), "ms (", UInt64(received) * 1000 / (chrono.elapsed() + 1), " values/s)");
+}
+
+ADD_TEST(MPSCQueueBenchmark) {
+	for (UInt32 producers = 8; producers <= 32; producers *= 2) {
+		// lock-free queue
+		MPSCQueue<shared<UInt32>> queue;
+		Bench("MPSCQueue", producers, [&queue](UInt32 value) {
+			queue.push(make_shared<UInt32>(value));
+		}, [&queue]() {
+			return queue.flush([](shared<UInt32>& pValue) { pValue.reset(); });
+		});
+		// mutex + deque (previous Handler implementation)
+		mutex mutex;
+		deque<shared<UInt32>> values;
+		Bench("mutex+deque", producers, [&mutex, &values](UInt32 value) {
+			lock_guard<std::mutex> lock(mutex);
+			values.emplace_back(make_shared<UInt32>(value));
+		}, [&mutex, &values]() {
+			deque<shared<UInt32>> flushing;
+			{
+				lock_guard<std::mutex> lock(mutex);
+				flushing = move(values);
+			}
+			return UInt32(flushing.size());
+		});
+	}
+}
+
+}
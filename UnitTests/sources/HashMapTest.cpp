@@ -0,0 +1,90 @@
+/*
+This file is a part of MonaSolutions Copyright 2017
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License received along this program for more
+details (or else see http://www.gnu.org/licenses/).
+
+*/
+
+#include "Mona/UnitTest.h"
+#include "Mona/HashMap.h"
+#include "Mona/SocketAddress.h"
+#include "Mona/Stopwatch.h"
+
+using namespace std;
+using namespace Mona;
+
+namespace HashMapTest {
+
+static SocketAddress Address(UInt32 i) {
+	Exception ex;
+	SocketAddress address;
+	CHECK(address.set(ex, String("10.", UInt8(i >> 16), '.', UInt8(i >> 8), '.', UInt8(i)), UInt16(1024 + i % 60000)) && !ex);
+	return address;
+}
+
+ADD_TEST(HashMap) {
+	HashMap<SocketAddress, UInt32> map;
+	CHECK(map.empty() && !map.find(Address(0)) && !map.erase(Address(0)));
+	CHECK(map.emplace(Address(0), 0).second && !map.emplace(Address(0), 1).second && *map.find(Address(0)) == 0);
+	CHECK(!map.find(SocketAddress(Address(0).host(), 1)));
+
+	// grow and erase with backward shift keep every entry reachable
+	for (UInt32 i = 1; i < 5000; ++i)
+		CHECK(map.emplace(Address(i), i).second);
+	CHECK(map.size() == 5000);
+	for (UInt32 i = 0; i < 5000; i += 2)
+		CHECK(map.erase(Address(i)));
+	CHECK(map.size() == 2500);
+	for (UInt32 i = 0; i < 5000; ++i) {
+		const UInt32* pValue = map.find(Address(i));
+		CHECK((i & 1) ? (pValue && *pValue == i) : !pValue);
+	}
+	CHECK(map.eraseIf([](const SocketAddress& address, UInt32 value) { return value % 3 == 0; }) == 833);
+	for (UInt32 i = 1; i < 5000; i += 2)
+		CHECK((map.find(Address(i)) != NULL) == (i % 3 != 0));
+	map.clear();
+	CHECK(map.empty() && !map.find(Address(1)));
+}
+
+ADD_TEST(Benchmark) {
+	// 100k sessions: find by address (every UDP packet received)
+	const UInt32 count(100000), loops(10);
+	vector<SocketAddress> addresses;
+	HashMap<SocketAddress, UInt32> hashMap;
+	map<SocketAddress, UInt32> sortedMap; // previous Sessions implementation
+	for (UInt32 i = 0; i < count; ++i) {
+		addresses.emplace_back(Address(i * 7919)); // spread on all bytes
+		hashMap.emplace(addresses.back(), i);
+		sortedMap.emplace(addresses.back(), i);
+	}
+	UInt32 found(0);
+	Stopwatch chrono;
+	chrono.start();
+	for (UInt32 i = 0; i < loops; ++i) {
+		for (const SocketAddress& address : addresses)
+			found += hashMap.find(address) ? 1 : 0;
+	}
+	chrono.stop();
+	Int64 hashTime(chrono.elapsed());
+	chrono.restart();
+	for (UInt32 i = 0; i < loops; ++i) {
+		for (const SocketAddress& address : addresses)
+			found += sortedMap.find(address) != sortedMap.end() ? 1 : 0;
+	}
+	chrono.stop();
+	CHECK(found == 2 * loops * count);
+	NOTE(count, " sessions, ", count * loops, " finds by address: HashMap ", hashTime, "ms, map ", chrono.elapsed(), "ms");
+}
+
+}
@@ -0,0 +1,196 @@
+/*
+This file is a part of MonaSolutions Copyright 2017
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License received along this program for more
+details (or else see http://www.gnu.org/licenses/).
+
+*/
+
+#include "Mona/UnitTest.h"
+#include "Mona/FileLogger.h"
+#include "Mona/Stopwatch.h"
+
+using namespace std;
+using namespace Mona;
+
+namespace LogsTest {
+
+/*!
+Replace the file logger of UnitTests by the logger tested (and restore it on destruction),
+to not flood UnitTests logs and to get NOTE results once restored */
+struct Loggers : virtual Object {
+	template <typename LoggerType, typename ...Args>
+	Loggers(LoggerType*, Args&&... args) {
+		Logs::RemoveLogger("file");
+		Logs::AddLogger<LoggerType>("test", std::forward<Args>(args)...);
+	}
+	~Loggers() {
+		Logs::SetAsynchronous(1024, true); // Application default
+		Logs::RemoveLogger("test");
+		Logs::AddLogger<FileLogger>("file", String(Path::CurrentApp().baseName(), ".log/"));
+	}
+};
+
+struct Result : virtual Object {
+	Result() : count(0), flushes(0), errors(0), time(0), open(true) {}
+	UInt32				count;
+	UInt32				flushes;
+	UInt32				errors;
+	map<UInt32, UInt32>	nexts; // next value expected by thread
+	string				last;
+	Int64				time;
+	atomic<bool>		open; // to block logger thread
+	atomic<bool>		blocked;
+};
+
+struct Logger : Mona::Logger, virtual Object {
+	Logger(Result& result) : _result(result) {}
+
+	bool log(LOG_LEVEL level, const Path& file, long line, const string& message) {
+		while (!_result.open) {
+			_result.blocked = true;
+			Thread::Sleep(1);
+		}
+		++_result.count;
+		_result.last = message;
+		_result.time = Logs::LoggingTime();
+		UInt32 value;
+		if (String::ToNumber(message, value) && _result.nexts[Logs::LoggingThreadId()]++ != value)
+			++_result.errors;
+		return true;
+	}
+	bool dump(const string& header, const UInt8* data, UInt32 size) { return true; }
+	bool flush() { ++_result.flushes; return true; }
+private:
+	Result& _result;
+};
+
+ADD_TEST(Asynchronous) {
+	Result result;
+	Loggers loggers((Logger*)NULL, result);
+
+	// synchronous
+	Logs::SetAsynchronous(0);
+	CHECK(!Logs::IsAsynchronous());
+	Int64 time = Time::Now();
+	UInt32 flushes = result.flushes;
+	INFO("0");
+	CHECK(result.count == 1 && result.flushes == (flushes + 1) && result.nexts[Thread::CurrentId()] == 1);
+	CHECK(result.time >= time && result.time <= Time::Now());
+
+	// asynchronous, lossless with block, order and thread id of callers are kept
+	Logs::SetAsynchronous(10, true);
+	CHECK(Logs::IsAsynchronous());
+	UInt64 dropped = Logs::Dropped();
+	const UInt32 producers(8), count(10000);
+	vector<thread> threads;
+	for (UInt32 i = 0; i < producers; ++i) {
+		threads.emplace_back([count]() {
+			for (UInt32 j = 0; j < count; ++j)
+				INFO(j);
+		});
+	}
+	for (thread& thread : threads)
+		thread.join();
+	Logs::Flush();
+	CHECK(result.count == (1 + producers * count) && !result.errors && result.nexts.size() == (1 + producers));
+	for (auto& it : result.nexts)
+		CHECK(it.second == (it.first == Thread::CurrentId() ? 1 : count));
+	CHECK(Logs::Dropped() == dropped && result.flushes < (flushes + producers * count));
+
+	// CRITIC is synchronous and written after pending logs
+	INFO("1");
+	CRITIC("critic");
+	CHECK(result.count == (3 + producers * count) && result.nexts[Thread::CurrentId()] == 2 && result.last == "critic");
+	string critic;
+	CHECK(Logs::LastCritic(critic) && critic == "critic");
+
+	// drop on overflow: logger thread is blocked on the first log, ring keeps 15 others
+	Logs::SetAsynchronous(16);
+	result.open = false;
+	result.blocked = false;
+	INFO("log");
+	while (!result.blocked)
+		Thread::Sleep(1);
+	for (UInt32 i = 0; i < 25; ++i)
+		INFO("log");
+	CHECK(Logs::Dropped() == (dropped + 10));
+	result.open = true;
+	Logs::Flush();
+	CHECK(result.count == (3 + producers * count + 16));
+
+	// reconfiguration while logging with block, logs pushed on a closing ring are not lost and keep their order
+	Logs::SetAsynchronous(10, true);
+	UInt32 logged = result.count;
+	result.nexts.clear();
+	threads.clear();
+	atomic<UInt32> running(producers);
+	for (UInt32 i = 0; i < producers; ++i) {
+		threads.emplace_back([count, &running]() {
+			for (UInt32 j = 0; j < count; ++j)
+				INFO(j);
+			--running;
+		});
+	}
+	while (running)
+		Logs::SetAsynchronous(10, true);
+	for (thread& thread : threads)
+		thread.join();
+	Logs::Flush();
+	CHECK(result.count == (logged + producers * count) && !result.errors && result.nexts.size() == producers);
+	for (auto& it : result.nexts)
+		CHECK(it.second == count);
+}
+
+ADD_TEST(Benchmark) {
+	// log calls per second under contention, with a file logger (caller time and time to get everything written)
+	const char* dir("LogsTest.log/");
+	const UInt32 total(200000);
+	vector<string> results;
+	{
+		Loggers loggers((FileLogger*)NULL, dir, 0);
+		for (UInt32 producers = 1; producers <= 16; producers *= 4) {
+			for (UInt32 mode = 0; mode < 3; ++mode) { // synchronous, asynchronous with block, asynchronous with drop
+				Logs::SetAsynchronous(mode ? 1024 : 0, mode == 1);
+				UInt64 dropped = Logs::Dropped();
+				atomic<Int64> calls(0);
+				Stopwatch chrono;
+				chrono.start();
+				vector<thread> threads;
+				for (UInt32 i = 0; i < producers; ++i) {
+					threads.emplace_back([&calls, producers, total]() {
+						Stopwatch chrono;
+						chrono.start();
+						for (UInt32 j = total / producers; j > 0; --j)
+							INFO("Log message number ", j, " of a benchmark thread");
+						chrono.stop();
+						calls += chrono.elapsed();
+					});
+				}
+				for (thread& thread : threads)
+					thread.join();
+				Int64 elapsed = calls / producers;
+				Logs::Flush();
+				chrono.stop();
+				static const char* Modes[] = { "synchronous", "asynchronous+block", "asynchronous+drop" };
+				results.emplace_back(String(Modes[mode], " logs, ", producers, " threads: ", UInt64(total) * 1000 / (elapsed + 1), " calls/s (", elapsed, "ms by thread, ", chrono.elapsed(), "ms to write everything, ", Logs::Dropped() - dropped, " dropped)"));
+			}
+		}
+	}
+	Exception ex;
+	FileSystem::Delete(ex, dir, FileSystem::MODE_HEAVY);
+	for (const string& result : results)
+		NOTE(result);
+}
+
+}
@@ -18,6 +18,7 @@ details (or else see http://www.gnu.org/licenses/).
 
 #include "Mona/UnitTest.h"
 #include "Mona/Parameters.h"
+#include "Mona/Stopwatch.h"
 
 using namespace std;
 using namespace Mona;
@@ -85,4 +86,112 @@ ADD_TEST(MapParameters) {
 	CHECK(params.count() == 0);
 }
 
+ADD_TEST(Index) {
+	Parameters params;
+	// case insensitive direct accesses
+	params.setString("Content-Type", "text/html");
+	CHECK(params.getString("content-type", _Value) && _Value == "text/html");
+	CHECK(params.getString("CONTENT-TYPE", _Value) && _Value == "text/html");
+	params.setString("CONTENT-type", "text/plain");
+	CHECK(params.count() == 1 && params.begin()->first == "Content-Type" && params.begin()->second == "text/plain");
+	CHECK(!params.getString("content", _Value) && !params.getString("content-type-", _Value));
+
+	// growing index, keys stay ordered
+	for (UInt32 i = 0; i < 1000; ++i)
+		params.setNumber(String("key", String::Format<UInt32>("%04u", i)), i);
+	CHECK(params.count() == 1001);
+	for (UInt32 i = 0; i < 1000; ++i)
+		CHECK(params.getNumber<UInt32>(String("KEY", String::Format<UInt32>("%04u", i))) == i);
+	string previous;
+	for (const auto& it : params) {
+		CHECK(String::ICompare(previous, it.first) < 0);
+		previous = it.first;
+	}
+	UInt32 count(0);
+	for (const auto& it : params.range("key01")) {
+		CHECK(it.first.compare(0, 5, "key01") == 0);
+		++count;
+	}
+	CHECK(count == 100);
+
+	// erase keeps other keys reachable
+	for (UInt32 i = 0; i < 1000; i += 3)
+		CHECK(params.erase(String("Key", String::Format<UInt32>("%04u", i))));
+	CHECK(params.count() == 667);
+	for (UInt32 i = 0; i < 1000; ++i)
+		CHECK(params.getString(String("key", String::Format<UInt32>("%04u", i)), _Value) == ((i % 3) != 0));
+	params.clear("key01");
+	CHECK(params.count() == 600 && !params.getString("key0101", _Value) && params.getString("key0200", _Value));
+	for (UInt32 i = 0; i < 1000; i += 3)
+		params.setNumber(String("key", String::Format<UInt32>("%04u", i)), i);
+	CHECK(params.count() == 934 && params.getNumber<UInt32>("key0999") == 999);
+
+	// copy rebuilds index
+	struct Copy : Parameters {
+		Copy(const Parameters& other) : Parameters(other) {}
+	} copy(params);
+	params.clear();
+	CHECK(copy.count() == 934 && copy.getString("content-type", _Value) && _Value == "text/plain" && copy.getNumber<UInt32>("KEY0003") == 3);
+	CHECK(copy.erase("key0003") && !copy.getString("key0003", _Value) && copy.getNumber<UInt32>("key0004") == 4);
+
+	// few keys (not indexed) copy
+	params.setString("Host", "localhost");
+	params.setString("Accept", "*/*");
+	Copy small(params);
+	params.clear();
+	CHECK(small.count() == 2 && small.getString("HOST", _Value) && _Value == "localhost" && small.erase("accept") && small.count() == 1);
+}
+
+template<typename MapType, typename GetType>
+static string Bench(MapType& map, const vector<string>& keys, const vector<string>& lookups, UInt32 loops, const GetType& get) {
+	// fill time, then lookup time
+	Stopwatch chrono;
+	chrono.start();
+	for (UInt32 i = 0; i < loops; ++i) {
+		map.clear();
+		for (const string& key : keys)
+			map.setString(key, EXPAND("value"));
+	}
+	chrono.stop();
+	string result(String(chrono.elapsed(), "ms + "));
+	UInt32 found(0);
+	chrono.restart();
+	for (UInt32 i = 0; i < loops; ++i) {
+		for (const string& key : lookups)
+			found += get(key);
+	}
+	chrono.stop();
+	CHECK(found == loops * lookups.size() / 2);
+	return String::Append(result, chrono.elapsed(), "ms");
+}
+
+ADD_TEST(Benchmark) {
+	// HTTP header (few keys rebuilt by request, looked up with an other case) and configuration (lot of keys set once)
+	static const char* Fields[] = { "Host", "User-Agent", "Accept", "Accept-Language", "Accept-Encoding", "Connection", "Upgrade-Insecure-Requests",
+		"Cache-Control", "Pragma", "Cookie", "Referer", "Origin", "Content-Type", "Content-Length", "Sec-WebSocket-Key" };
+	vector<string> headerKeys, headerLookups, iniKeys, iniLookups; // lookups half found
+	for (const char* field : Fields) {
+		headerKeys.emplace_back(field);
+		headerLookups.emplace_back(field);
+		String::ToLower(headerLookups.back());
+		headerLookups.emplace_back(String(field, "-Unknown"));
+	}
+	for (UInt32 i = 0; i < 200; ++i) {
+		iniKeys.emplace_back(String("section", i / 20, ".property", i % 20));
+		iniLookups.emplace_back(String("SECTION", i / 20, ".Property", i % 20));
+		iniLookups.emplace_back(String("section", i / 20, ".unknown", i % 20));
+	}
+
+	// ordered map only, without Parameters events (the index is built just beyond Parameters::Map::INDEX_MIN keys)
+	struct Map : map<string, string, String::IComparator> {
+		void setString(const string& key, const char* value, size_t size) { (*this)[key].assign(value, size); }
+	} map;
+	auto getMap = [&map](const string& key) { return map.find(key) != map.end(); };
+	Parameters params;
+	auto getParams = [&params](const string& key) { return params.getString(key, (const char*)NULL) != NULL; };
+
+	NOTE("header, 100000 x (15 fields + 30 lookups): map ", Bench(map, headerKeys, headerLookups, 100000, getMap), ", parameters ", Bench(params, headerKeys, headerLookups, 100000, getParams));
+	NOTE("ini, 1000 x (200 properties + 400 lookups): map ", Bench(map, iniKeys, iniLookups, 1000, getMap), ", parameters ", Bench(params, iniKeys, iniLookups, 1000, getParams));
+}
+
 }
@@ -19,6 +19,10 @@ details (or else see http://www.gnu.org/licenses/).
 #include "Mona/UnitTest.h"
 #include "Mona/PersistentData.h"
 #include "Mona/FileSystem.h"
+#include "Mona/Stopwatch.h"
+#if defined(__linux__)
+	#include <unistd.h>
+#endif
 
 using namespace std;
 using namespace Mona;
@@ -80,4 +84,129 @@ ADD_TEST(Remove) {
 	CHECK(!FileSystem::Exists(_Path));;
 }
 
+static map<string, string>& Load(Exception& ex, PersistentData& data, const string& path, map<string, string>& values) {
+	values.clear();
+	data.load(ex, path, [&values](const string& path, const Packet& packet) {
+		values[path].assign(STR packet.data(), packet.size());
+	});
+	return values;
+}
+
+ADD_TEST(Log) {
+	Exception ex;
+	map<string, string> values;
+	string logPath(_Path);
+	FileSystem::MakeFile(logPath).append(".log");
+	FileSystem::Delete(ex, logPath);
+
+	// migration of a folders storage
+	{
+		PersistentData folders;
+		folders.load(ex, _Path, _ForEach);
+		folders.add("", Packet(EXPAND("salut")));
+		folders.add("Test", Packet(EXPAND("aur\0voir")));
+		folders.add("/Test/../Sub", Packet(EXPAND("val")));
+		folders.flush();
+	}
+	CHECK(FileSystem::Exists(_Path + "Sub/"));
+	PersistentData data("PersistentData", PersistentData::FORMAT_LOG);
+	CHECK(Load(ex, data, _Path, values).size() == 3 && !ex);
+	for (auto& it : values)
+		_ForEach(it.first, Packet(it.second.data(), it.second.size()));
+	CHECK(!FileSystem::Exists(_Path) && FileSystem::Exists(logPath));
+
+	// add and remove, with same path formalization than folders format
+	data.add("Other/", Packet(EXPAND("other")));
+	data.add("Test", Packet(EXPAND("aurevoir")));
+	data.remove("/Sub");
+	data.remove("/Test/NoExists");
+	data.flush();
+	CHECK(Load(ex, data, _Path, values).size() == 3 && !ex);
+	CHECK(values[""] == "salut" && values["/Test"] == "aurevoir" && values["/Other"] == "other");
+
+	// corrupted tail (crash during a writing) is ignored and removed by a log rewriting
+	UInt64 size = FileSystem::GetSize(ex, logPath);
+	{
+		File file(logPath, File::MODE_APPEND);
+		CHECK(file.write(ex, EXPAND("\x20\0\0\0garbage")) && !ex);
+	}
+	CHECK(Load(ex, data, _Path, values).size() == 3 && ex && FileSystem::GetSize(ex, logPath) <= size);
+	ex = nullptr;
+
+#if defined(__linux__)
+	// reading error aborts loading without rewriting the log (a sysfs file gives less bytes than its size)
+	string moved(logPath + ".moved");
+	char target[64];
+	CHECK(FileSystem::Rename(logPath, moved) && symlink("/sys/devices/system/cpu/online", logPath.c_str()) == 0);
+	CHECK(Load(ex, data, _Path, values).empty() && ex && readlink(logPath.c_str(), target, sizeof(target)) > 0);
+	ex = nullptr;
+	CHECK(unlink(logPath.c_str()) == 0 && FileSystem::Rename(moved, logPath));
+	CHECK(Load(ex, data, _Path, values).size() == 3 && !ex);
+#endif
+
+	// clear
+	data.clear();
+	data.add("", Packet(EXPAND("salut")));
+	data.flush();
+	CHECK(Load(ex, data, _Path, values).size() == 1 && !ex && values[""] == "salut");
+
+	// compaction when obsolete data exceeds alive data
+	string value(0x10000, 'v');
+	for (UInt8 i = 0; i < 40; ++i) {
+		value[0] = i;
+		data.add("Big", Packet(value.data(), value.size()));
+		if(i%4==0)
+			data.flush(); // several batches
+	}
+	data.flush();
+	CHECK(FileSystem::GetSize(ex, logPath) < 0x100000 && !ex);
+	CHECK(Load(ex, data, _Path, values).size() == 2 && !ex && values["/Big"] == value);
+
+	data.clear();
+	data.flush();
+	CHECK(Load(ex, data, _Path, values).empty() && !ex);
+	CHECK(FileSystem::Delete(ex, logPath) && !ex);
+}
+
+ADD_TEST(LogBenchmark) {
+	// startup time, log format with 1M keys against folders format (a folder and a file by key)
+	Exception ex;
+	string path(FileSystem::MakeFolder(_Path + "Bench"));
+	string logPath(path);
+	FileSystem::MakeFile(logPath).append(".log");
+	UInt32 count(0);
+	PersistentData::ForEach forEach([&count](const string& path, const Packet& packet) { ++count; });
+	string value(32, 'v');
+	Stopwatch chrono;
+
+	PersistentData data("PersistentData", PersistentData::FORMAT_LOG);
+	data.load(ex, path, forEach);
+	chrono.start();
+	for (UInt32 i = 0; i < 1000000; ++i)
+		data.add(String("user/", i), Packet(value.data(), value.size()));
+	data.flush();
+	chrono.stop();
+	Int64 writing = chrono.elapsed();
+	chrono.restart();
+	data.load(ex, path, forEach);
+	chrono.stop();
+	CHECK(count == 1000000 && !ex);
+	NOTE("Log format, 1000000 keys (", FileSystem::GetSize(ex, logPath) / 1024, "KB): written in ", writing, "ms, loaded in ", chrono.elapsed(), "ms");
+	CHECK(FileSystem::Delete(ex, logPath) && !ex);
+
+	PersistentData folders;
+	count = 0;
+	folders.load(ex, path, forEach);
+	for (UInt32 i = 0; i < 5000; ++i)
+		folders.add(String("user/", i), Packet(value.data(), value.size()));
+	folders.flush();
+	count = 0;
+	chrono.restart();
+	folders.load(ex, path, forEach);
+	chrono.stop();
+	CHECK(count == 5000 && !ex);
+	NOTE("Folders format, 5000 keys: loaded in ", chrono.elapsed(), "ms (", chrono.elapsed() * 200, "ms estimated for 1000000 keys)");
+	CHECK(FileSystem::Delete(ex, _Path, FileSystem::MODE_HEAVY) && !ex);
+}
+
 }
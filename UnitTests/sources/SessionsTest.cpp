@@ -0,0 +1,115 @@
+/*
+This file is a part of MonaSolutions Copyright 2017
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License received along this program for more
+details (or else see http://www.gnu.org/licenses/).
+
+*/
+
+#include "Mona/UnitTest.h"
+#include "Mona/ServerAPI.h"
+#include "Mona/Protocols.h"
+#include "Mona/Session.h"
+
+using namespace std;
+using namespace Mona;
+
+namespace SessionsTest {
+
+struct API : ServerAPI {
+	API(const Handler& handler, const Timer& timer) : ServerAPI(_www, _publications, handler, _protocols, timer), _protocols(self) {}
+	bool running() { return true; }
+private:
+	string							_www;
+	map<string, Publication>		_publications;
+	Protocols						_protocols;
+};
+
+struct TestProtocol : Protocol {
+	TestProtocol(ServerAPI& api, Sessions& sessions) : Protocol("TEST", api, sessions) {}
+};
+
+struct Record {
+	Record() : deleted(false), flushes(0) {}
+	vector<Int64>	manages;
+	bool			deleted;
+	UInt32			flushes;
+};
+
+struct TestSession : Session {
+	TestSession(Protocol& protocol, const SocketAddress& address, Record& record) : Session(protocol, address), _record(record) {}
+	~TestSession() { _record.deleted = true; }
+
+	bool manage() { _record.manages.emplace_back(Time::Now()); return Session::manage(); }
+	void flush() { ++_record.flushes; }
+private:
+	Record& _record;
+};
+
+ADD_TEST(Manage) {
+	// sessions created by Sessions are managed by their own timer once by interval, a died session is removed on its next manage
+	// (TestProtocol is not an UDProtocol, sessions are indexed by TCP address)
+	Signal		signal;
+	Handler		handler(signal);
+	Timer		timer;
+	API			api(handler, timer);
+	Sessions	sessions(timer);
+	TestProtocol protocol(api, sessions);
+
+	const UInt32 count(20);
+	vector<Record> records(count);
+	vector<UInt32> ids;
+	Int64 start(Time::Now());
+	for (UInt32 i = 0; i < count; ++i)
+		ids.emplace_back(sessions.create<TestSession>(protocol, SocketAddress(IPAddress::Loopback(), 1000 + i), records[i]).id());
+	CHECK(sessions.find(ids[0]) && sessions.find(ids[count - 1]) && sessions.findByAddress(SocketAddress(IPAddress::Loopback(), 1000), Socket::TYPE_STREAM));
+
+	// run 2 intervals and a half, kill the first session in the middle of the first interval
+	Int64 killTime(0);
+	Int64 end(start + Sessions::MANAGE_INTERVAL * 5 / 2);
+	while (Time::Now() < end) {
+		if (!killTime && Time::Now() >= (start + Sessions::MANAGE_INTERVAL / 2)) {
+			TestSession* pSession = sessions.find<TestSession>(ids[0]);
+			CHECK(pSession);
+			pSession->kill();
+			killTime = Time::Now();
+		}
+		UInt32 timeout = timer.raise();
+		Thread::Sleep(timeout ? min<UInt32>(timeout, 10) : 10);
+	}
+
+	// died session: not managed after its death, removed on its next manage
+	Record& killed(records[0]);
+	CHECK(killed.deleted && !sessions.find(ids[0]) && !sessions.findByAddress(SocketAddress(IPAddress::Loopback(), 1000), Socket::TYPE_STREAM));
+	for (Int64 time : killed.manages)
+		CHECK(time < killTime);
+
+	// alive sessions: first manage spread in the first interval, and then one manage by interval
+	for (UInt32 i = 1; i < count; ++i) {
+		const Record& record(records[i]);
+		CHECK(!record.deleted && sessions.find(ids[i]));
+		CHECK(record.manages.size() == 2 || record.manages.size() == 3);
+		CHECK(record.flushes == record.manages.size());
+		Int64 previous(start);
+		for (Int64 time : record.manages) {
+			if (previous == start) {
+				CHECK((time - start) <= (Sessions::MANAGE_INTERVAL + 100));
+			} else {
+				CHECK((time - previous) >= (Sessions::MANAGE_INTERVAL - 1) && (time - previous) <= (Sessions::MANAGE_INTERVAL + 100));
+			}
+			previous = time;
+		}
+	}
+}
+
+}
@@ -0,0 +1,118 @@
+/*
+This file is a part of MonaSolutions Copyright 2017
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License received along this program for more
+details (or else see http://www.gnu.org/licenses/).
+
+*/
+
+#include "Mona/UnitTest.h"
+#include "Mona/SlotMap.h"
+#include "Mona/Stopwatch.h"
+#include <deque>
+
+using namespace std;
+using namespace Mona;
+
+namespace SlotMapTest {
+
+ADD_TEST(SlotMap) {
+	SlotMap<string> map;
+	CHECK(map.empty() && !map.find(0) && !map.find(1));
+	UInt32 a = map.emplace("a");
+	UInt32 b = map.emplace(EXPAND("b"));
+	UInt32 c = map.emplace("c");
+	CHECK(a == 1 && b == 2 && c == 3 && map.size() == 3);
+	CHECK(*map.find(a) == "a" && *map.find(b) == "b" && *map.find(c) == "c" && !map.find(4) && !map.find(0x01000001));
+
+	// erase moves last value, a stale id doesn't find the value which reuses its slot
+	CHECK(map.erase(a) && !map.erase(a) && !map.find(a) && map.size() == 2);
+	CHECK(map.begin()->first == c && map.begin()->second == "c" && *map.find(b) == "b");
+	UInt32 d = map.emplace("d");
+	CHECK(d != a && (d & SlotMap<string>::MAX_SIZE) == a && !map.find(a) && *map.find(d) == "d");
+
+	// freed slots are reused in their release order
+	CHECK(map.erase(c) && map.erase(b));
+	CHECK((map.emplace("e") & SlotMap<string>::MAX_SIZE) == 3 && (map.emplace("f") & SlotMap<string>::MAX_SIZE) == 2 && map.emplace("g") == 4);
+
+	// iteration gives every (id, value)
+	UInt32 count(0);
+	for (auto& it : map) {
+		CHECK(map.find(it.first) == &it.second);
+		++count;
+	}
+	CHECK(count == map.size() && count == 4);
+
+	// generation wraps
+	UInt32 id(d);
+	for (UInt32 i = 0; i < 256; ++i) {
+		CHECK(map.erase(id));
+		UInt32 next = map.emplace("x"); // unique free slot
+		CHECK(next != id && (next & SlotMap<string>::MAX_SIZE) == (d & SlotMap<string>::MAX_SIZE) && !map.find(id));
+		id = next;
+	}
+	CHECK(id == d);
+	map.clear();
+	CHECK(map.empty() && !map.find(id) && map.emplace("a") == 1);
+}
+
+ADD_TEST(Benchmark) {
+	// 100k sessions: find by id, and erase + insert with id reuse
+	const UInt32 count(100000), loops(10);
+	SlotMap<UInt32*> slots;
+	map<UInt32, UInt32*> ids;
+	deque<UInt32> freeIds;
+	vector<UInt32> keys;
+	for (UInt32 i = 0; i < count; ++i) {
+		keys.emplace_back(slots.emplace(nullptr));
+		ids.emplace(keys.back(), nullptr);
+	}
+	UInt32 found(0);
+	Stopwatch chrono;
+	chrono.start();
+	for (UInt32 i = 0; i < loops; ++i) {
+		for (UInt32 key : keys)
+			found += slots.find(key) ? 1 : 0;
+	}
+	chrono.stop();
+	Int64 slotsFind(chrono.elapsed());
+	chrono.restart();
+	for (UInt32 i = 0; i < loops; ++i) {
+		for (UInt32 key : keys)
+			found += ids.find(key) != ids.end() ? 1 : 0;
+	}
+	chrono.stop();
+	Int64 mapFind(chrono.elapsed());
+	CHECK(found == 2 * loops * count);
+
+	chrono.restart();
+	for (UInt32& key : keys) {
+		CHECK(slots.erase(key));
+		key = slots.emplace(nullptr);
+	}
+	chrono.stop();
+	Int64 slotsReplace(chrono.elapsed());
+	chrono.restart();
+	for (UInt32& key : keys) {
+		// previous Sessions implementation
+		ids.erase(key);
+		freeIds.emplace_back(key);
+		key = freeIds.front();
+		freeIds.pop_front();
+		CHECK(ids.emplace(key, nullptr).second);
+	}
+	chrono.stop();
+	NOTE(count, " sessions, ", count * loops, " finds by id: SlotMap ", slotsFind, "ms, map ", mapFind, "ms; ", count, " erases + inserts: SlotMap ", slotsReplace, "ms, map+deque ", chrono.elapsed(), "ms");
+}
+
+}
@@ -22,6 +22,8 @@ details (or else see http://www.gnu.org/licenses/).
 #include "Mona/UDPSocket.h"
 #include "Mona/TLS.h"
 #include "Mona/Util.h"
+#include "Mona/File.h"
+#include "Mona/Stopwatch.h"
 #include <set>
 
 using namespace std;
@@ -513,4 +515,538 @@ ADD_TEST(TCP_SSL_NonBlocking) {
 	TestTCPNonBlocking(pClientTLS, pServerTLS);
 }
 
+static UInt32 TestUDPLoad(UInt16 reactors, const char* engine = "epoll") {
+	// Stress IOSocket, decoders count datagrams in reception threads, one sender thread by reactor
+	struct Counter : Socket::Decoder {
+		Counter(atomic<UInt32>& count) : _count(count) {}
+	private:
+		void decode(shared<Buffer>& pBuffer, const SocketAddress& address, const shared<Socket>& pSocket) {
+			++_count;
+			pBuffer.reset(); // captured, no onReceived
+		}
+		atomic<UInt32>& _count;
+	};
+
+	Exception ex;
+	MainHandler	handler;
+	UInt32 rate(0);
+	{
+		IOSocket io(handler, _ThreadPool, reactors);
+		CHECK(io.reactors() == reactors);
+
+		atomic<UInt32> count(0);
+		vector<shared<Socket>> sockets(256);
+		vector<SocketAddress> addresses;
+		for (shared<Socket>& pSocket : sockets) {
+			pSocket.set(Socket::TYPE_DATAGRAM);
+			CHECK(pSocket->bind(ex, IPAddress::Loopback()) && !ex);
+			addresses.emplace_back(IPAddress::Loopback(), pSocket->address().port());
+			CHECK(io.subscribe(ex, pSocket, new Counter(count), nullptr, nullptr, nullptr) && !ex);
+		}
+		CHECK(io.subscribers() == sockets.size());
+
+		Stopwatch chrono;
+		chrono.start();
+		atomic<UInt32> expected(0);
+		vector<thread> senders;
+		for (UInt16 i = 0; i < reactors; ++i) {
+			senders.emplace_back([&addresses, &expected, i, reactors]() {
+				Exception ex;
+				Socket sender(Socket::TYPE_DATAGRAM);
+				UInt32 sent(0);
+				for (UInt8 j = 0; j < 64; ++j) {
+					for (size_t k = i; k < addresses.size(); k += reactors) {
+						if (sender.sendTo(ex, _Short0Data.data(), 64, addresses[k]) == 64)
+							++sent;
+					}
+				}
+				expected += sent;
+			});
+		}
+		for (thread& sender : senders)
+			sender.join();
+		while (count < expected && chrono.elapsed() < 5000)
+			Thread::Sleep(1);
+		chrono.stop();
+		CHECK(count);
+		rate = UInt32(count * 1000ull / (chrono.elapsed() + 1));
+		NOTE(engine, " ", reactors, " reactor(s), ", count, "/", expected, " events in ", chrono.elapsed(), "ms (", rate, " events/s)");
+
+		for (shared<Socket>& pSocket : sockets)
+			io.unsubscribe(pSocket);
+		_ThreadPool.join();
+		handler.flush();
+		CHECK(!io.subscribers());
+	}
+	return rate;
+}
+
+ADD_TEST(TestUDPReactors) {
+	// Stress IOSocket with an increasing number of reactor threads,
+	// more reactors have to be faster than one when there are cores enough to run reactors and senders in parallel
+	UInt16 maxReactors(UInt16(max(Thread::ProcessorCount() / 2, 2u)));
+	UInt32 single(TestUDPLoad(1));
+	for (UInt16 reactors = 2; reactors <= maxReactors; reactors *= 2) {
+		UInt32 rate(TestUDPLoad(reactors));
+		if (Thread::ProcessorCount() >= 2u * reactors)
+			CHECK(rate > single)
+		else
+			NOTE(Thread::ProcessorCount(), " core(s), ", reactors, " reactors can't be compared to one (", rate, " vs ", single, " events/s)");
+	}
+}
+
+ADD_TEST(UDP_BatchReceive) {
+	Exception ex;
+	Socket server(Socket::TYPE_DATAGRAM);
+	CHECK(server.bind(ex, IPAddress::Loopback()) && !ex);
+	SocketAddress address(IPAddress::Loopback(), server.address().port());
+
+	Socket client(Socket::TYPE_DATAGRAM);
+	CHECK(client.connect(ex, address) && !ex);
+	CHECK(client.send(ex, EXPAND("hi mathieu and thomas")) == 21 && !ex);
+	CHECK(client.send(ex, _Short0Data.data(), _Short0Data.size()) == int(_Short0Data.size()) && !ex);
+	CHECK(client.send(ex, _Long0Data.data(), 4000) == 4000 && !ex);
+	Thread::Sleep(10); // to get all the datagrams in one batch
+
+	shared<Buffer>	pBuffers[Socket::RECV_BATCH_MAX];
+	SocketAddress	addresses[Socket::RECV_BATCH_MAX];
+	// third datagram is greater than the first one and than the minimum batch buffer size, it must not be lost
+	CHECK(server.receive(ex, pBuffers, addresses, Socket::RECV_BATCH_MAX) == 3 && !ex);
+	CHECK(pBuffers[0]->size() == 21 && memcmp(pBuffers[0]->data(), EXPAND("hi mathieu and thomas")) == 0 && addresses[0] == client.address());
+	CHECK(pBuffers[1]->size() == _Short0Data.size() && memcmp(pBuffers[1]->data(), _Short0Data.data(), _Short0Data.size()) == 0 && addresses[1] == client.address());
+	CHECK(pBuffers[2]->size() == 4000 && memcmp(pBuffers[2]->data(), _Long0Data.data(), 4000) == 0 && addresses[2] == client.address());
+
+	// maximum datagram size after a small one
+	string big(65507, 'b');
+	CHECK(client.send(ex, EXPAND("small")) == 5 && client.send(ex, big.data(), big.size()) == int(big.size()) && !ex);
+	Thread::Sleep(10);
+	CHECK(server.receive(ex, pBuffers, addresses, Socket::RECV_BATCH_MAX) == 2 && !ex);
+	CHECK(pBuffers[0]->size() == 5 && pBuffers[1]->size() == big.size() && memcmp(pBuffers[1]->data(), big.data(), big.size()) == 0);
+
+	// buffers are sized on the first datagram
+	CHECK(client.send(ex, _Long0Data.data(), 4000) == 4000 && !ex);
+	CHECK(server.receive(ex, pBuffers, addresses, Socket::RECV_BATCH_MAX) == 1 && !ex && pBuffers[0]->size() == 4000 && addresses[0] == client.address());
+}
+
+ADD_TEST(UDP_BatchBudget) {
+	// a batch which exceeds the reception budget is delivered in several times, without loss and in order
+	Exception ex;
+	MainHandler	handler;
+	IOSocket	io(handler, _ThreadPool);
+
+	shared<Socket> pServer(SET, Socket::TYPE_DATAGRAM);
+	CHECK(pServer->bind(ex, IPAddress::Loopback()) && !ex);
+	Socket client(Socket::TYPE_DATAGRAM);
+	CHECK(client.connect(ex, SocketAddress(IPAddress::Loopback(), pServer->address().port())) && !ex);
+	for (UInt8 i = 0; i < 10; ++i) {
+		string data(500, char(i));
+		CHECK(client.send(ex, data.data(), data.size()) == 500 && !ex);
+	}
+	Thread::Sleep(10); // to get all the datagrams in one batch
+	CHECK(pServer->setRecvBufferSize(ex, 1024) && !ex); // third datagram exceeds the budget, 7 others wait the rearmed reception
+
+	UInt8 received(0);
+	Socket::OnReceived onReceived([&](shared<Buffer>& pBuffer, const SocketAddress& address) {
+		CHECK(pBuffer->size() == 500 && pBuffer->data()[0] == received++);
+	});
+	CHECK(io.subscribe(ex, pServer, onReceived, nullptr, nullptr) && !ex);
+	CHECK(handler.join([&]() { return received == 10; }));
+
+	io.unsubscribe(pServer);
+	_ThreadPool.join();
+	handler.flush();
+}
+
+ADD_TEST(UDP_Pacing) {
+	// 50 datagrams of 1000 bytes written at once with a bucket of 10000 bytes refilled at 100000 bytes/s:
+	// the 10 first ones are sent immediatly and the 40 others are released by the pacer ticks,
+	// every tick can't release more than the bucket has got since the start (+ one datagram, always sent whole)
+	for (UInt16 reactors = 1; reactors <= 2; ++reactors) {
+		Exception ex;
+		MainHandler	handler;
+		IOSocket	io(handler, _ThreadPool, reactors); // with 2 reactors client and server are managed by distinct reactors
+		UInt32		received(0);
+		Stopwatch	chrono;
+
+		UDPSocket server(io);
+		server.onError = [](const Exception& ex) { FATAL_ERROR("UDP_Pacing server, ", ex); };
+		server.onPacket = [&](shared<Buffer>& pBuffer, const SocketAddress& address) {
+			CHECK(pBuffer->size() == 1000 && pBuffer->data()[0] == UInt8(received++ % 50)); // order kept
+			if (chrono) {
+				CHECK((received * 1000) <= (10000 + (chrono.elapsed() + 1) * 100 + 1000));
+			}
+		};
+		CHECK(server.bind(ex, IPAddress::Loopback()) && !ex);
+
+		UDPSocket client(io);
+		client.onError = [](const Exception& ex) { FATAL_ERROR("UDP_Pacing client, ", ex); };
+		CHECK(client.connect(ex, SocketAddress(IPAddress::Loopback(), server->address().port())) && !ex);
+		CHECK(client->setPacing(ex, 100000, 10000) && client->pacingRate() == 100000 && client->pacingBurst() == 10000);
+		ex = nullptr; // SO_MAX_PACING_RATE can be unsupported (warning)
+
+		chrono.start();
+		for (UInt8 i = 0; i < 50; ++i) {
+			shared<Buffer> pBuffer(SET, 1000);
+			memset(pBuffer->data(), i, pBuffer->size());
+			CHECK(client.send(ex, Packet(pBuffer)) && !ex);
+		}
+		CHECK(client->queueing() >= 30000);
+		CHECK(handler.join([&]() { return received == 50 && !client->queueing(); }));
+		chrono.stop();
+
+		// pacing disabled
+		CHECK(client->setPacing(ex, 0) && !client->pacingRate());
+		ex = nullptr;
+		for (UInt8 i = 0; i < 50; ++i) {
+			shared<Buffer> pBuffer(SET, 1000);
+			memset(pBuffer->data(), i, pBuffer->size());
+			CHECK(client.send(ex, Packet(pBuffer)) && !ex);
+		}
+		CHECK(!client->queueing());
+		CHECK(handler.join([&]() { return received == 100; }));
+
+		client.close();
+		server.close();
+		_ThreadPool.join();
+		handler.flush();
+	}
+}
+
+ADD_TEST(UDP_BatchSend) {
+	// datagrams held by pacing are flushed by sendmmsg, in groups of same size with UDP GSO when supported,
+	// then one by one when GSO is refused (SO_NO_CHECK forbids it), each one must arrive intact and in order
+	Exception ex;
+	MainHandler	handler;
+	IOSocket	io(handler, _ThreadPool);
+
+	Socket server(Socket::TYPE_DATAGRAM);
+	CHECK(server.bind(ex, IPAddress::Loopback()) && server.setNonBlockingMode(ex, true) && !ex);
+	UDPSocket client(io);
+	client.onError = [](const Exception& ex) { FATAL_ERROR("UDP_BatchSend client, ", ex); };
+	CHECK(client.connect(ex, SocketAddress(IPAddress::Loopback(), server.address().port())) && !ex);
+
+	shared<Buffer>	pBuffers[Socket::RECV_BATCH_MAX];
+	SocketAddress	addresses[Socket::RECV_BATCH_MAX];
+	for (int noCheck = 0; noCheck <= 1; ++noCheck) {
+#if defined(SO_NO_CHECK)
+		CHECK(::setsockopt(*client, SOL_SOCKET, SO_NO_CHECK, (const char*)&noCheck, sizeof(noCheck)) == 0);
+#endif
+		// a burst of 1 byte and a rate of 1 byte/s: the first datagram is sent and the others are queued
+		CHECK(client->setPacing(ex, 1, 1));
+		ex = nullptr; // SO_MAX_PACING_RATE can be unsupported (warning)
+		UInt32 size(0), sizes[40];
+		for (UInt8 i = 0; i < 40; ++i) {
+			sizes[i] = i < 16 ? 1000 : (i == 16 ? 300 : (i < 30 ? 1400 : 100 + i)); // groups of same size, shorter last ones, then distinct sizes
+			shared<Buffer> pBuffer(SET, sizes[i]);
+			memset(pBuffer->data(), i, pBuffer->size());
+			CHECK(client->write(ex, Packet(pBuffer)) >= 0 && !ex);
+			size += sizes[i];
+		}
+		CHECK(client->queueing() == (size - sizes[0]));
+
+		UInt64 saved(client->sendSyscallsSaved());
+		CHECK(client->setPacing(ex, 0));
+		ex = nullptr;
+		CHECK(client->flush(ex) && !ex && !client->queueing());
+#if defined(__linux__)
+		CHECK(client->sendSyscallsSaved() > saved);
+#endif
+		UInt8 received(0);
+		while (received < 40) {
+			int count = server.receive(ex, pBuffers, addresses, Socket::RECV_BATCH_MAX);
+			CHECK(count > 0 && !ex); // everything is already in the receiving buffer (loopback)
+			for (int i = 0; i < count; ++i, ++received) {
+				CHECK(pBuffers[i]->size() == sizes[received] && addresses[i] == client->address());
+				CHECK(pBuffers[i]->data()[0] == received && pBuffers[i]->data()[pBuffers[i]->size() - 1] == received);
+			}
+		}
+	}
+
+	client.close();
+	_ThreadPool.join();
+	handler.flush();
+}
+
+ADD_TEST(TCP_GatherFlush) {
+	Exception ex;
+	Socket server(Socket::TYPE_STREAM);
+	CHECK(server.bind(ex, IPAddress::Loopback()) && server.listen(ex) && !ex);
+
+	Socket client(Socket::TYPE_STREAM);
+	CHECK(client.setNonBlockingMode(ex, true) && !ex);
+	CHECK(client.connect(ex, SocketAddress(IPAddress::Loopback(), server.address().port())));
+	ex = nullptr;
+	shared<Socket> pConnection;
+	CHECK(server.accept(ex, pConnection) && !ex && pConnection);
+
+	// write small packets until to fill the socket buffer, then queue some more
+	Buffer data(0x4000000); // enough to exceed any loopback buffer
+	for (UInt32 i = 0; i < data.size(); ++i)
+		data.data()[i] = UInt8(i % 251);
+	UInt32 size(0);
+	while (client.queueing() < 0x100000 && (size + 1000) <= data.size()) {
+		CHECK(client.write(ex, Packet(data.data() + size, 1000)) >= 0 && !ex);
+		size += 1000;
+	}
+	CHECK(client.queueing());
+
+	// flush in scatter-gather mode, what is received must be identical
+	UInt32 received(0);
+	Buffer buffer(0x10000);
+	while (received < size) {
+		CHECK(client.flush(ex) && !ex);
+		int count = pConnection->receive(ex, buffer.data(), buffer.size());
+		CHECK(count > 0 && !ex && memcmp(buffer.data(), data.data() + received, count) == 0);
+		received += count;
+	}
+	CHECK(received == size && !client.queueing());
+#if !defined(_WIN32)
+	CHECK(client.sendSyscallsSaved() > 0);
+#endif
+}
+
+ADD_TEST(TCP_WriteFile) {
+	Exception ex;
+	const char* name("temp.mona");
+	string data(0x200000, '\0');
+	for (UInt32 i = 0; i < data.size(); ++i)
+		data[i] = char(i % 253);
+	CHECK(File(name, File::MODE_WRITE).write(ex, data.data(), data.size()) && !ex);
+
+	Socket server(Socket::TYPE_STREAM);
+	CHECK(server.bind(ex, IPAddress::Loopback()) && server.listen(ex) && !ex);
+	Socket client(Socket::TYPE_STREAM);
+	CHECK(client.setNonBlockingMode(ex, true) && !ex);
+	CHECK(client.connect(ex, SocketAddress(IPAddress::Loopback(), server.address().port())));
+	ex = nullptr;
+	shared<Socket> pConnection;
+	CHECK(server.accept(ex, pConnection) && !ex && pConnection);
+
+	File file(name, File::MODE_READ);
+	// queueing data are sent before
+	CHECK(client.write(ex, Packet(EXPAND("header"))) == 6 && !ex && !client.queueing());
+
+	UInt32 received(0);
+	Buffer buffer(0x10000);
+	int sent;
+	while (received < data.size() + 6) {
+		do {
+			sent = client.writeFile(ex, file, 0x10000);
+		} while (sent > 0);
+#if defined(__linux__)
+		CHECK(!sent && !ex);
+#else
+		CHECK(sent < 0 && ex.cast<Ex::Unsupported>());
+		break;
+#endif
+		int count = pConnection->receive(ex, buffer.data(), buffer.size());
+		CHECK(count > 0 && !ex);
+		if (!received) {
+			CHECK(count >= 6 && memcmp(buffer.data(), EXPAND("header")) == 0);
+			CHECK(memcmp(buffer.data() + 6, data.data(), count - 6) == 0);
+		} else
+			CHECK(memcmp(buffer.data(), data.data() + received - 6, count) == 0);
+		received += count;
+	}
+	CHECK(file.readen() == data.size());
+
+	Socket datagram(Socket::TYPE_DATAGRAM);
+	CHECK(datagram.writeFile(ex, file, 10) < 0 && ex.cast<Ex::Unsupported>());
+	CHECK(FileSystem::Delete(ex = nullptr, name) && !ex);
+}
+
+ADD_TEST(TCP_SSL_kTLS) {
+	Exception ex;
+	shared<TLS> pClientTLS, pServerTLS;
+	CHECK(TLS::Create(ex, pClientTLS) && TLS::Create(ex, "cert.pem", "key.pem", pServerTLS) && !ex);
+#if defined(MONA_KTLS)
+	CHECK(pServerTLS->setKTLS(ex, true) && !ex && pServerTLS->kTLS());
+#else
+	CHECK(!pServerTLS->setKTLS(ex, true) && ex.cast<Ex::Unsupported>() && !pServerTLS->kTLS());
+	ex = nullptr;
+#endif
+	const char* name("temp.mona");
+	string data(0x100000, '\0');
+	for (UInt32 i = 0; i < data.size(); ++i)
+		data[i] = char(i % 251);
+	CHECK(File(name, File::MODE_WRITE).write(ex, data.data(), data.size()) && !ex);
+
+	TLS::Socket server(Socket::TYPE_STREAM, pServerTLS);
+	CHECK(server.bind(ex, IPAddress::Loopback()) && server.listen(ex) && !ex);
+	TLS::Socket client(Socket::TYPE_STREAM, pClientTLS);
+	CHECK(client.setNonBlockingMode(ex, true) && !ex);
+	CHECK(client.connect(ex, SocketAddress(IPAddress::Loopback(), server.address().port())) && !ex);
+	shared<Socket> pConnection;
+	CHECK(server.accept(ex, pConnection) && !ex && pConnection);
+	CHECK(pConnection->setNonBlockingMode(ex, true) && !ex);
+	TLS::Socket& connection((TLS::Socket&)*pConnection);
+
+	// handshake
+	CHECK(client.write(ex, Packet(EXPAND("hello"))) >= 0 && !ex);
+	Buffer buffer(0x10000);
+	int count;
+	while ((count = connection.receive(ex, buffer.data(), buffer.size())) < 0) {
+		CHECK(ex.cast<Ex::Net::Socket>().code == NET_EWOULDBLOCK);
+		CHECK(client.flush(ex = nullptr) && !ex);
+	}
+	CHECK(count == 5 && memcmp(buffer.data(), EXPAND("hello")) == 0);
+	CHECK(!client.isKTLS());
+
+	File file(name, File::MODE_READ);
+	UInt32 received(0);
+	int sent = 0;
+	if (connection.isKTLS()) {
+		NOTE("kTLS enabled");
+		while (received < data.size()) {
+			do {
+				sent = connection.writeFile(ex, file, 0x10000);
+			} while (sent > 0);
+			CHECK(!sent && !ex);
+			while ((count = client.receive(ex, buffer.data(), buffer.size())) > 0) {
+				CHECK(memcmp(buffer.data(), data.data() + received, count) == 0);
+				received += count;
+			}
+			CHECK(ex.cast<Ex::Net::Socket>().code == NET_EWOULDBLOCK);
+			ex = nullptr;
+		}
+		CHECK(file.readen() == data.size());
+	} else {
+		// kernel refuses kTLS => user space encryption continues
+		NOTE("kTLS unavailable");
+		CHECK(connection.writeFile(ex, file, 0x10000) < 0 && ex.cast<Ex::Unsupported>() && !file.readen());
+		CHECK(connection.write(ex = nullptr, Packet(EXPAND("world"))) == 5 && !ex);
+		while ((count = client.receive(ex, buffer.data(), buffer.size())) < 0) {
+			CHECK(ex.cast<Ex::Net::Socket>().code == NET_EWOULDBLOCK);
+			ex = nullptr;
+		}
+		CHECK(count == 5 && memcmp(buffer.data(), EXPAND("world")) == 0);
+	}
+	CHECK(FileSystem::Delete(ex = nullptr, name) && !ex);
+}
+
+static void Handshake(TLS::Socket& server, const shared<TLS>& pClientTLS, const char* serverName = NULL) {
+	Exception ex;
+	TLS::Socket client(Socket::TYPE_STREAM, pClientTLS);
+	if (serverName)
+		client.setServerName(serverName);
+	CHECK(client.setNonBlockingMode(ex, true) && !ex);
+	CHECK(client.connect(ex, SocketAddress(IPAddress::Loopback(), server.address().port())) && !ex);
+	shared<Socket> pConnection;
+	CHECK(server.accept(ex, pConnection) && !ex && pConnection);
+	CHECK(pConnection->setNonBlockingMode(ex, true) && !ex);
+	TLS::Socket& connection((TLS::Socket&)*pConnection);
+
+	CHECK(client.write(ex, Packet(EXPAND("hello"))) >= 0 && !ex);
+	UInt8 buffer[64];
+	int count;
+	while ((count = connection.receive(ex, buffer, sizeof(buffer))) < 0) {
+		CHECK(ex.cast<Ex::Net::Socket>().code == NET_EWOULDBLOCK);
+		CHECK(client.flush(ex = nullptr) && !ex);
+	}
+	CHECK(count == 5);
+	// answer, client gets TLS 1.3 session tickets before it
+	CHECK(connection.write(ex, Packet(EXPAND("world"))) == 5 && !ex);
+	while ((count = client.receive(ex, buffer, sizeof(buffer))) < 0) {
+		CHECK(ex.cast<Ex::Net::Socket>().code == NET_EWOULDBLOCK);
+		ex = nullptr;
+	}
+	CHECK(count == 5);
+}
+
+ADD_TEST(TCP_SSL_Resumption) {
+	Exception ex;
+	shared<TLS> pClientTLS, pServerTLS;
+	CHECK(TLS::Create(ex, pClientTLS) && TLS::Create(ex, "cert.pem", "key.pem", pServerTLS) && !ex);
+	CHECK(pServerTLS->setSessionCache(ex, 1024) && pServerTLS->setTicketKeysRotation(ex, 1) && !ex);
+	CHECK(!pClientTLS->setTicketKeysRotation(ex, 1) && ex.cast<Ex::Unsupported>());
+	CHECK(pClientTLS->setSessionCache(ex = nullptr, 16) && !ex);
+
+	TLS::Socket server(Socket::TYPE_STREAM, pServerTLS);
+	CHECK(server.bind(ex, IPAddress::Loopback()) && server.listen(ex) && !ex);
+
+	// session tickets
+	Handshake(server, pClientTLS);
+	CHECK(pServerTLS->misses() == 1 && !pServerTLS->hits() && pClientTLS->misses() == 1 && !pClientTLS->hits());
+	Handshake(server, pClientTLS);
+	CHECK(pServerTLS->misses() == 1 && pServerTLS->hits() == 1 && pClientTLS->hits() == 1);
+	Handshake(server, pClientTLS);
+	CHECK(pServerTLS->misses() == 1 && pServerTLS->hits() == 2);
+	// ticket keys are expired after two rotations
+	Thread::Sleep(2100);
+	Handshake(server, pClientTLS);
+	CHECK(pServerTLS->misses() == 2 && pServerTLS->hits() == 2);
+	Handshake(server, pClientTLS);
+	CHECK(pServerTLS->misses() == 2 && pServerTLS->hits() == 3);
+
+	// session cache without ticket
+	CHECK(pServerTLS->setTicketKeysRotation(ex, 0) && !ex);
+	Handshake(server, pClientTLS);
+	CHECK(pServerTLS->misses() == 3 && pServerTLS->hits() == 3);
+	Handshake(server, pClientTLS);
+	CHECK(pServerTLS->misses() == 3 && pServerTLS->hits() == 4);
+	Handshake(server, pClientTLS);
+	CHECK(pServerTLS->misses() == 3 && pServerTLS->hits() == 5);
+
+	// client sessions are kept by server name (SNI) too
+	Handshake(server, pClientTLS, "a.mona");
+	CHECK(pServerTLS->misses() == 4 && pServerTLS->hits() == 5);
+	Handshake(server, pClientTLS, "a.mona");
+	CHECK(pServerTLS->misses() == 4 && pServerTLS->hits() == 6);
+	Handshake(server, pClientTLS, "b.mona");
+	CHECK(pServerTLS->misses() == 5 && pServerTLS->hits() == 6);
+	Handshake(server, pClientTLS, "a.mona");
+	CHECK(pServerTLS->misses() == 5 && pServerTLS->hits() == 7);
+	Handshake(server, pClientTLS);
+	CHECK(pServerTLS->misses() == 5 && pServerTLS->hits() == 8);
+
+	// no resumption
+	CHECK(pClientTLS->setSessionCache(ex, 0) && !ex);
+	Handshake(server, pClientTLS);
+	CHECK(pServerTLS->misses() == 6 && pServerTLS->hits() == 8);
+}
+
+ADD_TEST(TCP_SSL_ResumptionBenchmark) {
+	Exception ex;
+	shared<TLS> pClientTLS, pServerTLS;
+	CHECK(TLS::Create(ex, pClientTLS) && TLS::Create(ex, "cert.pem", "key.pem", pServerTLS) && !ex);
+	CHECK(pServerTLS->setSessionCache(ex, 1024) && pServerTLS->setTicketKeysRotation(ex, 3600) && !ex);
+	TLS::Socket server(Socket::TYPE_STREAM, pServerTLS);
+	CHECK(server.bind(ex, IPAddress::Loopback()) && server.listen(ex) && !ex);
+
+	// client and server run in this thread, elapsed time is the CPU time of both sides
+	const UInt32 count(200);
+	Int64 elapsed[2];
+	for (UInt8 resumption = 0; resumption < 2; ++resumption) {
+		CHECK(pClientTLS->setSessionCache(ex, resumption ? 16 : 0) && !ex);
+		Handshake(server, pClientTLS); // get a session
+		Stopwatch chrono;
+		chrono.start();
+		for (UInt32 i = 0; i < count; ++i)
+			Handshake(server, pClientTLS);
+		chrono.stop();
+		elapsed[resumption] = chrono.elapsed();
+		NOTE(resumption ? "Resumed" : "Full", " TLS handshakes, ", count, " in ", elapsed[resumption], "ms (", elapsed[resumption] * 1000 / count, "us by handshake)");
+	}
+	CHECK(pServerTLS->hits() == count);
+	NOTE("Resumption saves ", 100 - (elapsed[1] * 100 / max(elapsed[0], Int64(1))), "% of handshake time");
+}
+
+ADD_TEST(TestIOUring) {
+	if (!IOUring::Supported()) {
+		NOTE("io_uring unsupported on this system");
+		return;
+	}
+	// Same load on epoll and io_uring engines
+	for (UInt16 reactors = 1; reactors <= 2; ++reactors) {
+		TestUDPLoad(reactors, "epoll");
+		Net::SetIOUring(true);
+		TestUDPLoad(reactors, "io_uring");
+		Net::SetIOUring(false);
+	}
+	// Echo and disconnection behaviors with io_uring engine
+	Net::SetIOUring(true);
+	TestTCPNonBlocking();
+	Net::SetIOUring(false);
+}
+
 }
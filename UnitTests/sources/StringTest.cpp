@@ -20,6 +20,8 @@ details (or else see http://www.gnu.org/licenses/).
 #include "Mona/String.h"
 #include "Mona/Exceptions.h"
 #include "Mona/Logs.h"
+#include "Mona/Util.h"
+#include "Mona/Stopwatch.h"
 #include "math.h"
 #include "float.h"
 
@@ -164,10 +166,10 @@ ADD_TEST(TestMultiple) {
 
 
     double big = 1234567890123456789.1234567890;
-    CHECK(String::Assign(_Str, big) == "1.234567890123457e+18");
+    CHECK(String::Assign(_Str, big) == "1.2345678901234568e+18"); // shortest round-trip
 	
     float bigf = 1234567890123456789.1234567890f;
-    CHECK(String::Assign(_Str, bigf) == "1.2345679e+18");
+    CHECK(String::Assign(_Str, bigf) == "1.234568e+18"); // shortest round-trip
 }
 
 ADD_TEST(ToNumber) {
@@ -207,7 +209,102 @@ ADD_TEST(ToNumber) {
     CHECK(!tryToNumber<double>("a12.3", 0));
     CHECK(!tryToNumber<double>("12.3aa", 0));
 
-	
+	// exponent, comma, limits
+	CHECK(tryToNumber<double>("1e+20", 1e20) && tryToNumber<double>(" -1.5E-3", -0.0015) && tryToNumber<double>("12,5", 12.5));
+	CHECK(!tryToNumber<double>("1e", 0) && !tryToNumber<double>("e5", 0) && !tryToNumber<double>("1e5.5", 0) && !tryToNumber<int>("1e5", 0));
+	CHECK(!tryToNumber<double>("-", 0) && !tryToNumber<double>(".5", 0) && !tryToNumber<double>("1e400", 0) && !tryToNumber<double>("nan", 0));
+	CHECK(tryToNumber<Int8>("-128", -128) && !tryToNumber<Int8>("128", 0) && tryToNumber<int>("12.9", 12));
+	CHECK(tryToNumber<Int64>("-9223372036854775808", numeric_limits<Int64>::min()) && tryToNumber<UInt64>("18446744073709551615", numeric_limits<UInt64>::max()));
+	CHECK(!tryToNumber<UInt64>("18446744073709551616", 0) && !tryToNumber<UInt32>("4294967296", 0));
+	UInt16 value;
+	CHECK(String::ToNumber("123", 2, value) && value == 12 && String::ToNumber("ff", value, BASE_16) && value == 255);
+}
+
+ADD_TEST(FromNumber) {
+	char buffer[32];
+	CHECK(string(buffer, String::FromNumber(0, false, buffer)) == "0");
+	CHECK(string(buffer, String::FromNumber(UInt64(numeric_limits<Int64>::min()), true, buffer)) == "-9223372036854775808");
+	CHECK(String::Assign(_Str, numeric_limits<UInt64>::max(), ' ', numeric_limits<Int8>::min(), ' ', Int16(-100)) == "18446744073709551615 -128 -100");
+	// same %g style than before, with shortest round-trip digits
+	CHECK(String::Assign(_Str, 0.1 + 0.2, ' ', 1e15, ' ', 1e16, ' ', 0.0001, ' ', 1e-5, ' ', -0.0, ' ', 1.5e-300) == "0.30000000000000004 1000000000000000 1e+16 0.0001 1e-05 -0 1.5e-300");
+	CHECK(String::Assign(_Str, numeric_limits<double>::infinity(), ' ', -numeric_limits<double>::infinity(), ' ', numeric_limits<double>::quiet_NaN()) == "inf -inf nan");
+	CHECK(String::Assign(_Str, 16777216.0f, ' ', 1e8f, ' ', 0.3f) == "16777216 1e+08 0.3");
+	for (UInt32 i = 0; i < 100000; ++i) {
+		double number;
+		UInt64 bits(Util::Random<UInt64>());
+		memcpy(&number, &bits, sizeof(number));
+		if (isnan(number) || isinf(number))
+			continue;
+		double result;
+		CHECK(String::ToNumber(string(buffer, String::FromNumber(number, buffer)), result) && result == number);
+		CHECK(String::ToNumber(String::Assign(_Str, i * 0.001), result) && result == i * 0.001);
+	}
+}
+
+ADD_TEST(NumberBenchmark) {
+	// types written by JSONWriter and Parameters, against snprintf/strtod
+	static const UInt32 Count(1000000);
+	vector<double> doubles(Count);
+	vector<UInt32> integers(Count);
+	for (UInt32 i = 0; i < Count; ++i) {
+		doubles[i] = Util::Random<UInt32>() / 1000.0;
+		integers[i] = Util::Random<UInt32>();
+	}
+	Stopwatch chrono;
+	char buffer[32];
+	UInt64 size(0);
+	vector<string> values;
+	values.reserve(Count);
+
+	chrono.restart();
+	for (UInt32 value : integers)
+		size += snprintf(buffer, sizeof(buffer), "%u", value);
+	Int64 snprintfInt(chrono.elapsed());
+	chrono.restart();
+	for (UInt32 value : integers)
+		size -= String::FromNumber(value, false, buffer);
+	Int64 fromInt(chrono.elapsed());
+	chrono.restart();
+	UInt64 doubleSizes[2] = { 0, 0 }; // just %.16g and shortest sizes
+	for (double value : doubles)
+		doubleSizes[0] += snprintf(buffer, sizeof(buffer), "%.16g", value);
+	Int64 snprintfDouble(chrono.elapsed());
+	chrono.restart();
+	for (double value : doubles)
+		doubleSizes[1] += String::FromNumber(value, buffer);
+	Int64 fromDouble(chrono.elapsed());
+	CHECK(!size && doubleSizes[1] <= doubleSizes[0]);
+	NOTE(Count, " formats, UInt32: snprintf ", snprintfInt, "ms, String::FromNumber ", fromInt, "ms; double: snprintf ", snprintfDouble, "ms, String::FromNumber ", fromDouble, "ms");
+
+	for (double value : doubles)
+		values.emplace_back(buffer, String::FromNumber(value, buffer));
+	double total(0), result;
+	chrono.restart();
+	for (const string& value : values)
+		total += strtod(value.c_str(), NULL);
+	Int64 strtodDouble(chrono.elapsed());
+	chrono.restart();
+	for (const string& value : values) {
+		if (String::ToNumber(value, result))
+			total -= result;
+	}
+	Int64 toDouble(chrono.elapsed());
+	values.clear();
+	for (UInt32 value : integers)
+		values.emplace_back(buffer, String::FromNumber(value, false, buffer));
+	chrono.restart();
+	for (const string& value : values)
+		size += strtoul(value.c_str(), NULL, 10);
+	Int64 strtoulInt(chrono.elapsed());
+	UInt32 integer;
+	chrono.restart();
+	for (const string& value : values) {
+		if (String::ToNumber(value, integer))
+			size -= integer;
+	}
+	Int64 toInt(chrono.elapsed());
+	CHECK(!size && fabs(total) < 1);
+	NOTE(Count, " parsings, UInt32: strtoul ", strtoulInt, "ms, String::ToNumber ", toInt, "ms; double: strtod ", strtodDouble, "ms, String::ToNumber ", toDouble, "ms");
 }
 
 ADD_TEST(TrimLeft) {
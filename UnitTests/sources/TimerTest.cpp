@@ -20,6 +20,10 @@ details (or else see http://www.gnu.org/licenses/).
 #include "Mona/Stopwatch.h"
 #include "Mona/Timer.h"
 #include "Mona/Thread.h"
+#include "Mona/Congestion.h"
+#include "Mona/Util.h"
+#include <vector>
+#include <algorithm>
 
 using namespace Mona;
 using namespace std;
@@ -71,4 +75,141 @@ ADD_TEST(All) {
 	CHECK(!timer.count() && !timer.raise())
 }
 
+ADD_TEST(Wheels) {
+	Timer timer;
+	// timers of several wheels, removed/rescheduled by an other timer callback
+	Timer::OnTimer onShort([](UInt32 delay) { return 0; });
+	Timer::OnTimer onLong([](UInt32 delay) { return 0; });
+	Timer::OnTimer onFar([](UInt32 delay) { return 0; });
+	Timer::OnTimer onRemover([&](UInt32 delay) {
+		timer.set(onFar, 0);
+		timer.set(onLong, 300); // reschedule from wheel 2 to wheel 1
+		return 0;
+	});
+	Int64 time = Time::Now(); // same clock as timer
+	timer.set(onShort, 50);
+	timer.set(onRemover, 100);
+	timer.set(onLong, 100000);
+	timer.set(onFar, 0xFFFFFFFF);
+	CHECK(timer.count() == 4 && (onFar.nextRaising() - onShort.nextRaising()) >= (0xFFFFFFFF - 50));
+
+	UInt32 timeout;
+	while ((timeout = timer.raise())) {
+		CHECK(timeout <= 300);
+		Thread::Sleep(timeout);
+	}
+	time = Time::Now() - time;
+	CHECK(time >= 400 && time < 500);
+	CHECK(onShort.count == 1 && onRemover.count == 1 && onLong.count == 1 && !onFar.count && !timer.count());
+
+	// timer out of its callback with a reschedule inside and a return value, the return value wins
+	Timer::OnTimer onTwice;
+	onTwice = [&](UInt32 delay) { timer.set(onTwice, 1000); return onTwice.count < 2 ? 10 : 0; };
+	timer.set(onTwice, 10);
+	while ((timeout = timer.raise()) && onTwice.count < 2)
+		Thread::Sleep(timeout);
+	CHECK(onTwice.count == 2 && timer.count() == 1 && (onTwice.nextRaising() - Time::Now()) > 500);
+	timer.set(onTwice, 0);
+	CHECK(!timer.count() && !onTwice);
+}
+
+ADD_TEST(Benchmark) {
+	// 100k active timers: insert, rearm (no allocation, O(1)) and raise
+	const UInt32 count(100000);
+	Timer timer;
+	vector<Timer::OnTimer> timers(count);
+	UInt32 raised(0);
+	for (Timer::OnTimer& onTimer : timers)
+		onTimer = [&raised](UInt32 delay) { ++raised; return 0; };
+
+	Stopwatch chrono;
+	chrono.start();
+	for (UInt32 i = 0; i < count; ++i)
+		timer.set(timers[i], 1000 + (i * 7919) % 3600000); // up to 1 hour
+	chrono.stop();
+	CHECK(timer.count() == count);
+	NOTE(count, " timers inserted in ", chrono.elapsed(), "ms (", chrono.elapsed() * 1000000 / count, "ns/timer)");
+
+	chrono.restart();
+	for (UInt32 loop = 0; loop < 10; ++loop) {
+		for (UInt32 i = 0; i < count; ++i)
+			timer.set(timers[i], 1000 + ((i + loop) * 104729) % 3600000);
+	}
+	chrono.stop();
+	CHECK(timer.count() == count);
+	NOTE(count * 10, " timers rearmed in ", chrono.elapsed(), "ms (", chrono.elapsed() * 100000 / count, "ns/rearm)");
+
+	chrono.restart();
+	for (UInt32 i = 0; i < count; ++i)
+		timer.set(timers[i], 1 + i % 50);
+	chrono.stop();
+	NOTE(count, " timers rearmed to expire in 50ms in ", chrono.elapsed(), "ms");
+
+	chrono.restart();
+	UInt32 timeout;
+	while ((timeout = timer.raise()))
+		Thread::Sleep(timeout);
+	chrono.stop();
+	CHECK(raised == count && !timer.count());
+	NOTE(count, " timers raised in ", chrono.elapsed(), "ms (including 50ms of waiting)");
+}
+
+ADD_TEST(ManageBenchmark) {
+	// 50k idle sessions managed every 2s (congestion and timeout checks like Session::manage), media events every 1ms wait main loop:
+	// one timer which scans all sessions (previous Sessions::manage) against one timer by session spread on the interval
+	struct Session : virtual Object {
+		Congestion	congestion;
+		Time		recvTime;
+		Time		sendTime;
+	};
+	const UInt32 count(50000), interval(2000);
+	vector<Session> sessions(count);
+	UInt32 managed(0);
+	auto manage = [&managed](Session& session) {
+		session.congestion = 0;
+		if (!session.congestion(Net::RTO_MAX + Net::RTO_INIT) && !session.recvTime.isElapsed(60000) && !session.sendTime.isElapsed(60000))
+			++managed;
+	};
+	auto run = [](Timer& timer) {
+		// stall = raise duration, and latency of media events (one every ms), in us
+		vector<Int64> stalls, latencies;
+		auto now(chrono::steady_clock::now()), next(now), end(now + chrono::milliseconds(2 * interval));
+		while ((now = chrono::steady_clock::now()) < end) {
+			for (; next <= now; next += chrono::milliseconds(1))
+				latencies.emplace_back(chrono::duration_cast<chrono::microseconds>(now - next).count());
+			timer.raise();
+			stalls.emplace_back(chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - now).count());
+			this_thread::sleep_until(next);
+		}
+		sort(stalls.begin(), stalls.end());
+		sort(latencies.begin(), latencies.end());
+		return String("stall p50 ", stalls[stalls.size() / 2], "us p99 ", stalls[stalls.size() * 99 / 100], "us max ", stalls.back(), "us, media latency p99 ", latencies[latencies.size() * 99 / 100], "us max ", latencies.back(), "us");
+	};
+	{
+		Timer timer;
+		Timer::OnTimer onManage([&](UInt32 delay) {
+			for (Session& session : sessions)
+				manage(session);
+			return interval;
+		});
+		timer.set(onManage, interval / 2);
+		NOTE(count, " sessions managed by scan: ", run(timer));
+		timer.set(onManage, 0);
+	}
+	CHECK(managed == 2 * count);
+	{
+		Timer timer;
+		vector<Timer::OnTimer> timers(count);
+		for (UInt32 i = 0; i < count; ++i) {
+			Session& session(sessions[i]);
+			timers[i] = [&manage, &session](UInt32 delay) { manage(session); return interval; };
+			timer.set(timers[i], 1 + Util::Random<UInt32>() % interval);
+		}
+		NOTE(count, " sessions managed by spread timers: ", run(timer));
+		for (Timer::OnTimer& onTimer : timers)
+			timer.set(onTimer, 0);
+	}
+	CHECK(managed >= 3 * count);
+}
+
 }